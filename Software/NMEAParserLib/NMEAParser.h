@@ -30,47 +30,21 @@
 
 #include "NMEAParserData.h"
 #include "NMEAParserPacket.h"
-#include "NMEASentenceGGA.h"
-#include "NMEASentenceGSV.h"
-#include "NMEASentenceGSA.h"
-#include "NMEASentenceRMC.h"
+#include "NMEAParserDispatcher.h"
 
 ///
 /// \class CNMEAParser
 /// \brief This class will parse NMEA data, store its data and report that it has received data
 ///
-class CNMEAParser : public CNMEAParserPacket {
-
-private:
-
-	// GPS
-	CNMEASentenceGGA	m_GPGGA;												///< GPGGA Specific sentence data
-	CNMEASentenceGSV	m_GPGSV;												///< GPGSV Satellite message (GPS)
-	CNMEASentenceGSA	m_GPGSA;												///< GPGSA GNSS DOP and active satellites
-	CNMEASentenceRMC	m_GPRMC;												///< GPRMC Recommended minimum data for GPS
-
-	// Galileo
-	CNMEASentenceGGA	m_GAGGA;												///< GAGGA Specific sentence data
-	CNMEASentenceGSV	m_GAGSV;												///< GAGSV Satellite message (GPS)
-	CNMEASentenceGSA	m_GAGSA;												///< GAGSA GNSS DOP and active satellites
-	CNMEASentenceRMC	m_GARMC;												///< GARMC Recommended minimum data for GPS
-
-	// GNSS
-	CNMEASentenceGGA	m_GNGGA;												///< GAGGA Specific sentence data
-	CNMEASentenceGSA	m_GNGSA;												///< GNGSA GNSS DOP and active satellites (usually GPS and GLONASS but can be GLONASS only)
-	CNMEASentenceRMC	m_GNRMC;												///< GNRMC Recommended minimum data for GPS
-
-	// GLONASS
-	CNMEASentenceGSV	m_GLGSV;												///< GLGSV Satellite message (GLONASS)
-    CNMEASentenceGSA	m_GLGSA;												///< GLGSA GNSS DOP and active satellites
-
-	// GeiDou
-	CNMEASentenceGSV	m_QZGSV;												///< QZGSV Satellite message (BeiDou)
-	CNMEASentenceGSA	m_QZGSA;												///< QZGSA GNSS DOP and active satellites
+/// The GetXXX() methods may be called from any thread while another thread calls ProcessNMEABuffer().
+/// They return the data of the last complete sentence and never block the parsing thread.
+///
+/// Every hook of this class is virtual. CNMEAParserStatic provides the same parser with the hooks
+/// resolved at compile time.
+///
+class CNMEAParser : public CNMEAParserPacket, public CNMEAParserDispatcher {
 
-	// QZSS
-	CNMEASentenceGSV	m_BDGSV;												///< BDGSV Satellite message (QZSS)
-	CNMEASentenceGSA	m_BDGSA;												///< BDGSA GNSS DOP and active satellites
+	friend class CNMEAParserDispatcher;
 
 public:
 	CNMEAParser();
@@ -81,147 +55,58 @@ public:
 	///
 	void ResetData(void);
 
+protected:
 	///
-	/// \brief Places a copy of the GPGGA data into sentenseData
-	/// \param sentenseData reference to a CNMEASentenceGGA object to place the data into.
-	/// \return Returns ERROR_OK if successful.
-	///
-	CNMEAParserData::ERROR_E GetGPGGA(CNMEAParserData::GGA_DATA_T & sentenseData);
-
-	///
-	/// \brief Places a copy of the GNGGA data into sentenseData
-	/// \param sentenseData reference to a CNMEASentenceGGA object to place the data into.
-	/// \return Returns ERROR_OK if successful.
-	///
-	CNMEAParserData::ERROR_E GetGNGGA(CNMEAParserData::GGA_DATA_T & sentenseData);
-
-	///
-	/// \brief Places a copy of the GPGSV data into sentenseData
-	/// \param sentenseData reference to a CNMEASentenceGSV object to place the data into.
-	/// \return Returns ERROR_OK if successful.
-	///
-	CNMEAParserData::ERROR_E GetGPGSV(CNMEAParserData::GSV_DATA_T & sentenseData);
-
-	///
-	/// \brief Places a copy of the GPGSA data into sentenseData
-	/// \param sentenseData reference to a CNMEASentenceGSA object to place the data into.
-	/// \return Returns ERROR_OK if successful.
-	///
-	CNMEAParserData::ERROR_E GetGPGSA(CNMEAParserData::GSA_DATA_T & sentenseData);
-
-	///
-	/// \brief Places a copy of the GPRMC data into sentenseData
-	/// \param sentenseData reference to a CNMEASentenceGSA object to place the data into.
-	/// \return Returns ERROR_OK if successful.
-	///
-	CNMEAParserData::ERROR_E GetGPRMC(CNMEAParserData::RMC_DATA_T & sentenseData);
-
-	///
-	/// \brief Places a copy of the GNRMC data into sentenseData
-	/// \param sentenseData reference to a CNMEASentenceGSA object to place the data into.
-	/// \return Returns ERROR_OK if successful.
-	///
-	CNMEAParserData::ERROR_E GetGNRMC(CNMEAParserData::RMC_DATA_T & sentenseData);
-
-	///
-    /// \brief Places a copy of the GNGSA data into sentenseData
-    /// \param sentenseData reference to a CNMEASentenceGSA object to place the data into.
-    /// \return Returns ERROR_OK if successful.
-    ///
-    CNMEAParserData::ERROR_E GetGNGSA(CNMEAParserData::GSA_DATA_T & sentenseData);
-
-    ///
-	/// \brief Places a copy of the GLGSV data into sentenseData
-	/// \param sentenseData reference to a CNMEASentenceGSV object to place the data into.
-	/// \return Returns ERROR_OK if successful.
-	///
-	CNMEAParserData::ERROR_E GetGLGSV(CNMEAParserData::GSV_DATA_T & sentenseData);
-
-	///
-	/// \brief Places a copy of the GLGSA data into sentenseData
-	/// \param sentenseData reference to a CNMEASentenceGSA object to place the data into.
-	/// \return Returns ERROR_OK if successful.
-	///
-	CNMEAParserData::ERROR_E GetGLGSA(CNMEAParserData::GSA_DATA_T & sentenseData);
-
+	/// \brief This method is redefined from CNMEAParserPacket::ProcessRxCommand(char *pCmd, char *pData)
 	///
-	/// \brief Places a copy of the QZGSV data into sentenseData
-	/// \param sentenseData reference to a CNMEASentenceGSV object to place the data into.
-	/// \return Returns ERROR_OK if successful.
+	/// \param pCmd Pointer to the NMEA command string
+	/// \param pData Comma separated data that belongs to the command
+	/// \return Returns CNMEAParserData::ERROR_OK If successful
 	///
-	CNMEAParserData::ERROR_E GetQZGSV(CNMEAParserData::GSV_DATA_T & sentenseData);
+	virtual CNMEAParserData::ERROR_E ProcessRxCommand(char *pCmd, char *pData);
 
 	///
-	/// \brief Places a copy of the QZGSA data into sentenseData
-	/// \param sentenseData reference to a CNMEASentenceGSA object to place the data into.
-	/// \return Returns ERROR_OK if successful.
+	/// \brief This method is redefined from CNMEAParserPacket::ProcessRxSentence() and is called in zero-copy mode.
 	///
-	CNMEAParserData::ERROR_E GetQZGSA(CNMEAParserData::GSA_DATA_T & sentenseData);
-
+	/// The sentence is decoded in place. ProcessRxCommand() is not called for it.
 	///
-	/// \brief Places a copy of the BDGSV data into sentenseData
-	/// \param sentenseData reference to a CNMEASentenceGSV object to place the data into.
-	/// \return Returns ERROR_OK if successful.
+	/// \param Sentence View of the NMEA command and its comma separated data
+	/// \return Returns CNMEAParserData::ERROR_OK If successful
 	///
-	CNMEAParserData::ERROR_E GetBDGSV(CNMEAParserData::GSV_DATA_T & sentenseData);
+	virtual CNMEAParserData::ERROR_E ProcessRxSentence(const CNMEAParserData::SENTENCE_VIEW_T &Sentence);
 
 	///
-	/// \brief Places a copy of the QZGSA data into sentenseData
-	/// \param sentenseData reference to a CNMEASentenceGSA object to place the data into.
-	/// \return Returns ERROR_OK if successful.
-	///
-	CNMEAParserData::ERROR_E GetBDGSA(CNMEAParserData::GSA_DATA_T & sentenseData);
-
+	/// \brief This method will invoke a semaphore lock (mutex) for data updates.
 	///
-	/// \brief Places a copy of the GAGGA data into sentenseData
-	/// \param sentenseData reference to a CNMEASentenceGGA object to place the data into.
-	/// \return Returns ERROR_OK if successful.
+	/// Reading data with the GetXXX() methods no longer needs a lock. Each sentence object publishes
+	/// a lock-free snapshot (see CNMEAParserSnapshot) that can be read from any thread while another
+	/// thread parses. This lock is only taken around updates, that is sentence processing and
+	/// ResetData(). Redefine it only if ResetData() is called from a thread other than the parsing thread.
 	///
-	CNMEAParserData::ERROR_E GetGAGGA(CNMEAParserData::GGA_DATA_T & sentenseData);
+	virtual void DataAccessSemaphoreLock(void) {}
 
 	///
-	/// \brief Places a copy of the GAGSV data into sentenseData
-	/// \param sentenseData reference to a CNMEASentenceGSV object to place the data into.
-	/// \return Returns ERROR_OK if successful.
-	///
-	CNMEAParserData::ERROR_E GetGAGSV(CNMEAParserData::GSV_DATA_T & sentenseData);
-
+	/// \brief This method will invoke a semaphore unlock (mutex) for data updates.
 	///
-	/// \brief Places a copy of the GAGSA data into sentenseData
-	/// \param sentenseData reference to a CNMEASentenceGSA object to place the data into.
-	/// \return Returns ERROR_OK if successful.
+	/// See DataAccessSemaphoreLock()
 	///
-	CNMEAParserData::ERROR_E GetGAGSA(CNMEAParserData::GSA_DATA_T & sentenseData);
+	virtual void DataAccessSemaphoreUnlock(void) {}
 
 	///
-	/// \brief Places a copy of the GARMC data into sentenseData
-	/// \param sentenseData reference to a CNMEASentenceGSA object to place the data into.
-	/// \return Returns ERROR_OK if successful.
-	///
-	CNMEAParserData::ERROR_E GetGARMC(CNMEAParserData::RMC_DATA_T & sentenseData);
-
-protected:
+	/// \brief This method is called once for every epoch that closes, see SetEpochAssembly().
 	///
-	/// \brief This method is redefined from CNMEAParserPacket::ProcessRxCommand(char *pCmd, char *pData)
+	/// It is called from the parsing thread, after the sentence that closed the epoch is decoded.
 	///
-	/// \param pCmd Pointer to the NMEA command string
-	/// \param pData Comma separated data that belongs to the command
-	/// \return Returns CNMEAParserData::ERROR_OK If successful
+	/// \param Epoch The data of the epoch. Only valid during the call, use GetEpoch() to keep it.
 	///
-	virtual CNMEAParserData::ERROR_E ProcessRxCommand(char *pCmd, char *pData);
+	virtual void OnEpoch(const CNMEAParserData::EPOCH_DATA_T &Epoch) { UNUSED_PARAM(Epoch); }
 
 	///
-	/// \brief This method will invoke a semaphore lock (mutex) for data access.
-	///
-	///	Redefine this method if you will be access this class from different threads.
+	/// \brief This method is called once for every complete AIS message, see SetAIS().
 	///
-	virtual void DataAccessSemaphoreLock(void) {}
-
+	/// It is called from the parsing thread, after the sentence that completed the message.
 	///
-	/// \brief This method will invoke a semaphore unlock (mutex) for data access.
+	/// \param Message The message. Only valid during the call.
 	///
-	///	Redefine this method if you will be access this class from different threads.
-	///
-	virtual void DataAccessSemaphoreUnlock(void) {}
-
+	virtual void OnAISMessage(const CNMEAParserData::AIS_MESSAGE_T &Message) { UNUSED_PARAM(Message); }
 };
@@ -0,0 +1,316 @@
+/*
+* MIT License
+*
+*  Copyright (c) 2018 VisualGPS, LLC
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this software and associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright notice and this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*
+*/
+#include <string.h>
+#include "NMEAParserAIS.h"
+
+///
+/// 6-bit value of each armor character, 0xFF for characters that are not armor. '0' to 'W' are
+/// 0 to 39, '`' to 'w' are 40 to 63.
+///
+static const uint8_t s_pArmor[128] = {
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F,
+	0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1A, 0x1B, 0x1C, 0x1D, 0x1E, 0x1F,
+	0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0x28, 0x29, 0x2A, 0x2B, 0x2C, 0x2D, 0x2E, 0x2F, 0x30, 0x31, 0x32, 0x33, 0x34, 0x35, 0x36, 0x37,
+	0x38, 0x39, 0x3A, 0x3B, 0x3C, 0x3D, 0x3E, 0x3F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+};
+
+///
+/// Number of comma separated fields of an AIS sentence: fragment count, fragment number, sequential
+/// message ID, channel, payload and fill bits
+///
+static const int c_nAISFields = 6;
+
+///
+/// \brief Returns the value of a one digit field, or -1 if the field is not a single digit
+///
+static int DigitField(const CNMEAParserData::FIELD_VIEW_T &Field)
+{
+	if ((Field.nLen != 1) || (Field.pField[0] < '0') || (Field.pField[0] > '9')) {
+		return -1;
+	}
+	return Field.pField[0] - '0';
+}
+
+CNMEAParserAIS::CNMEAParserAIS() :
+	m_uClock(0),
+	m_uMessages(0),
+	m_uDropped(0)
+{
+	memset(m_pBits, 0, sizeof(m_pBits));
+	memset(&m_Message, 0, sizeof(m_Message));
+	Reset();
+}
+
+void CNMEAParserAIS::Reset(void)
+{
+	for (int i = 0; i < c_nMaxPending; i++) {
+		m_pPending[i].uStarted = 0;
+		m_pPending[i].nBits = 0;
+	}
+}
+
+size_t CNMEAParserAIS::Unarmor(const char *pPayload, size_t nLen, uint8_t *pBits, size_t nBits, size_t nMaxBits)
+{
+	if (nBits + nLen * 6 > nMaxBits) {
+		return 0;
+	}
+
+	//
+	// Pick up the bits of a partly filled last byte, then shift in six bits per character and
+	// store every full byte
+	//
+	size_t nByte = nBits >> 3;
+	int nAccBits = (int)(nBits & 7);
+	uint32_t uAcc = (nAccBits != 0) ? (uint32_t)(pBits[nByte] >> (8 - nAccBits)) : 0;
+
+	for (size_t i = 0; i < nLen; i++) {
+		uint8_t u8Char = (uint8_t)pPayload[i];
+		uint8_t u8Value = (u8Char < 128) ? s_pArmor[u8Char] : 0xFF;
+		if (u8Value == 0xFF) {
+			return 0;
+		}
+		uAcc = (uAcc << 6) | u8Value;
+		nAccBits += 6;
+		if (nAccBits >= 8) {
+			nAccBits -= 8;
+			pBits[nByte++] = (uint8_t)(uAcc >> nAccBits);
+			uAcc &= (1U << nAccBits) - 1;
+		}
+	}
+	if (nAccBits != 0) {
+		pBits[nByte] = (uint8_t)(uAcc << (8 - nAccBits));
+	}
+	return nBits + nLen * 6;
+}
+
+CNMEAParserData::ERROR_E CNMEAParserAIS::Decode(const uint8_t *pBits, size_t nBits, CNMEAParserData::AIS_MESSAGE_T &Message)
+{
+	if (nBits < 38) {
+		return CNMEAParserData::ERROR_AIS;
+	}
+
+	Message.u8Type = (uint8_t)GetBits(pBits, 0, 6);
+	Message.u8Repeat = (uint8_t)GetBits(pBits, 6, 2);
+	Message.uMMSI = GetBits(pBits, 8, 30);
+	Message.bPosition = false;
+	Message.pBits = pBits;
+	Message.nBits = (uint16_t)nBits;
+
+	CNMEAParserData::AIS_POSITION_T &Position = Message.Position;
+	switch (Message.u8Type) {
+	case 1:
+	case 2:
+	case 3:
+		//
+		// Class A position report
+		//
+		if (nBits >= 168) {
+			Position.u8NavStatus = (uint8_t)GetBits(pBits, 38, 4);
+			Position.n8ROT = (int8_t)GetSignedBits(pBits, 42, 8);
+			Position.u16SOG = (uint16_t)GetBits(pBits, 50, 10);
+			Position.bAccuracy = GetBits(pBits, 60, 1) != 0;
+			Position.n64Longitude = (int64_t)GetSignedBits(pBits, 61, 28) * 1000;
+			Position.n64Latitude = (int64_t)GetSignedBits(pBits, 89, 27) * 1000;
+			Position.u16COG = (uint16_t)GetBits(pBits, 116, 12);
+			Position.u16Heading = (uint16_t)GetBits(pBits, 128, 9);
+			Position.u8Second = (uint8_t)GetBits(pBits, 137, 6);
+			Position.bRAIM = GetBits(pBits, 148, 1) != 0;
+			Message.bPosition = true;
+		}
+		break;
+
+	case 18:
+	case 19:
+		//
+		// Class B position report, standard and extended. The extended report adds the ship's
+		// static data between the position and the RAIM flag.
+		//
+		if (nBits >= ((Message.u8Type == 18) ? 168U : 312U)) {
+			Position.u8NavStatus = 15;
+			Position.n8ROT = -128;
+			Position.u16SOG = (uint16_t)GetBits(pBits, 46, 10);
+			Position.bAccuracy = GetBits(pBits, 56, 1) != 0;
+			Position.n64Longitude = (int64_t)GetSignedBits(pBits, 57, 28) * 1000;
+			Position.n64Latitude = (int64_t)GetSignedBits(pBits, 85, 27) * 1000;
+			Position.u16COG = (uint16_t)GetBits(pBits, 112, 12);
+			Position.u16Heading = (uint16_t)GetBits(pBits, 124, 9);
+			Position.u8Second = (uint8_t)GetBits(pBits, 133, 6);
+			Position.bRAIM = GetBits(pBits, (Message.u8Type == 18) ? 147 : 305, 1) != 0;
+			Message.bPosition = true;
+		}
+		break;
+
+	case 27:
+		//
+		// Long range position report, in 1/10 minute, knots and degrees
+		//
+		if (nBits >= 96) {
+			uint16_t u16SOG = (uint16_t)GetBits(pBits, 79, 6);
+			uint16_t u16COG = (uint16_t)GetBits(pBits, 85, 9);
+			Position.bAccuracy = GetBits(pBits, 38, 1) != 0;
+			Position.bRAIM = GetBits(pBits, 39, 1) != 0;
+			Position.u8NavStatus = (uint8_t)GetBits(pBits, 40, 4);
+			Position.n64Longitude = (int64_t)GetSignedBits(pBits, 44, 18) * 1000000;
+			Position.n64Latitude = (int64_t)GetSignedBits(pBits, 62, 17) * 1000000;
+			Position.u16SOG = (u16SOG == 63) ? 1023 : u16SOG * 10;
+			Position.u16COG = (u16COG == 511) ? 3600 : u16COG * 10;
+			Position.u16Heading = 511;
+			Position.n8ROT = -128;
+			Position.u8Second = 60;
+			Message.bPosition = true;
+		}
+		break;
+
+	default:
+		break;
+	}
+	return CNMEAParserData::ERROR_OK;
+}
+
+CNMEAParserData::ERROR_E CNMEAParserAIS::ProcessSentence(const CNMEAParserData::SENTENCE_VIEW_T &Sentence, bool &bComplete)
+{
+	bComplete = false;
+
+	//
+	// Split the fields: count, number, sequential message ID, channel, payload and fill bits
+	//
+	CNMEAParserData::FIELD_VIEW_T pFields[c_nAISFields];
+	size_t nStart = 0;
+	for (int i = 0; i < c_nAISFields; i++) {
+		if (nStart > Sentence.nDataLen) {
+			return CNMEAParserData::ERROR_AIS;
+		}
+		const char *pField = &Sentence.pData[nStart];
+		const char *pComma = (const char *)memchr(pField, ',', Sentence.nDataLen - nStart);
+		pFields[i].pField = pField;
+		pFields[i].nLen = (pComma != NULL) ? (size_t)(pComma - pField) : Sentence.nDataLen - nStart;
+		nStart += pFields[i].nLen + 1;
+	}
+
+	int nCount = DigitField(pFields[0]);
+	int nNumber = DigitField(pFields[1]);
+	int nFill = (pFields[5].nLen == 0) ? 0 : DigitField(pFields[5]);
+	if ((nCount < 1) || (nNumber < 1) || (nNumber > nCount) || (nFill < 0) || (nFill > 5) ||
+		(pFields[2].nLen > 1) || (pFields[3].nLen > 1) || (pFields[4].nLen == 0)) {
+		return CNMEAParserData::ERROR_AIS;
+	}
+	char cSequence = (pFields[2].nLen != 0) ? pFields[2].pField[0] : '\0';
+	char cChannel = (pFields[3].nLen != 0) ? pFields[3].pField[0] : '\0';
+	bool bOwnShip = (Sentence.pCmd[4] == 'O');
+
+	const uint8_t *pBits = m_pBits;
+	size_t nBits = 0;
+
+	if (nCount == 1) {
+		//
+		// Single-sentence message, most position reports
+		//
+		nBits = Unarmor(pFields[4].pField, pFields[4].nLen, m_pBits, 0, CNMEAParserData::c_uMaxAISBits);
+	}
+	else {
+		int nSlot = -1;
+		for (int i = 0; i < c_nMaxPending; i++) {
+			const PENDING_T &Pending = m_pPending[i];
+			if ((Pending.uStarted != 0) && (Pending.cSequence == cSequence) && (Pending.cChannel == cChannel) &&
+				(Pending.bOwnShip == bOwnShip) && (Pending.u8Count == nCount)) {
+				nSlot = i;
+				break;
+			}
+		}
+
+		if (nNumber == 1) {
+			//
+			// A first fragment starts over, in a free slot or in the one of the oldest message
+			//
+			if (nSlot < 0) {
+				nSlot = 0;
+				for (int i = 0; i < c_nMaxPending; i++) {
+					if (m_pPending[i].uStarted < m_pPending[nSlot].uStarted) {
+						nSlot = i;
+					}
+				}
+			}
+			if (m_pPending[nSlot].uStarted != 0) {
+				m_uDropped++;
+			}
+			if (++m_uClock == 0) {
+				m_uClock = 1;
+			}
+
+			PENDING_T &Pending = m_pPending[nSlot];
+			Pending.uStarted = m_uClock;
+			Pending.cSequence = cSequence;
+			Pending.cChannel = cChannel;
+			Pending.bOwnShip = bOwnShip;
+			Pending.u8Count = (uint8_t)nCount;
+			Pending.u8Next = 1;
+			Pending.nBits = 0;
+		}
+		else if ((nSlot < 0) || (m_pPending[nSlot].u8Next != nNumber)) {
+			if (nSlot >= 0) {
+				m_pPending[nSlot].uStarted = 0;
+				m_uDropped++;
+			}
+			return CNMEAParserData::ERROR_AIS;
+		}
+
+		PENDING_T &Pending = m_pPending[nSlot];
+		nBits = Unarmor(pFields[4].pField, pFields[4].nLen, Pending.pBits, Pending.nBits, CNMEAParserData::c_uMaxAISBits);
+		if (nBits == 0) {
+			Pending.uStarted = 0;
+			m_uDropped++;
+			return CNMEAParserData::ERROR_AIS;
+		}
+		Pending.nBits = (uint16_t)nBits;
+		Pending.u8Next++;
+
+		if (nNumber < nCount) {
+			return CNMEAParserData::ERROR_OK;
+		}
+
+		//
+		// The slot is free again, its bits stay valid until the next sentence
+		//
+		Pending.uStarted = 0;
+		pBits = Pending.pBits;
+	}
+
+	//
+	// The fill bits pad the last sentence to a whole number of characters
+	//
+	if ((nBits == 0) || ((size_t)nFill > nBits) ||
+		(Decode(pBits, nBits - nFill, m_Message) != CNMEAParserData::ERROR_OK)) {
+		return CNMEAParserData::ERROR_AIS;
+	}
+	m_Message.cChannel = cChannel;
+	m_Message.bOwnShip = bOwnShip;
+	m_uMessages++;
+	bComplete = true;
+	return CNMEAParserData::ERROR_OK;
+}
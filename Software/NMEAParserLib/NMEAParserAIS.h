@@ -0,0 +1,153 @@
+/*
+* MIT License
+*
+*  Copyright (c) 2018 VisualGPS, LLC
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this software and associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright notice and this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*
+*/
+#pragma once
+#include <cstddef>
+#include <stdint.h>
+#include "NMEAParserData.h"
+
+///
+/// \class CNMEAParserAIS
+/// \brief Reassembles and decodes AIS messages from !AIVDM and !AIVDO sentences.
+///
+/// A message longer than one sentence is sent in fragments that share a sequential message ID and
+/// channel. The fragments are collected in a fixed number of slots (c_nMaxPending), so memory stays
+/// bounded whatever the feed sends: a message that does not complete is dropped when its slot is
+/// needed for a newer one, and a fragment that arrives out of order drops its message.
+///
+/// The payload is unpacked from its 6-bit ASCII armor with a lookup table into a bit buffer, and the
+/// position reports (types 1, 2, 3, 18, 19 and 27) are decoded into CNMEAParserData::AIS_POSITION_T.
+/// Nothing is allocated while parsing.
+///
+/// CNMEAParserDispatcher passes AIS sentences here once SetAIS() turns it on, and calls the
+/// OnAISMessage() hook of the parser for every complete message.
+///
+class CNMEAParserAIS
+{
+public:
+	static const int				c_nMaxPending = 8;							///< Number of multi-sentence messages that are assembled at the same time
+	static const size_t				c_nBufferSize = CNMEAParserData::c_uMaxAISBits / 8 + 8;	///< Size of a bit buffer, with room for GetBits() to read past the end
+
+private:
+	///
+	/// \brief A multi-sentence message being assembled
+	///
+	typedef struct _PENDING_T {
+		uint32_t					uStarted;									///< Value of m_uClock when the first fragment arrived, 0 if the slot is free
+		char						cSequence;									///< Sequential message ID
+		char						cChannel;									///< Radio channel
+		bool						bOwnShip;									///< !AIVDO
+		uint8_t						u8Count;									///< Number of fragments
+		uint8_t						u8Next;										///< Number of the next fragment
+		uint16_t					nBits;										///< Bits collected in pBits
+		uint8_t						pBits[c_nBufferSize];						///< Payload collected so far
+	} PENDING_T;
+
+	PENDING_T						m_pPending[c_nMaxPending];					///< Messages being assembled
+	uint8_t							m_pBits[c_nBufferSize];						///< Payload of single-sentence messages
+	uint32_t						m_uClock;									///< Counts the first fragments, orders the slots by age
+	uint32_t						m_uMessages;								///< Complete messages
+	uint32_t						m_uDropped;									///< Incomplete messages dropped
+	CNMEAParserData::AIS_MESSAGE_T	m_Message;									///< Last complete message
+
+public:
+	CNMEAParserAIS();
+
+	///
+	/// \brief Returns true if the sentence is an AIS sentence, ie: AIVDM or AIVDO of any talker
+	///
+	static bool IsAIS(const CNMEAParserData::SENTENCE_VIEW_T &Sentence) {
+		return (Sentence.nCmdLen == 5) && (Sentence.pCmd[2] == 'V') && (Sentence.pCmd[3] == 'D') &&
+			((Sentence.pCmd[4] == 'M') || (Sentence.pCmd[4] == 'O'));
+	}
+
+	///
+	/// \brief Adds an AIS sentence to its message.
+	///
+	/// \param Sentence An AIS sentence, see IsAIS()
+	/// \param bComplete Set to true if the sentence completes a message, see GetMessage()
+	/// \return CNMEAParserData::ERROR_OK if successful, ERROR_AIS if the sentence is malformed or out of order
+	///
+	CNMEAParserData::ERROR_E ProcessSentence(const CNMEAParserData::SENTENCE_VIEW_T &Sentence, bool &bComplete);
+
+	///
+	/// \brief Returns the last complete message. Its payload is only valid until the next ProcessSentence().
+	///
+	const CNMEAParserData::AIS_MESSAGE_T &GetMessage(void) const { return m_Message; }
+
+	///
+	/// \brief Drops the messages being assembled
+	///
+	void Reset(void);
+
+	///
+	/// \brief Returns the number of complete messages
+	///
+	uint32_t GetMessageCount(void) const { return m_uMessages; }
+
+	///
+	/// \brief Returns the number of messages dropped before they were complete
+	///
+	uint32_t GetDroppedCount(void) const { return m_uDropped; }
+
+	///
+	/// \brief Unpacks 6-bit armored payload characters into a bit buffer.
+	///
+	/// \param pPayload Armored payload characters
+	/// \param nLen Number of characters in pPayload
+	/// \param pBits Bit buffer, the first bit is the MSB of pBits[0]
+	/// \param nBits Number of bits already in pBits, the payload is appended after them
+	/// \param nMaxBits Capacity of pBits in bits
+	/// \return Number of bits in pBits afterwards, or 0 if a character is not valid armor or the payload does not fit
+	///
+	static size_t Unarmor(const char *pPayload, size_t nLen, uint8_t *pBits, size_t nBits, size_t nMaxBits);
+
+	///
+	/// \brief Reads an unsigned field of up to 32 bits. pBits must be readable for 5 bytes from bit nStart.
+	///
+	static uint32_t GetBits(const uint8_t *pBits, size_t nStart, size_t nLen) {
+		const uint8_t *p = &pBits[nStart >> 3];
+		uint64_t u64 = ((uint64_t)p[0] << 32) | ((uint64_t)p[1] << 24) | ((uint64_t)p[2] << 16) | ((uint64_t)p[3] << 8) | (uint64_t)p[4];
+		return (uint32_t)((u64 >> (40 - (nStart & 7) - nLen)) & ((1ULL << nLen) - 1));
+	}
+
+	///
+	/// \brief Reads a two's complement field of up to 32 bits. See GetBits().
+	///
+	static int32_t GetSignedBits(const uint8_t *pBits, size_t nStart, size_t nLen) {
+		uint32_t u = GetBits(pBits, nStart, nLen);
+		uint32_t uSign = 1U << (nLen - 1);
+		return (int32_t)((u ^ uSign) - uSign);
+	}
+
+	///
+	/// \brief Decodes the header of a message and its position report, if it has one.
+	///
+	/// \param pBits Payload, with at least c_nBufferSize bytes readable
+	/// \param nBits Number of bits in pBits
+	/// \param Message Receives the decoded message. Its pBits and nBits are set to the payload.
+	/// \return CNMEAParserData::ERROR_OK if successful, ERROR_AIS if the payload is too short
+	///
+	static CNMEAParserData::ERROR_E Decode(const uint8_t *pBits, size_t nBits, CNMEAParserData::AIS_MESSAGE_T &Message);
+};
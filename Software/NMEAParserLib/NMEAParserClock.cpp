@@ -0,0 +1,140 @@
+/*
+* MIT License
+*
+*  Copyright (c) 2018 VisualGPS, LLC
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this software and associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright notice and this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*
+*/
+#include "NMEAParserClock.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+#if NMEAPARSER_TSC_CLOCK && defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define NMEAPARSER_HAVE_TSC 1
+#include <cpuid.h>
+#include <x86intrin.h>
+#else
+#define NMEAPARSER_HAVE_TSC 0
+#endif
+
+///
+/// \brief Reads the system monotonic clock
+///
+static uint64_t SystemNow(void)
+{
+#if defined(_WIN32)
+	static LARGE_INTEGER Frequency = { 0 };
+	if (Frequency.QuadPart == 0) {
+		QueryPerformanceFrequency(&Frequency);
+	}
+	LARGE_INTEGER Counter;
+	QueryPerformanceCounter(&Counter);
+	uint64_t u64Seconds = (uint64_t)Counter.QuadPart / (uint64_t)Frequency.QuadPart;
+	uint64_t u64Rest = (uint64_t)Counter.QuadPart % (uint64_t)Frequency.QuadPart;
+	return u64Seconds * 1000000000ULL + u64Rest * 1000000000ULL / (uint64_t)Frequency.QuadPart;
+#else
+	struct timespec Time;
+	clock_gettime(CLOCK_MONOTONIC, &Time);
+	return (uint64_t)Time.tv_sec * 1000000000ULL + (uint64_t)Time.tv_nsec;
+#endif
+}
+
+#if NMEAPARSER_HAVE_TSC
+///
+/// \brief Rate of the time stamp counter, measured once
+///
+typedef struct _TSC_T {
+	bool		bValid;															///< The counter is invariant and was measured
+	uint64_t	u64Ticks;														///< Counter value at u64Nanoseconds
+	uint64_t	u64Nanoseconds;													///< System clock when the counter was u64Ticks
+	uint64_t	u64Scale;														///< Nanoseconds per tick in 32.32 fixed point
+} TSC_T;
+
+///
+/// \brief Measures the time stamp counter against the system clock for 10 ms
+///
+static TSC_T MeasureTSC(void)
+{
+	TSC_T Tsc = { false, 0, 0, 0 };
+
+	//
+	// CPUID 0x80000007 EDX bit 8: the counter runs at a constant rate in every power state
+	//
+	unsigned int uEax, uEbx, uEcx, uEdx;
+	if ((__get_cpuid(0x80000007, &uEax, &uEbx, &uEcx, &uEdx) == 0) || ((uEdx & (1u << 8)) == 0)) {
+		return Tsc;
+	}
+
+	uint64_t u64Start = SystemNow();
+	uint64_t u64StartTicks = __rdtsc();
+	uint64_t u64End;
+	do {
+		u64End = SystemNow();
+	} while (u64End - u64Start < 10000000ULL);
+	uint64_t u64EndTicks = __rdtsc();
+
+	if (u64EndTicks <= u64StartTicks) {
+		return Tsc;
+	}
+
+	Tsc.u64Ticks = u64EndTicks;
+	Tsc.u64Nanoseconds = u64End;
+	Tsc.u64Scale = (uint64_t)(((unsigned __int128)(u64End - u64Start) << 32) / (u64EndTicks - u64StartTicks));
+	Tsc.bValid = true;
+	return Tsc;
+}
+
+///
+/// \brief Returns the measured rate, measuring it on the first call
+///
+static const TSC_T &GetTSC(void)
+{
+	static const TSC_T Tsc = MeasureTSC();
+	return Tsc;
+}
+#endif
+
+uint64_t CNMEAParserClock::Now(void)
+{
+#if NMEAPARSER_HAVE_TSC
+	const TSC_T &Tsc = GetTSC();
+	if (Tsc.bValid) {
+		//
+		// Signed, another core may read a counter value that is slightly older than u64Ticks
+		//
+		int64_t n64Ticks = (int64_t)(__rdtsc() - Tsc.u64Ticks);
+		return Tsc.u64Nanoseconds + (uint64_t)(int64_t)(((__int128)n64Ticks * (__int128)Tsc.u64Scale) >> 32);
+	}
+#endif
+	return SystemNow();
+}
+
+bool CNMEAParserClock::IsTSC(void)
+{
+#if NMEAPARSER_HAVE_TSC
+	return GetTSC().bValid;
+#else
+	return false;
+#endif
+}
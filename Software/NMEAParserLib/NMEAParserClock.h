@@ -0,0 +1,62 @@
+/*
+* MIT License
+*
+*  Copyright (c) 2018 VisualGPS, LLC
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this software and associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright notice and this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*
+*/
+#pragma once
+#include <cstddef>
+#include <stdint.h>
+
+///
+/// The time stamp counter is used when NMEAPARSER_TSC_CLOCK is non-zero (cmake -DNMEAPARSER_ENABLE_TSC_CLOCK=ON)
+/// and the processor has an invariant one. Otherwise CNMEAParserClock reads the system monotonic clock.
+///
+#ifndef NMEAPARSER_TSC_CLOCK
+#define NMEAPARSER_TSC_CLOCK 0
+#endif
+
+///
+/// \class CNMEAParserClock
+/// \brief Monotonic clock for sentence time stamps, in nanoseconds.
+///
+/// The system clock is clock_gettime(CLOCK_MONOTONIC) on POSIX systems and QueryPerformanceCounter()
+/// on Windows. Its value is the one of the system, so time stamps can be compared with those of other
+/// code and processes on the host.
+///
+/// The time stamp counter clock reads the counter with rdtsc and scales it with a rate that is measured
+/// against the system clock during the first 10 ms after the first call. It is cheaper to read, but
+/// its value drifts away from the system clock by the error of that measurement, typically a few
+/// microseconds per second. Use it when only short intervals, like the latency of a sentence, matter.
+///
+class CNMEAParserClock
+{
+public:
+	///
+	/// \brief Returns the time in nanoseconds since an arbitrary, fixed point. Safe to call from any thread.
+	///
+	static uint64_t Now(void);
+
+	///
+	/// \brief Returns true if Now() reads the time stamp counter
+	///
+	static bool IsTSC(void);
+};
@@ -0,0 +1,160 @@
+/*
+* MIT License
+*
+*  Copyright (c) 2018 VisualGPS, LLC
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this software and associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright notice and this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*
+*/
+
+#pragma once
+
+///
+/// \file NMEAParserConfig.h
+/// \brief Compile time limits and sentence set of the parser.
+///
+/// Every value can be overridden on the compiler command line, ie: -DNMEAPARSER_MAX_SATELLITES=16.
+/// They change the size of the parser and its data structures, so the library and every file that
+/// includes its headers must be built with the same values. The CMake cache variables of the same
+/// names set them for the library and for targets that link to it.
+///
+/// The defaults keep the historical limits and decode everything.
+///
+
+///
+/// Maximum length of an NMEA command (address), ie: GPGGA, including the terminating NUL
+///
+#ifndef NMEAPARSER_MAX_CMD_LEN
+#define NMEAPARSER_MAX_CMD_LEN			32
+#endif
+
+///
+/// Maximum length of the comma separated data of a sentence, including the terminating NUL
+///
+#ifndef NMEAPARSER_MAX_DATA_LEN
+#define NMEAPARSER_MAX_DATA_LEN			256
+#endif
+
+///
+/// Maximum length of an IEC 61162-450 tag block, between its backslashes. Longer tag blocks are
+/// dropped with ERROR_TAG_BLOCK and their sentence is passed on without it.
+///
+#ifndef NMEAPARSER_MAX_TAG_LEN
+#define NMEAPARSER_MAX_TAG_LEN			96
+#endif
+
+///
+/// Number of satellites kept per GSV and GSA talker
+///
+#ifndef NMEAPARSER_MAX_SATELLITES
+#define NMEAPARSER_MAX_SATELLITES		64
+#endif
+
+///
+/// Number of used and of visible satellites kept in an epoch and of satellites kept in the sky view,
+/// all talkers together. See CNMEAParserEpoch and CNMEAParserSkyView.
+///
+#ifndef NMEAPARSER_MAX_EPOCH_SATELLITES
+#define NMEAPARSER_MAX_EPOCH_SATELLITES	128
+#endif
+
+///
+/// Maximum number of talker/sentence pairs decoded by one parser
+///
+#ifndef NMEAPARSER_MAX_SLOTS
+#define NMEAPARSER_MAX_SLOTS			48
+#endif
+
+///
+/// Number of published copies of each sentence's data, see CNMEAParserSnapshot. Readers can
+/// hold NMEAPARSER_SNAPSHOT_BUFFERS - 2 leases on a sentence without the parser skipping updates.
+///
+#ifndef NMEAPARSER_SNAPSHOT_BUFFERS
+#define NMEAPARSER_SNAPSHOT_BUFFERS		4
+#endif
+
+///
+/// Set to 0 to leave a sentence decoder out of the parser. Its sentences are then treated like
+/// unknown sentences and its GetXXX() methods return ERROR_FAIL.
+///
+#ifndef NMEAPARSER_ENABLE_GGA
+#define NMEAPARSER_ENABLE_GGA			1
+#endif
+#ifndef NMEAPARSER_ENABLE_GSA
+#define NMEAPARSER_ENABLE_GSA			1
+#endif
+#ifndef NMEAPARSER_ENABLE_GSV
+#define NMEAPARSER_ENABLE_GSV			1
+#endif
+#ifndef NMEAPARSER_ENABLE_RMC
+#define NMEAPARSER_ENABLE_RMC			1
+#endif
+
+///
+/// Set to 0 to not create the decoders of the default talker/sentence pairs (GPGGA, GLGSV, ...)
+/// when the parser is constructed. Each decoder is then created the first time its sentence is
+/// received or when it is added with AddSentence(), so a parser only holds what its receiver
+/// sends. GetXXX() returns ERROR_FAIL for a pair that does not exist yet.
+///
+#ifndef NMEAPARSER_DEFAULT_SENTENCES
+#define NMEAPARSER_DEFAULT_SENTENCES	1
+#endif
+
+///
+/// Set to 1 to have the GSV decoders store and publish GSV_COMPACT_T instead of GSV_DATA_T. This
+/// cuts the size of each GSV talker by three quarters. GetXXXGSV() still returns GSV_DATA_T, while
+/// LeaseGSV() then leases the compact data. See CNMEAParserSatellites.
+///
+#ifndef NMEAPARSER_COMPACT_SATELLITES
+#define NMEAPARSER_COMPACT_SATELLITES	0
+#endif
+
+///
+/// Set to 1 to decode GGA and RMC coordinates only into the fixed point m_n64Latitude and
+/// m_n64Longitude, without floating point. m_dLatitude and m_dLongitude are then left at 0, use
+/// CNMEAParserData::CoordinateToDegrees() to get them. By default both are decoded.
+///
+#ifndef NMEAPARSER_FIXED_POINT_COORDINATES
+#define NMEAPARSER_FIXED_POINT_COORDINATES	0
+#endif
+
+#if NMEAPARSER_MAX_CMD_LEN < 8 || NMEAPARSER_MAX_CMD_LEN > 256
+#error "NMEAPARSER_MAX_CMD_LEN must be between 8 and 256"
+#endif
+#if NMEAPARSER_MAX_DATA_LEN < 16 || NMEAPARSER_MAX_DATA_LEN > 65535
+#error "NMEAPARSER_MAX_DATA_LEN must be between 16 and 65535"
+#endif
+#if NMEAPARSER_MAX_TAG_LEN < 16 || NMEAPARSER_MAX_TAG_LEN > 1024
+#error "NMEAPARSER_MAX_TAG_LEN must be between 16 and 1024"
+#endif
+#if NMEAPARSER_MAX_SATELLITES < 4
+#error "NMEAPARSER_MAX_SATELLITES must be at least 4"
+#endif
+#if NMEAPARSER_MAX_EPOCH_SATELLITES < 4
+#error "NMEAPARSER_MAX_EPOCH_SATELLITES must be at least 4"
+#endif
+#if NMEAPARSER_MAX_SLOTS < 1 || NMEAPARSER_MAX_SLOTS > 48
+#error "NMEAPARSER_MAX_SLOTS must be between 1 and 48"
+#endif
+#if !NMEAPARSER_ENABLE_GGA && !NMEAPARSER_ENABLE_GSA && !NMEAPARSER_ENABLE_GSV && !NMEAPARSER_ENABLE_RMC
+#error "At least one sentence decoder must be enabled"
+#endif
+#if NMEAPARSER_SNAPSHOT_BUFFERS < 2
+#error "NMEAPARSER_SNAPSHOT_BUFFERS must be at least 2"
+#endif
@@ -27,6 +27,7 @@
 #include <cstddef>
 #include <stdint.h>
 #include <time.h>
+#include "NMEAParserConfig.h"
 
 ///
 /// Used to identify unused function parameters. 
@@ -49,16 +50,31 @@ namespace CNMEAParserData {
 		ERROR_CHECKSUM = 3,														///< Error, packet checksum mismatch
 		ERROR_RX_BUFFER_OVERFLOW,												///< Error, receive packet buffer overflow
 		ERROR_CMD_BUFFER_OVERFLOW,												///< Error, receive command buffer overflow
+		ERROR_TAG_BLOCK,														///< Error, tag block checksum mismatch, overflow or bad syntax
+		ERROR_AIS,																///< Error, malformed AIS sentence or payload, or AIS fragment out of order
 	};
 
 	//
 	// Constants
 	//
-	static const uint32_t		c_uMaxCmdLen = 32;								///< maximum command length (NMEA address)
-	static const uint32_t		c_uMaxDataLen = 256;							///< maximum command length (NMEA address)
-	static const int			c_nMaxConstellation = 64;						///< This is a max number if satellites for a constellation. NOTE: This does not reflect the actual constellation count for a given GPS/GNSS system
+	static const uint32_t		c_uMaxCmdLen = NMEAPARSER_MAX_CMD_LEN;			///< maximum command length (NMEA address)
+	static const uint32_t		c_uMaxDataLen = NMEAPARSER_MAX_DATA_LEN;		///< maximum data length
+	static const uint32_t		c_uMaxTagLen = NMEAPARSER_MAX_TAG_LEN;			///< maximum tag block length, between the backslashes
+	static const uint32_t		c_uMaxTagSourceLen = 16;						///< maximum length of the tag block source and destination, including the terminating NUL
+	static const uint32_t		c_uMaxAISBits = 1008;							///< maximum length of an AIS message in bits (five slots)
+	static const int			c_nMaxConstellation = NMEAPARSER_MAX_SATELLITES;	///< This is a max number if satellites for a constellation. NOTE: This does not reflect the actual constellation count for a given GPS/GNSS system
 	static const int			c_nMaxGSASats = 12;								///< Maximum number of satellites in the GSA message
 	static const int			c_nInvlidPRN = 0;								///< Invalid or non existing PRN
+	static const int			c_nMaxEpochSatellites = NMEAPARSER_MAX_EPOCH_SATELLITES;	///< Maximum number of used and of visible satellites in an epoch and of satellites in the sky view, all talkers together
+	static const int64_t		c_n64CoordinateUnitsPerMinute = 10000000;		///< Fixed point coordinate units per minute of arc (1e-7 minute), see m_n64Latitude
+	static const int64_t		c_n64CoordinateUnitsPerDegree = 600000000;		///< Fixed point coordinate units per degree
+
+	///
+	/// \brief Converts a fixed point coordinate, ie: GGA_DATA_T::m_n64Latitude, to decimal degrees.
+	///
+	inline double CoordinateToDegrees(int64_t n64Coordinate) {
+		return (double)n64Coordinate / (double)c_n64CoordinateUnitsPerDegree;
+	}
 
 	///
 	/// All known talker IDs
@@ -85,9 +101,11 @@ namespace CNMEAParserData {
 		TID_ER = (uint16_t)'E' << 8 | (uint16_t)'R',							///< ER Engine Room Monitoring Systems
 		TID_GA = (uint16_t)'G' << 8 | (uint16_t)'A',							///< GA Galileo Positioning System
 		TID_GB = (uint16_t)'G' << 8 | (uint16_t)'B',							///< GB BeiDou(China)
+		TID_GI = (uint16_t)'G' << 8 | (uint16_t)'I',							///< GI NavIC(India)
 		TID_GL = (uint16_t)'G' << 8 | (uint16_t)'L',							///< GL GLONASS, according to IEIC 61162 - 1
 		TID_GN = (uint16_t)'G' << 8 | (uint16_t)'N',							///< GN Mixed GPS and GLONASS data, according to IEIC 61162-1
 		TID_GP = (uint16_t)'G' << 8 | (uint16_t)'P',							///< GP Global Positioning System(GPS)
+		TID_GQ = (uint16_t)'G' << 8 | (uint16_t)'Q',							///< GQ QZSS(Japan), according to NMEA 4.11
 		TID_HC = (uint16_t)'H' << 8 | (uint16_t)'C',							///< HC Heading - Magnetic Compass
 		TID_HE = (uint16_t)'H' << 8 | (uint16_t)'E',							///< HE Heading - North Seeking Gyro
 		TID_HN = (uint16_t)'H' << 8 | (uint16_t)'N',							///< HN Heading - Non North Seeking Gyro
@@ -136,6 +154,118 @@ namespace CNMEAParserData {
 		TID_ZV = (uint16_t)'Z' << 8 | (uint16_t)'V',							///< ZV Timekeeper - Radio Update, WWV or WWVH
 	};
 
+	///
+	/// Fields present in a TAG_BLOCK_T, see TAG_BLOCK_T::uFields
+	///
+	enum TAG_FIELD_E {
+		TAG_SOURCE = 0x01,														///< s: Source identification
+		TAG_DESTINATION = 0x02,													///< d: Destination identification
+		TAG_TIME = 0x04,														///< c: UNIX time
+		TAG_RELATIVE_TIME = 0x08,												///< r: Relative time
+		TAG_LINE = 0x10,														///< n: Line count
+		TAG_GROUP = 0x20,														///< g: Sentence grouping
+		TAG_TEXT = 0x40,														///< t: Text string
+	};
+
+	///
+	/// \brief IEC 61162-450 tag block, ie: \\s:GP0001,c:1577836800*2B\\ in front of a sentence.
+	///
+	/// Only the fields flagged in uFields are valid. The text of t: and of parameters this structure
+	/// does not decode can be read from pBlock.
+	///
+	typedef struct _TAG_BLOCK_T {
+		uint32_t		uFields;												///< TAG_FIELD_E flags of the fields present
+		char			pszSource[c_uMaxTagSourceLen];							///< s: Source identification, NUL terminated
+		char			pszDestination[c_uMaxTagSourceLen];						///< d: Destination identification, NUL terminated
+		int64_t			n64Time;												///< c: UNIX time as sent, in seconds (some sources send milliseconds)
+		int64_t			n64RelativeTime;										///< r: Relative time as sent
+		uint32_t		uLine;													///< n: Line count
+		uint16_t		u16GroupSentence;										///< g: Number of this sentence in the group, from 1
+		uint16_t		u16GroupCount;											///< g: Number of sentences in the group
+		uint32_t		uGroupID;												///< g: Group ID
+		uint16_t		nBlockLen;												///< Number of characters in pBlock
+		char			pBlock[c_uMaxTagLen];									///< Parameters between the backslashes, without the checksum, NOT NUL terminated
+	} TAG_BLOCK_T;
+
+	///
+	/// \brief Position report of an AIS message of type 1, 2, 3 (class A), 18, 19 (class B) or 27 (long range)
+	///
+	/// The values are kept as sent, in their AIS units. Long range reports are scaled to the units of the
+	/// other types. Each field has an AIS "not available" value, which is noted below.
+	///
+	typedef struct _AIS_POSITION_T {
+		int64_t			n64Latitude;											///< Latitude in c_n64CoordinateUnitsPerDegree units (see CoordinateToDegrees()), 91 degrees if not available
+		int64_t			n64Longitude;											///< Longitude in c_n64CoordinateUnitsPerDegree units, 181 degrees if not available
+		uint16_t		u16SOG;													///< Speed over ground in 1/10 knot, 1023 if not available
+		uint16_t		u16COG;													///< Course over ground in 1/10 degree, 3600 if not available
+		uint16_t		u16Heading;												///< True heading in degrees, 511 if not available
+		int8_t			n8ROT;													///< Rate of turn as sent (class A), -128 if not available
+		uint8_t			u8NavStatus;											///< Navigational status (class A and long range), 15 if not defined
+		uint8_t			u8Second;												///< UTC second of the report, 60 if not available
+		bool			bAccuracy;												///< Position accuracy better than 10 m
+		bool			bRAIM;													///< RAIM in use
+	} AIS_POSITION_T;
+
+	///
+	/// \brief A complete AIS message, reassembled from its !AIVDM or !AIVDO fragments.
+	///
+	/// The payload is passed as decoded bits so that message types other than the position reports can
+	/// be read with CNMEAParserAIS::GetBits().
+	///
+	typedef struct _AIS_MESSAGE_T {
+		uint8_t			u8Type;													///< Message type, 1 to 27
+		uint8_t			u8Repeat;												///< Repeat indicator
+		uint32_t		uMMSI;													///< MMSI of the station
+		char			cChannel;												///< Radio channel, 'A' or 'B', '\\0' if not sent
+		bool			bOwnShip;												///< true for !AIVDO, the own vessel's report
+		bool			bPosition;												///< Position holds the report, for types 1, 2, 3, 18, 19 and 27
+		AIS_POSITION_T	Position;												///< Position report, see bPosition
+		const uint8_t *	pBits;													///< Payload, eight bits per byte with the first bit in the MSB. Only valid during the call it was passed to.
+		uint16_t		nBits;													///< Number of bits in pBits
+	} AIS_MESSAGE_T;
+
+	///
+	/// \brief A framed NMEA sentence.
+	///
+	/// The command and data point either into the buffer passed to CNMEAParserPacket::ProcessNMEABuffer()
+	/// or into the packet parser's internal buffers. They are NOT NUL terminated and are only valid for
+	/// the duration of the call they were passed to.
+	///
+	typedef struct _SENTENCE_VIEW_T {
+		const char *	pCmd;													///< NMEA command (address), ie: GPGGA
+		size_t			nCmdLen;												///< Number of characters in pCmd
+		const char *	pData;													///< Comma separated data, without the checksum
+		size_t			nDataLen;												///< Number of characters in pData
+		uint64_t		u64Timestamp;											///< CNMEAParserClock time at which the '$' was received, 0 if not time stamped (see SetTimestamps())
+		const TAG_BLOCK_T *	pTag;												///< Tag block in front of the sentence, NULL if it has none
+	} SENTENCE_VIEW_T;
+
+	///
+	/// \brief A single field of an NMEA sentence. The field is NOT NUL terminated.
+	///
+	typedef struct _FIELD_VIEW_T {
+		const char *	pField;													///< First character of the field
+		size_t			nLen;													///< Number of characters in the field
+	} FIELD_VIEW_T;
+
+	///
+	/// \brief Copy of the data of a validated sentence, kept for lazy decoding. pData is NOT NUL terminated.
+	///
+	typedef struct _RAW_SENTENCE_T {
+		char			pData[c_uMaxDataLen];									///< Comma separated data, without the checksum
+		size_t			nDataLen;												///< Number of characters in pData
+	} RAW_SENTENCE_T;
+
+	///
+	/// Sentence IDs decoded by CNMEAParser. Packed like TALKER_ID_E, ie: SID_GGA is 'G' << 16 | 'G' << 8 | 'A'
+	///
+	enum SENTENCE_ID_E {
+		SID_GGA = (uint32_t)'G' << 16 | (uint32_t)'G' << 8 | (uint32_t)'A',	///< GGA Global positioning system fix data
+		SID_GSA = (uint32_t)'G' << 16 | (uint32_t)'S' << 8 | (uint32_t)'A',	///< GSA GNSS DOP and active satellites
+		SID_GSV = (uint32_t)'G' << 16 | (uint32_t)'S' << 8 | (uint32_t)'V',	///< GSV GNSS satellites in view
+		SID_RMC = (uint32_t)'R' << 16 | (uint32_t)'M' << 8 | (uint32_t)'C',	///< RMC Recommended minimum specific GNSS data
+	};
+
 	///
 	/// GPS Quality that's used in the GGA sentence
 	///
@@ -176,8 +306,10 @@ namespace CNMEAParserData {
 		int				m_nHour;												///< hour
 		int				m_nMinute;												///< Minute
 		int				m_nSecond;												///< Second
-		double			m_dLatitude;											///< Latitude (Decimal degrees, S < 0 > N)
-		double			m_dLongitude;											///< Longitude (Decimal degrees, W < 0 > E)
+		double			m_dLatitude;											///< Latitude (Decimal degrees, S < 0 > N). Not decoded with NMEAPARSER_FIXED_POINT_COORDINATES
+		double			m_dLongitude;											///< Longitude (Decimal degrees, W < 0 > E). Not decoded with NMEAPARSER_FIXED_POINT_COORDINATES
+		int64_t			m_n64Latitude;											///< Latitude (1e-7 minutes of arc, S < 0 > N)
+		int64_t			m_n64Longitude;											///< Longitude (1e-7 minutes of arc, W < 0 > E)
 		double			m_dAltitudeMSL;											///< Altitude (Meters)
 		GPS_QUALITY_E	m_nGPSQuality;											///< GPS Quality
 		int				m_nSatsInView;											///< Number of satellites in view
@@ -198,6 +330,39 @@ namespace CNMEAParserData {
 		CNMEAParserData::SAT_INFO_T			SatInfo[c_nMaxConstellation];		///< Satellite data
 	} GSV_DATA_T;
 
+	///
+	/// Compact satellite record, 6 bytes instead of the 24 of SAT_INFO_T. NMEA reports elevation,
+	/// azimuth and SNR as whole numbers, so nothing is lost for valid data. See CNMEAParserSatellites.
+	///
+	typedef struct _SAT_INFO_COMPACT_T {
+		uint16_t	u16PRN;														///< Satellite Psudo Random Number, c_nInvlidPRN if the entry is not used
+		uint16_t	u16Azimuth;													///< Satellite Azimuth in degrees (0 - 359)
+		int8_t		s8Elevation;												///< Satellite Elevation in degrees (-90 - 90)
+		uint8_t		u8SNR;														///< Signal to Noise Ration in dB-Hz (0 - 99)
+	} SAT_INFO_COMPACT_T;
+
+	///
+	/// Compact form of GSV_DATA_T. A full constellation of 64 satellites fits in 388 bytes.
+	///
+	typedef struct _GSV_COMPACT_T {
+		uint8_t								u8TotalNumberOfSentences;			///< Total number of GSV sentences to build up satellites monitored
+		uint8_t								u8SentenceNumber;					///< Current sentence number
+		uint16_t							u16SatsInView;						///< Number of satellites in view
+		CNMEAParserData::SAT_INFO_COMPACT_T	SatInfo[c_nMaxConstellation];		///< Satellite data
+	} GSV_COMPACT_T;
+
+	///
+	/// Structure of arrays view of the satellites of a GSV talker. Only used entries are stored and
+	/// they are packed to the front, so a scan over one field reads nCount contiguous values.
+	///
+	typedef struct _SAT_VIEW_T {
+		int									nCount;								///< Number of satellites in the arrays
+		uint16_t							pu16PRN[c_nMaxConstellation];		///< Satellite Psudo Random Numbers
+		uint16_t							pu16Azimuth[c_nMaxConstellation];	///< Azimuths in degrees
+		int8_t								ps8Elevation[c_nMaxConstellation];	///< Elevations in degrees
+		uint8_t								pu8SNR[c_nMaxConstellation];		///< Signal to noise ratios in dB-Hz
+	} SAT_VIEW_T;
+
 	///
 	/// GNSS DOP and active satellites
 	///
@@ -228,8 +393,10 @@ namespace CNMEAParserData {
 		int				m_nMinute;												///< Minute
 		int				m_nSecond;												///< Second
 		double			m_dSecond;												///< Fractional second
-		double			m_dLatitude;											///< Latitude (Decimal degrees, S < 0 > N)
-		double			m_dLongitude;											///< Longitude (Decimal degrees, W < 0 > E)
+		double			m_dLatitude;											///< Latitude (Decimal degrees, S < 0 > N). Not decoded with NMEAPARSER_FIXED_POINT_COORDINATES
+		double			m_dLongitude;											///< Longitude (Decimal degrees, W < 0 > E). Not decoded with NMEAPARSER_FIXED_POINT_COORDINATES
+		int64_t			m_n64Latitude;											///< Latitude (1e-7 minutes of arc, S < 0 > N)
+		int64_t			m_n64Longitude;											///< Longitude (1e-7 minutes of arc, W < 0 > E)
 		double			m_dAltitudeMSL;											///< Altitude (Meters)
 		RMC_STATUS_E	m_nStatus;												///< Status
 		double			m_dSpeedKnots;											///< Speed over the ground in knots
@@ -240,4 +407,105 @@ namespace CNMEAParserData {
 	    double			m_dMagneticVariation;									///< Magnetic Variation
 
 	} RMC_DATA_T;
+
+	///
+	/// Sentences that contributed to an epoch, see EPOCH_DATA_T::uSources
+	///
+	enum EPOCH_SOURCE_E {
+		EPOCH_GGA = 0x01,														///< GGA position, altitude and fix quality
+		EPOCH_RMC = 0x02,														///< RMC date, speed and track
+		EPOCH_GSA = 0x04,														///< GSA fix mode, DOPs and used satellites
+		EPOCH_GSV = 0x08,														///< GSV visible satellites
+	};
+
+	///
+	/// Satellite used in the fix, from a GSA sentence
+	///
+	typedef struct _EPOCH_PRN_T {
+		uint16_t							u16Talker;							///< Talker ID of the GSA sentence (TALKER_ID_E)
+		uint16_t							u16PRN;								///< Satellite Psudo Random Number
+	} EPOCH_PRN_T;
+
+	///
+	/// Visible satellite, from a GSV sentence
+	///
+	typedef struct _EPOCH_SAT_T {
+		uint16_t							u16Talker;							///< Talker ID of the GSV sentence (TALKER_ID_E)
+		CNMEAParserData::SAT_INFO_COMPACT_T	Sat;								///< Satellite
+	} EPOCH_SAT_T;
+
+	///
+	/// All the data of one fix, fused from the GGA, RMC, GSA and GSV sentences that share a UTC time.
+	/// See CNMEAParserEpoch. Fields of sentences that are not in uSources are 0.
+	///
+	typedef struct _EPOCH_DATA_T {
+		uint32_t			uSources;											///< EPOCH_SOURCE_E flags of the sentences in the epoch
+		int					m_nHour;											///< UTC hour
+		int					m_nMinute;											///< UTC minute
+		double				m_dSecond;											///< UTC second including its fraction
+		int					m_nDay;												///< Day (RMC)
+		int					m_nMonth;											///< Month (RMC)
+		int					m_nYear;											///< Year (RMC)
+		double				m_dLatitude;										///< Latitude (Decimal degrees, S < 0 > N). Not decoded with NMEAPARSER_FIXED_POINT_COORDINATES
+		double				m_dLongitude;										///< Longitude (Decimal degrees, W < 0 > E). Not decoded with NMEAPARSER_FIXED_POINT_COORDINATES
+		int64_t				m_n64Latitude;										///< Latitude (1e-7 minutes of arc, S < 0 > N)
+		int64_t				m_n64Longitude;										///< Longitude (1e-7 minutes of arc, W < 0 > E)
+		double				m_dAltitudeMSL;										///< Altitude (Meters, GGA)
+		double				m_dGeoidalSep;										///< Geoidal separation (Meters, GGA)
+		GPS_QUALITY_E		m_nGPSQuality;										///< GPS Quality (GGA)
+		int					m_nSatsInUse;										///< Number of satellites in use (GGA)
+		RMC_STATUS_E		m_nStatus;											///< Status (RMC)
+		double				m_dSpeedKnots;										///< Speed over the ground in knots (RMC)
+		double				m_dTrackAngle;										///< Track angle in degrees True North (RMC)
+		double				m_dMagneticVariation;								///< Magnetic Variation (RMC)
+		double				m_dVertSpeed;										///< Derived vertical speed (GGA)
+		ACTIVE_SAT_MODE_E	m_nMode;											///< Fix, 2D/3D mode (GSA)
+		double				m_dPDOP;											///< PDOP (GSA)
+		double				m_dHDOP;											///< HDOP (GSA, or GGA if there is no GSA)
+		double				m_dVDOP;											///< VDOP (GSA)
+		int					m_nUsedCount;										///< Number of entries in m_pUsed
+		EPOCH_PRN_T			m_pUsed[c_nMaxEpochSatellites];						///< Satellites used in the fix, grouped by GSA talker
+		int					m_nVisibleCount;									///< Number of entries in m_pVisible
+		EPOCH_SAT_T			m_pVisible[c_nMaxEpochSatellites];					///< Visible satellites, grouped by GSV talker
+	} EPOCH_DATA_T;
+
+	///
+	/// GNSS constellations, see CNMEAParserSatellites::GetConstellation()
+	///
+	enum CONSTELLATION_E {
+		CONSTELLATION_UNKNOWN = 0,												///< Unknown constellation
+		CONSTELLATION_GPS = 1,													///< GPS, including SBAS
+		CONSTELLATION_GLONASS = 2,												///< GLONASS
+		CONSTELLATION_GALILEO = 3,												///< Galileo
+		CONSTELLATION_BEIDOU = 4,												///< BeiDou
+		CONSTELLATION_QZSS = 5,													///< QZSS
+		CONSTELLATION_NAVIC = 6,												///< NavIC
+	};
+	static const int			c_nConstellations = 7;							///< Number of CONSTELLATION_E values
+
+	///
+	/// Flags of a satellite in the sky view, see SKY_SAT_T::u8Flags
+	///
+	enum SKY_SAT_FLAGS_E {
+		SKY_SAT_IN_USE = 0x01,													///< A GSA sentence lists the satellite as used in the fix
+	};
+
+	///
+	/// Satellite in the sky view, see CNMEAParserSkyView
+	///
+	typedef struct _SKY_SAT_T {
+		uint16_t							u16Talker;							///< Talker ID of the GSV sentences (TALKER_ID_E)
+		uint8_t								u8Constellation;					///< Constellation (CONSTELLATION_E)
+		uint8_t								u8Flags;							///< SKY_SAT_FLAGS_E flags
+		CNMEAParserData::SAT_INFO_COMPACT_T	Sat;								///< Satellite
+	} SKY_SAT_T;
+
+	///
+	/// All tracked satellites of every constellation in one table, see CNMEAParserSkyView
+	///
+	typedef struct _SKY_VIEW_T {
+		int									nCount;								///< Number of satellites in pSats
+		int									nInUse;								///< Number of satellites in pSats with SKY_SAT_IN_USE
+		CNMEAParserData::SKY_SAT_T			pSats[c_nMaxEpochSatellites];		///< Satellites, in no particular order
+	} SKY_VIEW_T;
 };
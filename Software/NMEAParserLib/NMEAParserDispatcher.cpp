@@ -0,0 +1,281 @@
+/*
+* MIT License
+*
+*  Copyright (c) 2018 VisualGPS, LLC
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this software and associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright notice and this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*
+*/
+#include "NMEAParserDispatcher.h"
+#include "NMEAParserSatellites.h"
+
+CNMEAParserDispatcher::CNMEAParserDispatcher() :
+	m_uSkippedCount(0),
+	m_pEpoch(NULL),
+	m_bEpochAssembly(false),
+	m_pSkyView(NULL),
+	m_bSkyView(false),
+	m_pAIS(NULL),
+	m_bAIS(false)
+{
+#if NMEAPARSER_DEFAULT_SENTENCES
+	//
+	// Talker/sentence pairs that are always decoded. Other pairs are added when they are first received.
+	// Pairs of disabled sentences (see NMEAParserConfig.h) are not added.
+	//
+	static const struct {
+		CNMEAParserData::TALKER_ID_E	nTalker;
+		CNMEAParserData::SENTENCE_ID_E	nSentence;
+	} s_pDefaultSentences[] = {
+		{ CNMEAParserData::TID_GP, CNMEAParserData::SID_GGA }, { CNMEAParserData::TID_GP, CNMEAParserData::SID_GSV },
+		{ CNMEAParserData::TID_GP, CNMEAParserData::SID_GSA }, { CNMEAParserData::TID_GP, CNMEAParserData::SID_RMC },
+		{ CNMEAParserData::TID_GA, CNMEAParserData::SID_GGA }, { CNMEAParserData::TID_GA, CNMEAParserData::SID_GSV },
+		{ CNMEAParserData::TID_GA, CNMEAParserData::SID_GSA }, { CNMEAParserData::TID_GA, CNMEAParserData::SID_RMC },
+		{ CNMEAParserData::TID_GN, CNMEAParserData::SID_GGA }, { CNMEAParserData::TID_GN, CNMEAParserData::SID_GSA },
+		{ CNMEAParserData::TID_GN, CNMEAParserData::SID_RMC },
+		{ CNMEAParserData::TID_GL, CNMEAParserData::SID_GSV }, { CNMEAParserData::TID_GL, CNMEAParserData::SID_GSA },
+		{ CNMEAParserData::TID_QZ, CNMEAParserData::SID_GSV }, { CNMEAParserData::TID_QZ, CNMEAParserData::SID_GSA },
+		{ CNMEAParserData::TID_BD, CNMEAParserData::SID_GSV }, { CNMEAParserData::TID_BD, CNMEAParserData::SID_GSA },
+	};
+
+	for (size_t i = 0; i < sizeof(s_pDefaultSentences) / sizeof(s_pDefaultSentences[0]); i++) {
+		m_Registry.AddSlot(s_pDefaultSentences[i].nTalker, s_pDefaultSentences[i].nSentence);
+	}
+#endif
+}
+
+CNMEAParserDispatcher::~CNMEAParserDispatcher()
+{
+	delete m_pEpoch;
+	delete m_pSkyView;
+	delete m_pAIS;
+}
+
+void CNMEAParserDispatcher::SetEpochAssembly(bool bEnable)
+{
+	if (bEnable && m_pEpoch == NULL) {
+		m_pEpoch = new CNMEAParserEpoch();
+	}
+	m_bEpochAssembly = bEnable;
+}
+
+CNMEAParserData::ERROR_E CNMEAParserDispatcher::GetEpoch(CNMEAParserData::EPOCH_DATA_T &Epoch) const
+{
+	if (m_pEpoch == NULL) {
+		return CNMEAParserData::ERROR_FAIL;
+	}
+	Epoch = m_pEpoch->GetEpochData();
+	return CNMEAParserData::ERROR_OK;
+}
+
+CNMEAParserLease<CNMEAParserData::EPOCH_DATA_T> CNMEAParserDispatcher::LeaseEpoch(void) const
+{
+	if (m_pEpoch == NULL) {
+		return CNMEAParserLease<CNMEAParserData::EPOCH_DATA_T>();
+	}
+	return m_pEpoch->LeaseEpochData();
+}
+
+void CNMEAParserDispatcher::SetSkyView(bool bEnable)
+{
+	if (bEnable && m_pSkyView == NULL) {
+		m_pSkyView = new CNMEAParserSkyView();
+	}
+	m_bSkyView = bEnable;
+}
+
+CNMEAParserData::ERROR_E CNMEAParserDispatcher::GetSkyView(CNMEAParserData::SKY_VIEW_T &View) const
+{
+	if (m_pSkyView == NULL) {
+		return CNMEAParserData::ERROR_FAIL;
+	}
+	View = m_pSkyView->GetSkyViewData();
+	return CNMEAParserData::ERROR_OK;
+}
+
+CNMEAParserLease<CNMEAParserData::SKY_VIEW_T> CNMEAParserDispatcher::LeaseSkyView(void) const
+{
+	if (m_pSkyView == NULL) {
+		return CNMEAParserLease<CNMEAParserData::SKY_VIEW_T>();
+	}
+	return m_pSkyView->LeaseSkyViewData();
+}
+
+void CNMEAParserDispatcher::SetAIS(bool bEnable)
+{
+	if (bEnable && m_pAIS == NULL) {
+		m_pAIS = new CNMEAParserAIS();
+	}
+	m_bAIS = bEnable;
+}
+
+void CNMEAParserDispatcher::ResetDecoders(void)
+{
+	m_Registry.ResetData();
+	if (m_pEpoch != NULL) {
+		m_pEpoch->ResetData();
+	}
+	if (m_pSkyView != NULL) {
+		m_pSkyView->ResetData();
+	}
+	if (m_pAIS != NULL) {
+		m_pAIS->Reset();
+	}
+}
+
+CNMEAParserData::ERROR_E CNMEAParserDispatcher::AddSentence(CNMEAParserData::TALKER_ID_E nTalker, CNMEAParserData::SENTENCE_ID_E nSentence)
+{
+	return (m_Registry.AddSlot(nTalker, nSentence) < 0) ? CNMEAParserData::ERROR_FAIL : CNMEAParserData::ERROR_OK;
+}
+
+CNMEAParserData::ERROR_E CNMEAParserDispatcher::GetGPGGA(CNMEAParserData::GGA_DATA_T & sentenseData)
+{
+	return Get<CNMEAParserData::TID_GP, CNMEAParserData::SID_GGA>(sentenseData);
+}
+
+CNMEAParserData::ERROR_E CNMEAParserDispatcher::GetGNGGA(CNMEAParserData::GGA_DATA_T & sentenseData)
+{
+	return Get<CNMEAParserData::TID_GN, CNMEAParserData::SID_GGA>(sentenseData);
+}
+
+CNMEAParserData::ERROR_E CNMEAParserDispatcher::GetGPGSV(CNMEAParserData::GSV_DATA_T & sentenseData)
+{
+	return Get<CNMEAParserData::TID_GP, CNMEAParserData::SID_GSV>(sentenseData);
+}
+
+CNMEAParserData::ERROR_E CNMEAParserDispatcher::GetGPGSA(CNMEAParserData::GSA_DATA_T & sentenseData)
+{
+	return Get<CNMEAParserData::TID_GP, CNMEAParserData::SID_GSA>(sentenseData);
+}
+
+CNMEAParserData::ERROR_E CNMEAParserDispatcher::GetGPRMC(CNMEAParserData::RMC_DATA_T & sentenseData)
+{
+	return Get<CNMEAParserData::TID_GP, CNMEAParserData::SID_RMC>(sentenseData);
+}
+
+CNMEAParserData::ERROR_E CNMEAParserDispatcher::GetGNRMC(CNMEAParserData::RMC_DATA_T & sentenseData)
+{
+	return Get<CNMEAParserData::TID_GN, CNMEAParserData::SID_RMC>(sentenseData);
+}
+
+CNMEAParserData::ERROR_E CNMEAParserDispatcher::GetGNGSA(CNMEAParserData::GSA_DATA_T & sentenseData)
+{
+	return Get<CNMEAParserData::TID_GN, CNMEAParserData::SID_GSA>(sentenseData);
+}
+
+CNMEAParserData::ERROR_E CNMEAParserDispatcher::GetGLGSV(CNMEAParserData::GSV_DATA_T & sentenseData)
+{
+	return Get<CNMEAParserData::TID_GL, CNMEAParserData::SID_GSV>(sentenseData);
+}
+
+CNMEAParserData::ERROR_E CNMEAParserDispatcher::GetGLGSA(CNMEAParserData::GSA_DATA_T & sentenseData)
+{
+	return Get<CNMEAParserData::TID_GL, CNMEAParserData::SID_GSA>(sentenseData);
+}
+
+CNMEAParserData::ERROR_E CNMEAParserDispatcher::GetQZGSV(CNMEAParserData::GSV_DATA_T & sentenseData)
+{
+	return Get<CNMEAParserData::TID_QZ, CNMEAParserData::SID_GSV>(sentenseData);
+}
+
+CNMEAParserData::ERROR_E CNMEAParserDispatcher::GetQZGSA(CNMEAParserData::GSA_DATA_T & sentenseData)
+{
+	return Get<CNMEAParserData::TID_QZ, CNMEAParserData::SID_GSA>(sentenseData);
+}
+
+CNMEAParserData::ERROR_E CNMEAParserDispatcher::GetBDGSV(CNMEAParserData::GSV_DATA_T & sentenseData)
+{
+	return Get<CNMEAParserData::TID_BD, CNMEAParserData::SID_GSV>(sentenseData);
+}
+
+CNMEAParserData::ERROR_E CNMEAParserDispatcher::GetBDGSA(CNMEAParserData::GSA_DATA_T & sentenseData)
+{
+	return Get<CNMEAParserData::TID_BD, CNMEAParserData::SID_GSA>(sentenseData);
+}
+
+CNMEAParserData::ERROR_E CNMEAParserDispatcher::GetGAGGA(CNMEAParserData::GGA_DATA_T & sentenseData)
+{
+	return Get<CNMEAParserData::TID_GA, CNMEAParserData::SID_GGA>(sentenseData);
+}
+
+CNMEAParserData::ERROR_E CNMEAParserDispatcher::GetGAGSV(CNMEAParserData::GSV_DATA_T & sentenseData)
+{
+	return Get<CNMEAParserData::TID_GA, CNMEAParserData::SID_GSV>(sentenseData);
+}
+
+CNMEAParserData::ERROR_E CNMEAParserDispatcher::GetGAGSA(CNMEAParserData::GSA_DATA_T & sentenseData)
+{
+	return Get<CNMEAParserData::TID_GA, CNMEAParserData::SID_GSA>(sentenseData);
+}
+
+CNMEAParserData::ERROR_E CNMEAParserDispatcher::GetGARMC(CNMEAParserData::RMC_DATA_T & sentenseData)
+{
+	return Get<CNMEAParserData::TID_GA, CNMEAParserData::SID_RMC>(sentenseData);
+}
+
+CNMEAParserLease<CNMEAParserData::GGA_DATA_T> CNMEAParserDispatcher::LeaseGGA(CNMEAParserData::TALKER_ID_E nTalker) const
+{
+	return LeaseSentence<CNMEAParserData::SID_GGA>(nTalker);
+}
+
+CNMEAParserLease<CNMEAParserData::GSA_DATA_T> CNMEAParserDispatcher::LeaseGSA(CNMEAParserData::TALKER_ID_E nTalker) const
+{
+	return LeaseSentence<CNMEAParserData::SID_GSA>(nTalker);
+}
+
+CNMEAParserLease<CNMEASentenceGSV::STORE_T> CNMEAParserDispatcher::LeaseGSV(CNMEAParserData::TALKER_ID_E nTalker) const
+{
+	return LeaseSentence<CNMEAParserData::SID_GSV>(nTalker);
+}
+
+CNMEAParserLease<CNMEAParserData::RMC_DATA_T> CNMEAParserDispatcher::LeaseRMC(CNMEAParserData::TALKER_ID_E nTalker) const
+{
+	return LeaseSentence<CNMEAParserData::SID_RMC>(nTalker);
+}
+
+CNMEAParserData::ERROR_E CNMEAParserDispatcher::SetSubscription(CNMEAParserData::TALKER_ID_E nTalker, CNMEAParserData::SENTENCE_ID_E nSentence, bool bSubscribed)
+{
+	return m_Registry.SetSubscribed(nTalker, nSentence, bSubscribed) ? CNMEAParserData::ERROR_OK : CNMEAParserData::ERROR_FAIL;
+}
+
+CNMEAParserData::ERROR_E CNMEAParserDispatcher::SetSubscription(CNMEAParserData::SENTENCE_ID_E nSentence, bool bSubscribed)
+{
+	return m_Registry.SetSubscribed(nSentence, bSubscribed) ? CNMEAParserData::ERROR_OK : CNMEAParserData::ERROR_FAIL;
+}
+
+bool CNMEAParserDispatcher::IsSubscribed(CNMEAParserData::TALKER_ID_E nTalker, CNMEAParserData::SENTENCE_ID_E nSentence) const
+{
+	return m_Registry.IsSubscribed(nTalker, nSentence);
+}
+
+CNMEAParserData::ERROR_E CNMEAParserDispatcher::GetSatelliteView(CNMEAParserData::TALKER_ID_E nTalker, CNMEAParserData::SAT_VIEW_T &View) const
+{
+	CNMEAParserLease<CNMEASentenceGSV::STORE_T> Lease = LeaseSentence<CNMEAParserData::SID_GSV>(nTalker);
+	if (!Lease.IsValid()) {
+		return CNMEAParserData::ERROR_FAIL;
+	}
+	CNMEAParserSatellites::BuildView(*Lease, View);
+	return CNMEAParserData::ERROR_OK;
+}
+
+uint32_t CNMEAParserDispatcher::GetUpdateSequence(CNMEAParserData::TALKER_ID_E nTalker, CNMEAParserData::SENTENCE_ID_E nSentence) const
+{
+	const CNMEAParserRegistry::SLOT_T *pSlot = m_Registry.FindSlot(nTalker, nSentence);
+	return (pSlot == NULL) ? 0 : pSlot->pSentence->GetUpdateSequence();
+}
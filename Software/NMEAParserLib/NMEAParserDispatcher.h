@@ -0,0 +1,561 @@
+/*
+* MIT License
+*
+*  Copyright (c) 2018 VisualGPS, LLC
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this software and associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright notice and this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*
+*/
+
+#pragma once
+#include <cstddef>
+#include <stdint.h>
+#include <atomic>
+
+#include "NMEAParserData.h"
+#include "NMEAParserAIS.h"
+#include "NMEAParserRegistry.h"
+#include "NMEAParserEpoch.h"
+#include "NMEAParserSkyView.h"
+#include "NMEAParserTrace.h"
+
+///
+/// \class CNMEAParserDispatcher
+/// \brief Stores the decoded NMEA data and passes each framed sentence to its decoder.
+///
+/// This is the part of CNMEAParser that does not depend on how the parser is called back. It is
+/// shared by CNMEAParser, whose hooks are virtual, and CNMEAParserStatic, whose hooks are resolved
+/// at compile time.
+///
+/// The GetXXX() methods may be called from any thread while another thread parses. They return
+/// the data of the last complete sentence and never block the parsing thread.
+///
+class CNMEAParserDispatcher {
+
+protected:
+	CNMEAParserRegistry		m_Registry;											///< Decoder for every talker/sentence pair
+	std::atomic<uint32_t>	m_uSkippedCount;									///< Sentences skipped because they are not subscribed
+	CNMEAParserEpoch *		m_pEpoch;											///< Epoch assembler, NULL until SetEpochAssembly() turns it on
+	bool					m_bEpochAssembly;									///< Decoded sentences are passed to m_pEpoch
+	CNMEAParserSkyView *	m_pSkyView;											///< Merged satellite table, NULL until SetSkyView() turns it on
+	bool					m_bSkyView;											///< Decoded sentences are passed to m_pSkyView
+	CNMEAParserAIS *		m_pAIS;												///< AIS message assembler, NULL until SetAIS() turns it on
+	bool					m_bAIS;												///< AIS sentences are passed to m_pAIS
+
+public:
+	CNMEAParserDispatcher();
+	~CNMEAParserDispatcher();
+
+	///
+	/// \brief Adds a decoder for a talker/sentence pair before parsing starts.
+	///
+	/// GP, GA and GN GGA/GSA/RMC, GP and GA GSV and GL, QZ and BD GSA/GSV are always added, unless
+	/// the library is built with NMEAPARSER_DEFAULT_SENTENCES=0 (see NMEAParserConfig.h). Other
+	/// pairs are added the first time they are received unless auto create is turned off
+	/// (see SetAutoCreate()). Call this from the parsing thread or before parsing starts.
+	///
+	/// \param nTalker Talker ID, ie: TID_GB
+	/// \param nSentence Sentence ID, ie: SID_GSV
+	/// \return Returns ERROR_OK if successful, ERROR_FAIL if the sentence is not supported or the table is full.
+	///
+	CNMEAParserData::ERROR_E AddSentence(CNMEAParserData::TALKER_ID_E nTalker, CNMEAParserData::SENTENCE_ID_E nSentence);
+
+	///
+	/// \brief Enables or disables adding decoders for talkers the first time they are received. Enabled by default.
+	///
+	/// With auto create off, only the pairs added with AddSentence() (and the defaults) are decoded.
+	///
+	void SetAutoCreate(bool bAutoCreate) { m_Registry.SetAutoCreate(bAutoCreate); }
+
+	///
+	/// \brief Turns lazy decoding on or off. Off by default.
+	///
+	/// With lazy decoding, GGA and RMC sentences are checksum validated and copied on the parsing
+	/// thread but their fields are decoded by the first GetXXX() or LeaseXXX() after each update,
+	/// and the result is cached until the next sentence. Use it when sentences arrive much faster
+	/// than they are read. In lazy mode a field left empty by a sentence, other than the GGA time
+	/// and altitude, reads as its reset value instead of the value from an earlier sentence. GSA
+	/// and GSV build up their data over several sentences and are always decoded on receipt.
+	///
+	/// Call this from the parsing thread or before parsing starts. Changing the mode resets the
+	/// GGA and RMC data.
+	///
+	void SetLazyDecode(bool bLazy) { m_Registry.SetLazyDecode(bLazy); }
+
+	///
+	/// \brief Turns the epoch assembler on or off. Off by default.
+	///
+	/// The epoch assembler fuses the GGA, RMC, GSA and GSV sentences of one fix into a single
+	/// EPOCH_DATA_T record, see CNMEAParserEpoch. When an epoch closes, the OnEpoch() hook is called
+	/// once with the record and GetEpoch() returns it. Call this from the parsing thread or before
+	/// parsing starts.
+	///
+	void SetEpochAssembly(bool bEnable);
+
+	///
+	/// \brief Places a copy of the last closed epoch into Epoch. Safe to call from any thread.
+	///
+	/// \param Epoch Receives the epoch
+	/// \return Returns ERROR_OK if successful, ERROR_FAIL if the epoch assembler was never turned on.
+	///
+	CNMEAParserData::ERROR_E GetEpoch(CNMEAParserData::EPOCH_DATA_T &Epoch) const;
+
+	///
+	/// \brief Returns a lease on the last closed epoch without copying it. See CNMEAParserLease.
+	///
+	/// \return The lease. Not valid (CNMEAParserLease::IsValid()) if the epoch assembler was never turned on.
+	///
+	CNMEAParserLease<CNMEAParserData::EPOCH_DATA_T> LeaseEpoch(void) const;
+
+	///
+	/// \brief Returns the update sequence number of the epochs, or 0 if the epoch assembler was never turned on.
+	///
+	uint32_t GetEpochSequence(void) const { return (m_pEpoch == NULL) ? 0 : m_pEpoch->GetUpdateSequence(); }
+
+	///
+	/// \brief Turns the merged satellite table on or off. Off by default.
+	///
+	/// The table holds the satellites of every GSV talker with their in use flag from the GSA
+	/// sentences, see CNMEAParserSkyView. Call this from the parsing thread or before parsing starts.
+	///
+	void SetSkyView(bool bEnable);
+
+	///
+	/// \brief Places a copy of the merged satellite table into View. Safe to call from any thread.
+	///
+	/// \param View Receives the table
+	/// \return Returns ERROR_OK if successful, ERROR_FAIL if the table was never turned on.
+	///
+	CNMEAParserData::ERROR_E GetSkyView(CNMEAParserData::SKY_VIEW_T &View) const;
+
+	///
+	/// \brief Returns a lease on the merged satellite table without copying it. See CNMEAParserLease.
+	///
+	/// \return The lease. Not valid (CNMEAParserLease::IsValid()) if the table was never turned on.
+	///
+	CNMEAParserLease<CNMEAParserData::SKY_VIEW_T> LeaseSkyView(void) const;
+
+	///
+	/// \brief Returns the update sequence number of the merged satellite table, or 0 if it was never turned on.
+	///
+	uint32_t GetSkyViewSequence(void) const { return (m_pSkyView == NULL) ? 0 : m_pSkyView->GetUpdateSequence(); }
+
+	///
+	/// \brief Turns AIS decoding on or off. Off by default.
+	///
+	/// AIS sentences (!AIVDM, !AIVDO) are reassembled and decoded by CNMEAParserAIS, and the
+	/// OnAISMessage() hook is called once for every complete message. Call this from the parsing
+	/// thread or before parsing starts.
+	///
+	void SetAIS(bool bEnable);
+
+	///
+	/// \brief Returns the AIS message assembler for its counters, or NULL if AIS decoding was never turned on.
+	///
+	const CNMEAParserAIS *GetAIS(void) const { return m_pAIS; }
+
+	///
+	/// \brief Subscribes or unsubscribes a talker/sentence pair. Safe to call from any thread at any time.
+	///
+	/// Unsubscribed sentences are still framed and checksum validated but are not decoded, so
+	/// their data does not change. See GetSkippedCount().
+	///
+	/// \param nTalker Talker ID, ie: TID_GP
+	/// \param nSentence Sentence ID, ie: SID_GSV
+	/// \param bSubscribed true to decode the pair, false to skip it
+	/// \return Returns ERROR_OK if successful, ERROR_FAIL if the pair has not been received or added (see AddSentence()).
+	///
+	CNMEAParserData::ERROR_E SetSubscription(CNMEAParserData::TALKER_ID_E nTalker, CNMEAParserData::SENTENCE_ID_E nSentence, bool bSubscribed);
+
+	///
+	/// \brief Subscribes or unsubscribes a sentence for every talker, including talkers received later.
+	///
+	/// Safe to call from any thread at any time. For example, a tracker that only needs position
+	/// can unsubscribe SID_GSV and SID_GSA. Everything is subscribed by default.
+	///
+	/// \param nSentence Sentence ID, ie: SID_GSV
+	/// \param bSubscribed true to decode the sentence, false to skip it
+	/// \return Returns ERROR_OK if successful, ERROR_FAIL if the sentence is not supported.
+	///
+	CNMEAParserData::ERROR_E SetSubscription(CNMEAParserData::SENTENCE_ID_E nSentence, bool bSubscribed);
+
+	///
+	/// \brief Returns true if a talker/sentence pair is decoded
+	///
+	bool IsSubscribed(CNMEAParserData::TALKER_ID_E nTalker, CNMEAParserData::SENTENCE_ID_E nSentence) const;
+
+	///
+	/// \brief Returns the number of valid sentences skipped because they were not subscribed
+	///
+	uint32_t GetSkippedCount(void) const { return m_uSkippedCount.load(std::memory_order_relaxed); }
+
+	///
+	/// \brief Returns the decoder registry, for example to list the talker/sentence pairs seen so far.
+	///
+	const CNMEAParserRegistry &GetRegistry(void) const { return m_Registry; }
+
+	///
+	/// \brief Places a copy of the data of a talker/sentence pair into Data.
+	///
+	/// Example: Get<CNMEAParserData::TID_GB, CNMEAParserData::SID_GSV>(gsvData)
+	///
+	/// \param Data Receives the data, ie: GSV_DATA_T for SID_GSV
+	/// \return Returns ERROR_OK if successful, ERROR_FAIL if the pair has not been received or added.
+	///
+	template <CNMEAParserData::TALKER_ID_E nTalker, CNMEAParserData::SENTENCE_ID_E nSentence>
+	CNMEAParserData::ERROR_E Get(typename CNMEASentenceTraits<nSentence>::DATA_T &Data) const {
+		const typename CNMEASentenceTraits<nSentence>::SENTENCE_T *pSentence = FindSentence<nSentence>(nTalker);
+		if (pSentence == NULL) {
+			return CNMEAParserData::ERROR_FAIL;
+		}
+		Data = pSentence->GetSentenceData();
+		return CNMEAParserData::ERROR_OK;
+	}
+
+	///
+	/// \brief Returns a lease on the data of a talker/sentence pair without copying it. See CNMEAParserLease.
+	///
+	/// \return The lease. Not valid (CNMEAParserLease::IsValid()) if the pair has not been received or added.
+	///
+	template <CNMEAParserData::TALKER_ID_E nTalker, CNMEAParserData::SENTENCE_ID_E nSentence>
+	CNMEAParserLease<typename CNMEASentenceTraits<nSentence>::LEASE_T> Lease(void) const {
+		return LeaseSentence<nSentence>(nTalker);
+	}
+
+	///
+	/// \brief Places a copy of the GPGGA data into sentenseData
+	/// \param sentenseData reference to a CNMEASentenceGGA object to place the data into.
+	/// \return Returns ERROR_OK if successful.
+	///
+	CNMEAParserData::ERROR_E GetGPGGA(CNMEAParserData::GGA_DATA_T & sentenseData);
+
+	///
+	/// \brief Places a copy of the GNGGA data into sentenseData
+	/// \param sentenseData reference to a CNMEASentenceGGA object to place the data into.
+	/// \return Returns ERROR_OK if successful.
+	///
+	CNMEAParserData::ERROR_E GetGNGGA(CNMEAParserData::GGA_DATA_T & sentenseData);
+
+	///
+	/// \brief Places a copy of the GPGSV data into sentenseData
+	/// \param sentenseData reference to a CNMEASentenceGSV object to place the data into.
+	/// \return Returns ERROR_OK if successful.
+	///
+	CNMEAParserData::ERROR_E GetGPGSV(CNMEAParserData::GSV_DATA_T & sentenseData);
+
+	///
+	/// \brief Places a copy of the GPGSA data into sentenseData
+	/// \param sentenseData reference to a CNMEASentenceGSA object to place the data into.
+	/// \return Returns ERROR_OK if successful.
+	///
+	CNMEAParserData::ERROR_E GetGPGSA(CNMEAParserData::GSA_DATA_T & sentenseData);
+
+	///
+	/// \brief Places a copy of the GPRMC data into sentenseData
+	/// \param sentenseData reference to a CNMEASentenceGSA object to place the data into.
+	/// \return Returns ERROR_OK if successful.
+	///
+	CNMEAParserData::ERROR_E GetGPRMC(CNMEAParserData::RMC_DATA_T & sentenseData);
+
+	///
+	/// \brief Places a copy of the GNRMC data into sentenseData
+	/// \param sentenseData reference to a CNMEASentenceGSA object to place the data into.
+	/// \return Returns ERROR_OK if successful.
+	///
+	CNMEAParserData::ERROR_E GetGNRMC(CNMEAParserData::RMC_DATA_T & sentenseData);
+
+	///
+    /// \brief Places a copy of the GNGSA data into sentenseData
+    /// \param sentenseData reference to a CNMEASentenceGSA object to place the data into.
+    /// \return Returns ERROR_OK if successful.
+    ///
+    CNMEAParserData::ERROR_E GetGNGSA(CNMEAParserData::GSA_DATA_T & sentenseData);
+
+    ///
+	/// \brief Places a copy of the GLGSV data into sentenseData
+	/// \param sentenseData reference to a CNMEASentenceGSV object to place the data into.
+	/// \return Returns ERROR_OK if successful.
+	///
+	CNMEAParserData::ERROR_E GetGLGSV(CNMEAParserData::GSV_DATA_T & sentenseData);
+
+	///
+	/// \brief Places a copy of the GLGSA data into sentenseData
+	/// \param sentenseData reference to a CNMEASentenceGSA object to place the data into.
+	/// \return Returns ERROR_OK if successful.
+	///
+	CNMEAParserData::ERROR_E GetGLGSA(CNMEAParserData::GSA_DATA_T & sentenseData);
+
+	///
+	/// \brief Places a copy of the QZGSV data into sentenseData
+	/// \param sentenseData reference to a CNMEASentenceGSV object to place the data into.
+	/// \return Returns ERROR_OK if successful.
+	///
+	CNMEAParserData::ERROR_E GetQZGSV(CNMEAParserData::GSV_DATA_T & sentenseData);
+
+	///
+	/// \brief Places a copy of the QZGSA data into sentenseData
+	/// \param sentenseData reference to a CNMEASentenceGSA object to place the data into.
+	/// \return Returns ERROR_OK if successful.
+	///
+	CNMEAParserData::ERROR_E GetQZGSA(CNMEAParserData::GSA_DATA_T & sentenseData);
+
+	///
+	/// \brief Places a copy of the BDGSV data into sentenseData
+	/// \param sentenseData reference to a CNMEASentenceGSV object to place the data into.
+	/// \return Returns ERROR_OK if successful.
+	///
+	CNMEAParserData::ERROR_E GetBDGSV(CNMEAParserData::GSV_DATA_T & sentenseData);
+
+	///
+	/// \brief Places a copy of the QZGSA data into sentenseData
+	/// \param sentenseData reference to a CNMEASentenceGSA object to place the data into.
+	/// \return Returns ERROR_OK if successful.
+	///
+	CNMEAParserData::ERROR_E GetBDGSA(CNMEAParserData::GSA_DATA_T & sentenseData);
+
+	///
+	/// \brief Places a copy of the GAGGA data into sentenseData
+	/// \param sentenseData reference to a CNMEASentenceGGA object to place the data into.
+	/// \return Returns ERROR_OK if successful.
+	///
+	CNMEAParserData::ERROR_E GetGAGGA(CNMEAParserData::GGA_DATA_T & sentenseData);
+
+	///
+	/// \brief Places a copy of the GAGSV data into sentenseData
+	/// \param sentenseData reference to a CNMEASentenceGSV object to place the data into.
+	/// \return Returns ERROR_OK if successful.
+	///
+	CNMEAParserData::ERROR_E GetGAGSV(CNMEAParserData::GSV_DATA_T & sentenseData);
+
+	///
+	/// \brief Places a copy of the GAGSA data into sentenseData
+	/// \param sentenseData reference to a CNMEASentenceGSA object to place the data into.
+	/// \return Returns ERROR_OK if successful.
+	///
+	CNMEAParserData::ERROR_E GetGAGSA(CNMEAParserData::GSA_DATA_T & sentenseData);
+
+	///
+	/// \brief Places a copy of the GARMC data into sentenseData
+	/// \param sentenseData reference to a CNMEASentenceGSA object to place the data into.
+	/// \return Returns ERROR_OK if successful.
+	///
+	CNMEAParserData::ERROR_E GetGARMC(CNMEAParserData::RMC_DATA_T & sentenseData);
+
+	///
+	/// \brief Returns a lease on the GGA data of a talker without copying it. See CNMEAParserLease.
+	/// \param nTalker Talker ID, ie: TID_GP
+	/// \return The lease. Not valid (CNMEAParserLease::IsValid()) if GGA has not been received or added for nTalker.
+	///
+	CNMEAParserLease<CNMEAParserData::GGA_DATA_T> LeaseGGA(CNMEAParserData::TALKER_ID_E nTalker) const;
+
+	///
+	/// \brief Returns a lease on the GSA data of a talker without copying it. See CNMEAParserLease.
+	/// \param nTalker Talker ID, ie: TID_GP
+	/// \return The lease. Not valid (CNMEAParserLease::IsValid()) if GSA has not been received or added for nTalker.
+	///
+	CNMEAParserLease<CNMEAParserData::GSA_DATA_T> LeaseGSA(CNMEAParserData::TALKER_ID_E nTalker) const;
+
+	///
+	/// \brief Returns a lease on the GSV data of a talker without copying it. See CNMEAParserLease.
+	/// \param nTalker Talker ID, ie: TID_GP
+	/// \return The lease. Not valid (CNMEAParserLease::IsValid()) if GSV has not been received or added for nTalker.
+	/// The data is GSV_COMPACT_T when NMEAPARSER_COMPACT_SATELLITES is set.
+	///
+	CNMEAParserLease<CNMEASentenceGSV::STORE_T> LeaseGSV(CNMEAParserData::TALKER_ID_E nTalker) const;
+
+	///
+	/// \brief Returns a lease on the RMC data of a talker without copying it. See CNMEAParserLease.
+	/// \param nTalker Talker ID, ie: TID_GP
+	/// \return The lease. Not valid (CNMEAParserLease::IsValid()) if RMC has not been received or added for nTalker.
+	///
+	CNMEAParserLease<CNMEAParserData::RMC_DATA_T> LeaseRMC(CNMEAParserData::TALKER_ID_E nTalker) const;
+
+	///
+	/// \brief Fills a structure of arrays view of the satellites in view of a GSV talker.
+	///
+	/// The data is read in place through a lease, so this does not copy the full GSV data.
+	///
+	/// \param nTalker Talker ID, ie: TID_GP
+	/// \param View Receives the satellites, see CNMEAParserSatellites::BuildView()
+	/// \return Returns ERROR_OK if successful, ERROR_FAIL if GSV has not been received or added for nTalker.
+	///
+	CNMEAParserData::ERROR_E GetSatelliteView(CNMEAParserData::TALKER_ID_E nTalker, CNMEAParserData::SAT_VIEW_T &View) const;
+
+	///
+	/// \brief Returns the update sequence number of a sentence, see CNMEASentenceBase::GetUpdateSequence().
+	///
+	/// Poll this to skip work when nothing is new. It is cheaper than taking a lease or copying the data.
+	///
+	/// \param nTalker Talker ID, ie: TID_GP
+	/// \param nSentence Sentence ID, ie: SID_GGA
+	/// \return The update sequence number or 0 if the sentence has not been received or added.
+	///
+	uint32_t GetUpdateSequence(CNMEAParserData::TALKER_ID_E nTalker, CNMEAParserData::SENTENCE_ID_E nSentence) const;
+
+protected:
+	///
+	/// \brief Decodes a framed sentence.
+	///
+	/// THooks provides DataAccessSemaphoreLock() and DataAccessSemaphoreUnlock(), which are taken
+	/// around the update. They are called through THooks, so they are inlined unless they are virtual.
+	///
+	/// \param Sentence View of the NMEA command and its comma separated data
+	/// \param pTrace Event trace or NULL
+	/// \param Hooks Object providing the lock hooks
+	/// \return Returns CNMEAParserData::ERROR_OK If successful
+	///
+	template <class THooks>
+	CNMEAParserData::ERROR_E Dispatch(const CNMEAParserData::SENTENCE_VIEW_T &Sentence, CNMEAParserTrace *pTrace, THooks &Hooks) {
+		UNUSED_PARAM(pTrace);
+
+		//
+		// AIS sentences are not stored, each complete message goes to the hook
+		//
+		if (m_bAIS && CNMEAParserAIS::IsAIS(Sentence)) {
+			NMEAPARSER_TRACE_EVENT(pTrace, CNMEAParserTrace::TE_SENTENCE, Sentence.pCmd, Sentence.nCmdLen, CNMEAParserData::ERROR_OK);
+			bool bComplete;
+			CNMEAParserData::ERROR_E nError = m_pAIS->ProcessSentence(Sentence, bComplete);
+			if (bComplete) {
+				Hooks.OnAISMessage(m_pAIS->GetMessage());
+			}
+			return nError;
+		}
+
+		//
+		// Look up the decoder from the packed talker and sentence ID. Unknown or unsupported
+		// sentences are rejected here.
+		//
+		int nSlot = m_Registry.FindSlot(Sentence.pCmd, Sentence.nCmdLen);
+		if (nSlot < 0) {
+			NMEAPARSER_TRACE_EVENT(pTrace, CNMEAParserTrace::TE_UNKNOWN_SENTENCE, Sentence.pCmd, Sentence.nCmdLen, CNMEAParserData::ERROR_OK);
+			return CNMEAParserData::ERROR_OK;
+		}
+
+		//
+		// Sentences nobody subscribed to are counted and skipped without decoding
+		//
+		bool bSubscribed = m_Registry.IsSubscribed(nSlot);
+		if (bSubscribed) {
+			NMEAPARSER_TRACE_EVENT(pTrace, CNMEAParserTrace::TE_SENTENCE, Sentence.pCmd, Sentence.nCmdLen, CNMEAParserData::ERROR_OK);
+		}
+		else {
+			NMEAPARSER_TRACE_EVENT(pTrace, CNMEAParserTrace::TE_SKIPPED_SENTENCE, Sentence.pCmd, Sentence.nCmdLen, CNMEAParserData::ERROR_OK);
+			m_uSkippedCount.store(m_uSkippedCount.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+		}
+
+		const CNMEAParserRegistry::SLOT_T &Slot = m_Registry.GetSlot(nSlot);
+
+		//
+		// A sentence with a new UTC time closes the epoch before it is decoded
+		//
+		bool bEpoch = bSubscribed && m_bEpochAssembly;
+		if (bEpoch) {
+			Hooks.DataAccessSemaphoreLock();
+			bool bClosed = m_pEpoch->StartSentence(Slot, Sentence);
+			Hooks.DataAccessSemaphoreUnlock();
+			if (bClosed) {
+				ReportEpoch(Hooks);
+			}
+		}
+
+		Hooks.DataAccessSemaphoreLock();
+		if (bSubscribed) {
+			DecodeSentence(Slot, Sentence);
+			if (bEpoch) {
+				bEpoch = m_pEpoch->EndSentence(Slot, nSlot);
+			}
+			if (m_bSkyView) {
+				m_pSkyView->ProcessSentence(Slot, Sentence);
+			}
+		}
+
+		//
+		// A GGA starts a new position update. Let the GSA of the same talker know, even if the
+		// GGA itself is not decoded.
+		//
+		if (Slot.nGSASlot >= 0) {
+			static_cast<CNMEASentenceGSA *>(m_Registry.GetSlot(Slot.nGSASlot).pSentence)->FlagReceivedGGA();
+		}
+		Hooks.DataAccessSemaphoreUnlock();
+
+		if (bEpoch) {
+			ReportEpoch(Hooks);
+		}
+
+		return CNMEAParserData::ERROR_OK;
+	}
+
+	///
+	/// \brief Calls the OnEpoch() hook with the epoch that just closed. Called outside of the data lock.
+	///
+	template <class THooks>
+	void ReportEpoch(THooks &Hooks) {
+		CNMEAParserLease<CNMEAParserData::EPOCH_DATA_T> Epoch = m_pEpoch->LeaseEpochData();
+		Hooks.OnEpoch(*Epoch);
+	}
+
+	///
+	/// \brief Clears the decoded data, the epoch assembler, the merged satellite table and the AIS fragments. Call with the data lock held.
+	///
+	void ResetDecoders(void);
+
+	///
+	/// \brief Calls the decoder of a slot. The registry creates the decoders, so their exact class is known and the call is not virtual.
+	///
+	static void DecodeSentence(const CNMEAParserRegistry::SLOT_T &Slot, const CNMEAParserData::SENTENCE_VIEW_T &Sentence) {
+		switch (Slot.nSentence) {
+#if NMEAPARSER_ENABLE_GGA
+		case CNMEAParserData::SID_GGA: static_cast<CNMEASentenceGGA *>(Slot.pSentence)->CNMEASentenceGGA::ProcessSentence(Sentence); break;
+#endif
+#if NMEAPARSER_ENABLE_GSA
+		case CNMEAParserData::SID_GSA: static_cast<CNMEASentenceGSA *>(Slot.pSentence)->CNMEASentenceGSA::ProcessSentence(Sentence); break;
+#endif
+#if NMEAPARSER_ENABLE_GSV
+		case CNMEAParserData::SID_GSV: static_cast<CNMEASentenceGSV *>(Slot.pSentence)->CNMEASentenceGSV::ProcessSentence(Sentence); break;
+#endif
+#if NMEAPARSER_ENABLE_RMC
+		case CNMEAParserData::SID_RMC: static_cast<CNMEASentenceRMC *>(Slot.pSentence)->CNMEASentenceRMC::ProcessSentence(Sentence); break;
+#endif
+		default: Slot.pSentence->ProcessSentence(Sentence); break;
+		}
+	}
+
+private:
+	///
+	/// \brief Returns the decoder for a talker and sentence ID or NULL if there is none
+	///
+	template <CNMEAParserData::SENTENCE_ID_E nSentence>
+	const typename CNMEASentenceTraits<nSentence>::SENTENCE_T *FindSentence(CNMEAParserData::TALKER_ID_E nTalker) const {
+		const CNMEAParserRegistry::SLOT_T *pSlot = m_Registry.FindSlot(nTalker, nSentence);
+		return (pSlot == NULL) ? NULL : static_cast<const typename CNMEASentenceTraits<nSentence>::SENTENCE_T *>(pSlot->pSentence);
+	}
+
+	///
+	/// \brief Returns a lease on the data of a talker/sentence pair. Not valid if there is no decoder for it.
+	///
+	template <CNMEAParserData::SENTENCE_ID_E nSentence>
+	CNMEAParserLease<typename CNMEASentenceTraits<nSentence>::LEASE_T> LeaseSentence(CNMEAParserData::TALKER_ID_E nTalker) const {
+		const typename CNMEASentenceTraits<nSentence>::SENTENCE_T *pSentence = FindSentence<nSentence>(nTalker);
+		if (pSentence == NULL) {
+			return CNMEAParserLease<typename CNMEASentenceTraits<nSentence>::LEASE_T>();
+		}
+		return pSentence->LeaseSentenceData();
+	}
+
+};
@@ -0,0 +1,273 @@
+/*
+* MIT License
+*
+*  Copyright (c) 2018 VisualGPS, LLC
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this software and associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright notice and this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*
+*/
+#include "NMEAParserEngine.h"
+
+struct CNMEAParserEngine::STREAM_T {
+	CNMEAParserStream				Parser;										///< Parser of the stream, only used by the worker running the stream
+	std::mutex						Mutex;										///< Protects Pending and bScheduled
+	std::vector<char>				Pending;									///< Bytes submitted and not yet taken by a worker
+	std::vector<char>				Work;										///< Bytes being parsed, only used by the worker running the stream
+	bool							bScheduled;									///< The stream is queued or being parsed
+
+	STREAM_T(int nStream, CNMEAParserStreamSink *pSink) : Parser(nStream, pSink), bScheduled(false) {}
+};
+
+struct CNMEAParserEngine::WORKER_T {
+	std::mutex						Mutex;										///< Protects Tasks
+	std::vector<int>				Tasks;										///< Queued stream IDs, taken from nHead on
+	size_t							nHead;										///< Index of the oldest task in Tasks
+	std::thread						Thread;										///< The worker thread
+
+	WORKER_T() : nHead(0) {}
+};
+
+///
+/// Engine and worker index of the calling thread, so tasks queued by a worker stay on its own queue
+///
+static thread_local CNMEAParserEngine *t_pEngine = NULL;
+static thread_local int t_nWorker = -1;
+
+CNMEAParserEngine::CNMEAParserEngine() :
+	m_nQueued(0),
+	m_nSleeping(0),
+	m_nScheduled(0),
+	m_uNextWorker(0),
+	m_bStop(false)
+{
+}
+
+CNMEAParserEngine::~CNMEAParserEngine()
+{
+	Stop();
+}
+
+int CNMEAParserEngine::AddStream(CNMEAParserStreamSink *pSink)
+{
+	if ((pSink == NULL) || !m_Workers.empty()) {
+		return -1;
+	}
+
+	int nStream = (int)m_Streams.size();
+	m_Streams.push_back(std::unique_ptr<STREAM_T>(new STREAM_T(nStream, pSink)));
+	return nStream;
+}
+
+CNMEAParser *CNMEAParserEngine::GetParser(int nStream)
+{
+	if ((nStream < 0) || (nStream >= (int)m_Streams.size())) {
+		return NULL;
+	}
+	return &m_Streams[nStream]->Parser;
+}
+
+CNMEAParserData::ERROR_E CNMEAParserEngine::Start(int nWorkers)
+{
+	if (!m_Workers.empty()) {
+		return CNMEAParserData::ERROR_FAIL;
+	}
+
+	if (nWorkers <= 0) {
+		nWorkers = (int)std::thread::hardware_concurrency();
+		if (nWorkers <= 0) {
+			nWorkers = 1;
+		}
+	}
+
+	m_bStop = false;
+	for (int i = 0; i < nWorkers; i++) {
+		m_Workers.push_back(std::unique_ptr<WORKER_T>(new WORKER_T()));
+	}
+
+	//
+	// Start the threads once every queue exists, they steal from each other
+	//
+	for (int i = 0; i < nWorkers; i++) {
+		m_Workers[i]->Thread = std::thread(&CNMEAParserEngine::WorkerThread, this, i);
+	}
+	return CNMEAParserData::ERROR_OK;
+}
+
+void CNMEAParserEngine::Stop(void)
+{
+	if (m_Workers.empty()) {
+		return;
+	}
+
+	Wait();
+
+	{
+		std::lock_guard<std::mutex> Lock(m_Mutex);
+		m_bStop = true;
+	}
+	m_WakeCondition.notify_all();
+
+	for (size_t i = 0; i < m_Workers.size(); i++) {
+		m_Workers[i]->Thread.join();
+	}
+	m_Workers.clear();
+}
+
+CNMEAParserData::ERROR_E CNMEAParserEngine::Submit(int nStream, const char *pData, size_t nLen)
+{
+	if ((nStream < 0) || (nStream >= (int)m_Streams.size()) || m_Workers.empty()) {
+		return CNMEAParserData::ERROR_FAIL;
+	}
+
+	if (nLen == 0) {
+		return CNMEAParserData::ERROR_OK;
+	}
+
+	STREAM_T &Stream = *m_Streams[nStream];
+	bool bSchedule;
+	{
+		std::lock_guard<std::mutex> Lock(Stream.Mutex);
+		Stream.Pending.insert(Stream.Pending.end(), pData, pData + nLen);
+		bSchedule = !Stream.bScheduled;
+		Stream.bScheduled = true;
+	}
+
+	//
+	// A stream that is queued or being parsed picks the chunk up by itself
+	//
+	if (bSchedule) {
+		m_nScheduled++;
+		Schedule(nStream);
+	}
+	return CNMEAParserData::ERROR_OK;
+}
+
+void CNMEAParserEngine::Wait(void)
+{
+	std::unique_lock<std::mutex> Lock(m_Mutex);
+	while (m_nScheduled.load() != 0) {
+		m_IdleCondition.wait(Lock);
+	}
+}
+
+void CNMEAParserEngine::Schedule(int nStream)
+{
+	int nWorker = t_nWorker;
+	if ((t_pEngine != this) || (nWorker < 0)) {
+		nWorker = (int)(m_uNextWorker++ % m_Workers.size());
+	}
+
+	WORKER_T &Worker = *m_Workers[nWorker];
+	{
+		std::lock_guard<std::mutex> Lock(Worker.Mutex);
+		Worker.Tasks.push_back(nStream);
+	}
+	m_nQueued++;
+
+	//
+	// A worker counts itself as sleeping before it checks m_nQueued, so either it sees the task or
+	// the task is queued after it counted itself and it is woken up here.
+	//
+	if (m_nSleeping.load() != 0) {
+		{
+			std::lock_guard<std::mutex> Lock(m_Mutex);
+		}
+		m_WakeCondition.notify_one();
+	}
+}
+
+bool CNMEAParserEngine::TakeTask(int nWorker, int &nStream)
+{
+	int nWorkers = (int)m_Workers.size();
+	for (int i = 0; i < nWorkers; i++) {
+		WORKER_T &Worker = *m_Workers[(nWorker + i) % nWorkers];
+		std::lock_guard<std::mutex> Lock(Worker.Mutex);
+		if (Worker.nHead < Worker.Tasks.size()) {
+			nStream = Worker.Tasks[Worker.nHead++];
+			if (Worker.nHead == Worker.Tasks.size()) {
+				Worker.Tasks.clear();
+				Worker.nHead = 0;
+			}
+			m_nQueued--;
+			return true;
+		}
+	}
+	return false;
+}
+
+void CNMEAParserEngine::RunStream(int nStream)
+{
+	STREAM_T &Stream = *m_Streams[nStream];
+
+	{
+		std::lock_guard<std::mutex> Lock(Stream.Mutex);
+		Stream.Work.swap(Stream.Pending);
+	}
+
+	Stream.Parser.ProcessNMEABuffer(Stream.Work.data(), Stream.Work.size());
+	Stream.Work.clear();
+
+	bool bMore;
+	{
+		std::lock_guard<std::mutex> Lock(Stream.Mutex);
+		bMore = !Stream.Pending.empty();
+		Stream.bScheduled = bMore;
+	}
+
+	//
+	// Queue the stream again behind the other tasks instead of looping, so a busy stream does not
+	// starve the others
+	//
+	if (bMore) {
+		Schedule(nStream);
+	}
+	else if (--m_nScheduled == 0) {
+		{
+			std::lock_guard<std::mutex> Lock(m_Mutex);
+		}
+		m_IdleCondition.notify_all();
+	}
+}
+
+void CNMEAParserEngine::WorkerThread(int nWorker)
+{
+	t_pEngine = this;
+	t_nWorker = nWorker;
+
+	for (;;) {
+		int nStream;
+		if (TakeTask(nWorker, nStream)) {
+			RunStream(nStream);
+			continue;
+		}
+
+		std::unique_lock<std::mutex> Lock(m_Mutex);
+		m_nSleeping++;
+		while (!m_bStop && (m_nQueued.load() == 0)) {
+			m_WakeCondition.wait(Lock);
+		}
+		m_nSleeping--;
+		if (m_bStop && (m_nQueued.load() == 0)) {
+			break;
+		}
+	}
+
+	t_pEngine = NULL;
+	t_nWorker = -1;
+}
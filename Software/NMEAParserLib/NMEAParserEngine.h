@@ -0,0 +1,152 @@
+/*
+* MIT License
+*
+*  Copyright (c) 2018 VisualGPS, LLC
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this software and associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright notice and this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*
+*/
+#pragma once
+#include <cstddef>
+#include <stdint.h>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "NMEAParserData.h"
+#include "NMEAParser.h"
+#include "NMEAParserStream.h"
+
+///
+/// \class CNMEAParserEngine
+/// \brief Parses many NMEA streams on a fixed pool of worker threads.
+///
+/// The engine owns one CNMEAParser per stream. Byte chunks are submitted with Submit() from any
+/// thread and tagged with the ID of their stream. A stream that has data waiting is a task. Each worker
+/// has its own task queue and takes its tasks in order; a worker whose queue is empty steals a task from
+/// another worker before it goes to sleep. A stream is never queued twice, so only one worker parses it
+/// at a time and its chunks are parsed in the order they were submitted. Different streams are parsed in
+/// parallel, so the throughput grows with the number of workers as long as there are more busy streams
+/// than workers.
+///
+/// Submit() copies the chunk into a per-stream buffer. A worker takes everything that is waiting for a
+/// stream in one go, parses it in zero-copy mode and hands the buffer back for reuse, so a stream does not
+/// allocate once its buffers have grown to the size of its bursts.
+///
+class CNMEAParserEngine
+{
+private:
+	struct STREAM_T;
+	struct WORKER_T;
+
+	std::vector<std::unique_ptr<STREAM_T> >	m_Streams;						///< Streams, indexed by stream ID
+	std::vector<std::unique_ptr<WORKER_T> >	m_Workers;						///< Worker threads and their task queues, empty while stopped
+	std::atomic<int>				m_nQueued;									///< Tasks in the worker queues
+	std::atomic<int>				m_nSleeping;								///< Workers waiting for a task
+	std::atomic<int>				m_nScheduled;								///< Streams that are queued or being parsed
+	std::atomic<unsigned>			m_uNextWorker;								///< Round robin queue for tasks submitted by other threads
+	bool							m_bStop;									///< Workers exit once the queues are empty, protected by m_Mutex
+	std::mutex						m_Mutex;									///< Protects m_bStop and the condition variables
+	std::condition_variable			m_WakeCondition;							///< Signalled when a task is queued or the engine stops
+	std::condition_variable			m_IdleCondition;							///< Signalled when m_nScheduled drops to zero
+
+public:
+	CNMEAParserEngine();
+	~CNMEAParserEngine();
+
+	///
+	/// \brief Adds a stream. Streams can only be added while the engine is stopped.
+	///
+	/// \param pSink Receives the decoded sentences of the stream. It must outlive the engine.
+	/// \return The stream ID, or -1 if the engine is running or pSink is NULL. IDs count up from zero.
+	///
+	int AddStream(CNMEAParserStreamSink *pSink);
+
+	///
+	/// \brief Returns the parser of a stream, or NULL if nStream is not a valid stream ID.
+	///
+	/// Its GetXXX() methods may be called from any thread. Configure it (SetEpochAssembly(),
+	/// GetRegistry() and so on) while the engine is stopped.
+	///
+	CNMEAParser *GetParser(int nStream);
+
+	///
+	/// \brief Returns the number of streams
+	///
+	int GetStreamCount(void) const { return (int)m_Streams.size(); }
+
+	///
+	/// \brief Returns the number of worker threads, 0 while the engine is stopped
+	///
+	int GetWorkerCount(void) const { return (int)m_Workers.size(); }
+
+	///
+	/// \brief Starts the worker threads
+	///
+	/// \param nWorkers Number of worker threads, 0 for one per hardware thread
+	/// \return CNMEAParserData::ERROR_OK if successful, ERROR_FAIL if the engine is already running
+	///
+	CNMEAParserData::ERROR_E Start(int nWorkers = 0);
+
+	///
+	/// \brief Parses the data that was already submitted, then stops the worker threads.
+	///
+	/// Do not call Submit() while Stop() runs.
+	///
+	void Stop(void);
+
+	///
+	/// \brief Queues a chunk of bytes for a stream. Safe to call from any thread, including from a sink.
+	///
+	/// \param nStream Stream ID
+	/// \param pData Bytes received from the stream. They are copied before the call returns.
+	/// \param nLen Number of bytes in pData
+	/// \return CNMEAParserData::ERROR_OK if successful, ERROR_FAIL if nStream is not valid or the engine is stopped
+	///
+	CNMEAParserData::ERROR_E Submit(int nStream, const char *pData, size_t nLen);
+
+	///
+	/// \brief Blocks until every chunk submitted so far is parsed. Must not be called from a sink.
+	///
+	void Wait(void);
+
+private:
+	///
+	/// \brief Queues the task of a stream, on the calling worker's queue if called from a worker
+	///
+	void Schedule(int nStream);
+
+	///
+	/// \brief Takes a task from the queue of nWorker, or steals one from another worker if it is empty
+	///
+	bool TakeTask(int nWorker, int &nStream);
+
+	///
+	/// \brief Parses the waiting data of a stream and queues it again if more arrived meanwhile
+	///
+	void RunStream(int nStream);
+
+	///
+	/// \brief Main loop of a worker thread
+	///
+	void WorkerThread(int nWorker);
+};
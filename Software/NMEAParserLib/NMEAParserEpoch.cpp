@@ -0,0 +1,287 @@
+/*
+* MIT License
+*
+*  Copyright (c) 2018 VisualGPS, LLC
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this software and associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright notice and this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*
+*/
+#include <string.h>
+#include "NMEAParserEpoch.h"
+#include "NMEAParserFields.h"
+#include "NMEAParserNumber.h"
+#include "NMEAParserSatellites.h"
+
+CNMEAParserEpoch::CNMEAParserEpoch()
+{
+	ResetData();
+}
+
+CNMEAParserEpoch::~CNMEAParserEpoch()
+{
+}
+
+bool CNMEAParserEpoch::StartSentence(const CNMEAParserRegistry::SLOT_T &Slot, const CNMEAParserData::SENTENCE_VIEW_T &Sentence)
+{
+	bool bClosed = false;
+
+	//
+	// GGA and RMC carry the UTC time of the epoch in their first field
+	//
+	int32_t nTime = -1;
+	int nHour = 0;
+	int nMinute = 0;
+	double dSecond = 0.0;
+	if (Slot.nSentence == CNMEAParserData::SID_GGA || Slot.nSentence == CNMEAParserData::SID_RMC) {
+		CNMEAParserFields Fields(Sentence);
+		CNMEAParserData::FIELD_VIEW_T Field;
+		if (Fields.GetField(0, Field) == CNMEAParserData::ERROR_OK &&
+			CNMEAParserNumber::ParseTime(Field, nHour, nMinute, dSecond) == CNMEAParserData::ERROR_OK) {
+			nTime = (nHour * 3600 + nMinute * 60) * 1000 + (int32_t)(dSecond * 1000.0 + 0.5);
+		}
+	}
+
+	//
+	// The sentence after an early close must start the next epoch. If it does not, the learned
+	// last sentence is wrong and the assembler stops closing early for good.
+	//
+	if (m_bClosedEarly) {
+		m_bClosedEarly = false;
+		if (nTime < 0 || nTime == m_nClosedTime) {
+			m_nEndSlot = -1;
+			m_bLearn = false;
+		}
+	}
+
+	if (nTime >= 0) {
+		if (m_bOpen && m_bTimed && nTime != m_nTime) {
+			if (m_bLearn && m_nLastSlot >= 0 && m_nLastSlot == m_nCandidateSlot) {
+				m_nEndSlot = m_nLastSlot;
+			}
+			m_nCandidateSlot = m_nLastSlot;
+			Close();
+			bClosed = true;
+		}
+		if (m_bTimed == false) {
+			m_bTimed = true;
+			m_nTime = nTime;
+			m_Epoch.m_nHour = nHour;
+			m_Epoch.m_nMinute = nMinute;
+			m_Epoch.m_dSecond = dSecond;
+		}
+	}
+	m_bOpen = true;
+
+	return bClosed;
+}
+
+bool CNMEAParserEpoch::EndSentence(const CNMEAParserRegistry::SLOT_T &Slot, int nSlot)
+{
+	//
+	// A sentence received more than once in an epoch (ie: one GNGSA per constellation) cannot
+	// tell where the epoch ends
+	//
+	m_nLastSlot = -1;
+	if (Merge(Slot)) {
+		uint64_t u64Bit = (uint64_t)1 << nSlot;
+		if ((m_u64Slots & u64Bit) == 0) {
+			m_u64Slots |= u64Bit;
+			m_nLastSlot = nSlot;
+		}
+	}
+
+	if (m_nEndSlot >= 0 && m_nLastSlot == m_nEndSlot) {
+		Close();
+		m_bClosedEarly = true;
+		return true;
+	}
+
+	return false;
+}
+
+void CNMEAParserEpoch::ResetData(void)
+{
+	Clear();
+	m_nClosedTime = -1;
+	m_nCandidateSlot = -1;
+	m_nEndSlot = -1;
+	m_bClosedEarly = false;
+	m_bLearn = true;
+
+	m_Snapshot.Publish(m_Epoch);
+}
+
+void CNMEAParserEpoch::Close(void)
+{
+	m_Snapshot.Publish(m_Epoch);
+	m_nClosedTime = m_bTimed ? m_nTime : -1;
+	Clear();
+}
+
+void CNMEAParserEpoch::Clear(void)
+{
+	memset(&m_Epoch, 0, sizeof(m_Epoch));
+	m_Epoch.m_nGPSQuality = CNMEAParserData::GQ_FIX_NOT_AVAILABLE;
+	m_Epoch.m_nStatus = CNMEAParserData::RMC_STATUS_VOID;
+	m_Epoch.m_nMode = CNMEAParserData::ASM_FIX_NOT_AVAILABLE;
+	m_bOpen = false;
+	m_bTimed = false;
+	m_nTime = -1;
+	m_nLastSlot = -1;
+	m_u64Slots = 0;
+}
+
+bool CNMEAParserEpoch::Merge(const CNMEAParserRegistry::SLOT_T &Slot)
+{
+	bool bEnd = true;
+
+	switch (Slot.nSentence) {
+#if NMEAPARSER_ENABLE_GGA
+	case CNMEAParserData::SID_GGA: {
+		CNMEAParserLease<CNMEAParserData::GGA_DATA_T> Data = static_cast<const CNMEASentenceGGA *>(Slot.pSentence)->LeaseSentenceData();
+		if (Data.IsValid()) {
+			m_Epoch.uSources |= CNMEAParserData::EPOCH_GGA;
+			m_Epoch.m_dLatitude = Data->m_dLatitude;
+			m_Epoch.m_dLongitude = Data->m_dLongitude;
+			m_Epoch.m_n64Latitude = Data->m_n64Latitude;
+			m_Epoch.m_n64Longitude = Data->m_n64Longitude;
+			m_Epoch.m_dAltitudeMSL = Data->m_dAltitudeMSL;
+			m_Epoch.m_dGeoidalSep = Data->m_dGeoidalSep;
+			m_Epoch.m_nGPSQuality = Data->m_nGPSQuality;
+			m_Epoch.m_nSatsInUse = Data->m_nSatsInView;
+			m_Epoch.m_dVertSpeed = Data->m_dVertSpeed;
+			if ((m_Epoch.uSources & CNMEAParserData::EPOCH_GSA) == 0) {
+				m_Epoch.m_dHDOP = Data->m_dHDOP;
+			}
+		}
+		break;
+	}
+#endif
+#if NMEAPARSER_ENABLE_RMC
+	case CNMEAParserData::SID_RMC: {
+		CNMEAParserLease<CNMEAParserData::RMC_DATA_T> Data = static_cast<const CNMEASentenceRMC *>(Slot.pSentence)->LeaseSentenceData();
+		if (Data.IsValid()) {
+			m_Epoch.uSources |= CNMEAParserData::EPOCH_RMC;
+			m_Epoch.m_nDay = Data->m_nDay;
+			m_Epoch.m_nMonth = Data->m_nMonth;
+			m_Epoch.m_nYear = Data->m_nYear;
+			m_Epoch.m_nStatus = Data->m_nStatus;
+			m_Epoch.m_dSpeedKnots = Data->m_dSpeedKnots;
+			m_Epoch.m_dTrackAngle = Data->m_dTrackAngle;
+			m_Epoch.m_dMagneticVariation = Data->m_dMagneticVariation;
+			if ((m_Epoch.uSources & CNMEAParserData::EPOCH_GGA) == 0) {
+				m_Epoch.m_dLatitude = Data->m_dLatitude;
+				m_Epoch.m_dLongitude = Data->m_dLongitude;
+				m_Epoch.m_n64Latitude = Data->m_n64Latitude;
+				m_Epoch.m_n64Longitude = Data->m_n64Longitude;
+			}
+		}
+		break;
+	}
+#endif
+#if NMEAPARSER_ENABLE_GSA
+	case CNMEAParserData::SID_GSA: {
+		CNMEAParserLease<CNMEAParserData::GSA_DATA_T> Data = static_cast<const CNMEASentenceGSA *>(Slot.pSentence)->LeaseSentenceData();
+		if (Data.IsValid()) {
+			m_Epoch.uSources |= CNMEAParserData::EPOCH_GSA;
+			m_Epoch.m_nMode = Data->nMode;
+			m_Epoch.m_dPDOP = Data->dPDOP;
+			m_Epoch.m_dHDOP = Data->dHDOP;
+			m_Epoch.m_dVDOP = Data->dVDOP;
+			MergeUsed(Slot.nTalker, *Data);
+		}
+		break;
+	}
+#endif
+#if NMEAPARSER_ENABLE_GSV
+	case CNMEAParserData::SID_GSV: {
+		CNMEAParserLease<CNMEASentenceGSV::STORE_T> Data = static_cast<const CNMEASentenceGSV *>(Slot.pSentence)->LeaseSentenceData();
+		if (Data.IsValid()) {
+			m_Epoch.uSources |= CNMEAParserData::EPOCH_GSV;
+			bEnd = MergeVisible(Slot.nTalker, *Data);
+		}
+		break;
+	}
+#endif
+	default:
+		break;
+	}
+
+	return bEnd;
+}
+
+void CNMEAParserEpoch::MergeUsed(CNMEAParserData::TALKER_ID_E nTalker, const CNMEAParserData::GSA_DATA_T &Data)
+{
+	// The GSA decoder keeps every satellite of the epoch, so the list of the talker is replaced
+	int nCount = 0;
+	for (int i = 0; i < m_Epoch.m_nUsedCount; i++) {
+		if (m_Epoch.m_pUsed[i].u16Talker != (uint16_t)nTalker) {
+			m_Epoch.m_pUsed[nCount++] = m_Epoch.m_pUsed[i];
+		}
+	}
+
+	for (int i = 0; i < CNMEAParserData::c_nMaxConstellation && nCount < CNMEAParserData::c_nMaxEpochSatellites; i++) {
+		if (Data.pnPRN[i] != CNMEAParserData::c_nInvlidPRN) {
+			m_Epoch.m_pUsed[nCount].u16Talker = (uint16_t)nTalker;
+			m_Epoch.m_pUsed[nCount].u16PRN = (uint16_t)Data.pnPRN[i];
+			nCount++;
+		}
+	}
+	m_Epoch.m_nUsedCount = nCount;
+}
+
+bool CNMEAParserEpoch::MergeVisible(CNMEAParserData::TALKER_ID_E nTalker, const CNMEAParserData::GSV_DATA_T &Data)
+{
+	int nCount = RemoveVisible(nTalker);
+	for (int i = 0; i < CNMEAParserData::c_nMaxConstellation && nCount < CNMEAParserData::c_nMaxEpochSatellites; i++) {
+		if (Data.SatInfo[i].nPRN != CNMEAParserData::c_nInvlidPRN) {
+			m_Epoch.m_pVisible[nCount].u16Talker = (uint16_t)nTalker;
+			CNMEAParserSatellites::ToCompact(Data.SatInfo[i], m_Epoch.m_pVisible[nCount].Sat);
+			nCount++;
+		}
+	}
+	m_Epoch.m_nVisibleCount = nCount;
+	return Data.nSentenceNumber == Data.nTotalNumberOfSentences;
+}
+
+bool CNMEAParserEpoch::MergeVisible(CNMEAParserData::TALKER_ID_E nTalker, const CNMEAParserData::GSV_COMPACT_T &Data)
+{
+	int nCount = RemoveVisible(nTalker);
+	for (int i = 0; i < CNMEAParserData::c_nMaxConstellation && nCount < CNMEAParserData::c_nMaxEpochSatellites; i++) {
+		if (Data.SatInfo[i].u16PRN != CNMEAParserData::c_nInvlidPRN) {
+			m_Epoch.m_pVisible[nCount].u16Talker = (uint16_t)nTalker;
+			m_Epoch.m_pVisible[nCount].Sat = Data.SatInfo[i];
+			nCount++;
+		}
+	}
+	m_Epoch.m_nVisibleCount = nCount;
+	return Data.u8SentenceNumber == Data.u8TotalNumberOfSentences;
+}
+
+int CNMEAParserEpoch::RemoveVisible(CNMEAParserData::TALKER_ID_E nTalker)
+{
+	// The GSV decoder keeps every satellite of the talker, so its list is replaced on each part
+	int nCount = 0;
+	for (int i = 0; i < m_Epoch.m_nVisibleCount; i++) {
+		if (m_Epoch.m_pVisible[i].u16Talker != (uint16_t)nTalker) {
+			m_Epoch.m_pVisible[nCount++] = m_Epoch.m_pVisible[i];
+		}
+	}
+	return nCount;
+}
@@ -0,0 +1,144 @@
+/*
+* MIT License
+*
+*  Copyright (c) 2018 VisualGPS, LLC
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this software and associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright notice and this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*
+*/
+#pragma once
+#include <cstddef>
+#include <stdint.h>
+
+#include "NMEAParserData.h"
+#include "NMEAParserRegistry.h"
+#include "NMEAParserSnapshot.h"
+
+///
+/// \class CNMEAParserEpoch
+/// \brief Groups the sentences of one fix into a single EPOCH_DATA_T record.
+///
+/// GGA and RMC sentences carry the UTC time of the fix, GSA and GSV do not and belong to the epoch
+/// of the time tagged sentence before them. An epoch therefore closes when a sentence with another
+/// UTC time arrives. This assumes that the receiver starts each epoch with a GGA or RMC sentence,
+/// which is what receivers do.
+///
+/// Waiting for the next epoch delays every record by one fix. To avoid that, the assembler learns
+/// which sentence ends an epoch: once the same sentence (the last part for GSV) was the last one of
+/// two epochs in a row, and was received only once in them, an epoch closes as soon as that
+/// sentence is received. If the receiver
+/// changes its output and a sentence follows the learned one in the same epoch, the assembler goes
+/// back to closing on the time change for good.
+///
+/// CNMEAParserDispatcher feeds this with every decoded sentence, see SetEpochAssembly().
+///
+class CNMEAParserEpoch
+{
+private:
+	CNMEAParserData::EPOCH_DATA_T		m_Epoch;								///< Epoch being assembled
+	CNMEAParserSnapshot<CNMEAParserData::EPOCH_DATA_T>	m_Snapshot;		///< Last closed epoch, published for readers
+	bool								m_bOpen;								///< m_Epoch holds at least one sentence
+	bool								m_bTimed;								///< m_Epoch has a UTC time
+	int32_t								m_nTime;								///< UTC time of m_Epoch in ms since midnight
+	int32_t								m_nClosedTime;							///< UTC time of the last closed epoch, -1 if none
+	int									m_nLastSlot;							///< Slot of the last sentence in m_Epoch, -1 for a GSV that is not the last part or a repeated sentence
+	uint64_t							m_u64Slots;								///< Slots received in m_Epoch, one bit per slot (the last part for GSV). There are at most 48 slots
+	int									m_nCandidateSlot;						///< Slot that ended the last epoch closed on a time change
+	int									m_nEndSlot;								///< Learned slot that ends an epoch, -1 if none
+	bool								m_bClosedEarly;							///< The last epoch was closed by m_nEndSlot
+	bool								m_bLearn;								///< Learning m_nEndSlot is allowed, cleared after a wrong guess
+
+public:
+	CNMEAParserEpoch();
+	~CNMEAParserEpoch();
+
+	///
+	/// \brief Checks the UTC time of a sentence before it is decoded. Call it from the parsing thread.
+	///
+	/// \param Slot Slot of the sentence, see CNMEAParserRegistry
+	/// \param Sentence The sentence
+	/// \return true if the sentence starts a new epoch and closed the previous one. The closed epoch
+	/// is then available from LeaseEpochData().
+	///
+	bool StartSentence(const CNMEAParserRegistry::SLOT_T &Slot, const CNMEAParserData::SENTENCE_VIEW_T &Sentence);
+
+	///
+	/// \brief Adds the data of a sentence after it is decoded. Call it after StartSentence().
+	///
+	/// \param Slot Slot of the sentence, see CNMEAParserRegistry
+	/// \param nSlot Index of the slot
+	/// \return true if the sentence is the learned last sentence and closed the epoch. The closed
+	/// epoch is then available from LeaseEpochData().
+	///
+	bool EndSentence(const CNMEAParserRegistry::SLOT_T &Slot, int nSlot);
+
+	///
+	/// \brief Drops the epoch being assembled, clears the last closed epoch and forgets the learned last sentence.
+	///
+	void ResetData(void);
+
+	///
+	/// \brief Returns a copy of the last closed epoch. Safe to call from any thread.
+	///
+	CNMEAParserData::EPOCH_DATA_T GetEpochData(void) const { return m_Snapshot.Read(); }
+
+	///
+	/// \brief Returns a lease on the last closed epoch, see CNMEAParserLease. Safe to call from any thread.
+	///
+	CNMEAParserLease<CNMEAParserData::EPOCH_DATA_T> LeaseEpochData(void) const { return m_Snapshot.Lease(); }
+
+	///
+	/// \brief Returns the update sequence number. It increases every time an epoch closes or the data is reset and is never reset.
+	///
+	uint32_t GetUpdateSequence(void) const { return m_Snapshot.GetUpdateSequence(); }
+
+private:
+	///
+	/// \brief Publishes m_Epoch and starts a new one
+	///
+	void Close(void);
+
+	///
+	/// \brief Clears m_Epoch
+	///
+	void Clear(void);
+
+	///
+	/// \brief Copies the data of a decoder into m_Epoch
+	/// \return false for a GSV sentence that is not the last of its group, true otherwise
+	///
+	bool Merge(const CNMEAParserRegistry::SLOT_T &Slot);
+
+	///
+	/// \brief Replaces the used satellites of a talker
+	///
+	void MergeUsed(CNMEAParserData::TALKER_ID_E nTalker, const CNMEAParserData::GSA_DATA_T &Data);
+
+	///
+	/// \brief Replaces the visible satellites of a talker
+	/// \return true if Data is from the last sentence of its group
+	///
+	bool MergeVisible(CNMEAParserData::TALKER_ID_E nTalker, const CNMEAParserData::GSV_DATA_T &Data);
+	bool MergeVisible(CNMEAParserData::TALKER_ID_E nTalker, const CNMEAParserData::GSV_COMPACT_T &Data);
+
+	///
+	/// \brief Removes the visible satellites of a talker and returns the new count
+	///
+	int RemoveVisible(CNMEAParserData::TALKER_ID_E nTalker);
+};
@@ -0,0 +1,76 @@
+/*
+* MIT License
+*
+*  Copyright (c) 2018 VisualGPS, LLC
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this software and associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright notice and this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*
+*/
+#include "NMEAParserFields.h"
+#include "NMEAParserScan.h"
+
+CNMEAParserFields::CNMEAParserFields() :
+	m_pData(""),
+	m_nCount(0)
+{
+}
+
+CNMEAParserFields::CNMEAParserFields(const CNMEAParserData::SENTENCE_VIEW_T &Sentence)
+{
+	Tokenize(Sentence.pData, Sentence.nDataLen);
+}
+
+void CNMEAParserFields::Tokenize(const char *pData, size_t nDataLen)
+{
+	m_pData = pData;
+	m_nCount = 0;
+
+	if (pData == NULL) {
+		m_pData = "";
+		return;
+	}
+
+	//
+	// The data ends at the checksum flag or a NUL
+	//
+	if (nDataLen > 0xFFFF) {
+		nDataLen = 0xFFFF;
+	}
+	nDataLen = CNMEAParserScan::FindChar2(pData, nDataLen, '*', '\0');
+
+	//
+	// Field n ends at comma n. The last field ends at the end of the data.
+	//
+	uint16_t pu16Commas[c_nMaxFields];
+	int nCommas = CNMEAParserScan::FindAll(pData, nDataLen, ',', pu16Commas, c_nMaxFields);
+
+	uint16_t u16Start = 0;
+	for (int i = 0; i < nCommas; i++) {
+		m_pu16Start[i] = u16Start;
+		m_pu16Len[i] = pu16Commas[i] - u16Start;
+		u16Start = pu16Commas[i] + 1;
+	}
+	m_nCount = nCommas;
+
+	if (nCommas < c_nMaxFields) {
+		m_pu16Start[nCommas] = u16Start;
+		m_pu16Len[nCommas] = (uint16_t)(nDataLen - u16Start);
+		m_nCount++;
+	}
+}
@@ -0,0 +1,90 @@
+/*
+* MIT License
+*
+*  Copyright (c) 2018 VisualGPS, LLC
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this software and associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright notice and this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*
+*/
+
+#pragma once
+#include <cstddef>
+#include <stdint.h>
+#include "NMEAParserData.h"
+
+///
+/// \class CNMEAParserFields
+/// \brief Splits the data of an NMEA sentence into fields in a single pass.
+///
+/// Tokenize() records the offset and length of every comma separated field, so a sentence
+/// decoder can fetch any field without rescanning the sentence or copying it. Commas are located
+/// with the CNMEAParserScan block routines. A '*' or NUL ends the data.
+///
+class CNMEAParserFields
+{
+public:
+	static const int				c_nMaxFields = 40;							///< Maximum number of fields kept. Fields past this are ignored.
+
+private:
+	const char *					m_pData;									///< Sentence data
+	int								m_nCount;									///< Number of fields found
+	uint16_t						m_pu16Start[c_nMaxFields];					///< Offset of each field in m_pData
+	uint16_t						m_pu16Len[c_nMaxFields];					///< Length of each field
+
+public:
+	CNMEAParserFields();
+
+	///
+	/// \brief Tokenizes the data of Sentence. See Tokenize().
+	///
+	explicit CNMEAParserFields(const CNMEAParserData::SENTENCE_VIEW_T &Sentence);
+
+	///
+	/// \brief Records the position of every field in pData.
+	///
+	/// pData must stay valid for as long as fields are fetched from this object.
+	///
+	/// \param pData Comma separated sentence data, does not need to be NUL terminated
+	/// \param nDataLen Number of characters in pData
+	///
+	void Tokenize(const char *pData, size_t nDataLen);
+
+	///
+	/// \brief Returns the number of fields, including empty ones
+	///
+	int GetCount(void) const { return m_nCount; }
+
+	///
+	/// \brief Gets a field.
+	///
+	/// \param nField Zero based field number
+	/// \param Field Receives the field. Set to an empty field on failure.
+	/// \return ERROR_OK if the field exists and is not empty, ERROR_FAIL otherwise.
+	///
+	CNMEAParserData::ERROR_E GetField(int nField, CNMEAParserData::FIELD_VIEW_T &Field) const {
+		if (nField < 0 || nField >= m_nCount || m_pu16Len[nField] == 0) {
+			Field.pField = "";
+			Field.nLen = 0;
+			return CNMEAParserData::ERROR_FAIL;
+		}
+		Field.pField = &m_pData[m_pu16Start[nField]];
+		Field.nLen = m_pu16Len[nField];
+		return CNMEAParserData::ERROR_OK;
+	}
+};
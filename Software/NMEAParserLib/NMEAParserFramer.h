@@ -0,0 +1,613 @@
+/*
+* MIT License
+*
+*  Copyright (c) 2018 VisualGPS, LLC
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this software and associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright notice and this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*
+*/
+
+#pragma once
+#include <cstddef>
+#include <stdint.h>
+#include <string.h>
+#include "NMEAParserClock.h"
+#include "NMEAParserData.h"
+#include "NMEAParserLatency.h"
+#include "NMEAParserScan.h"
+#include "NMEAParserTag.h"
+#include "NMEAParserTrace.h"
+
+///
+/// \class CNMEAParserFramer
+/// \brief Statically dispatched NMEA packet framer.
+///
+/// This is the state machine of CNMEAParserPacket with its hooks resolved at compile time.
+/// TDerived is the class deriving from CNMEAParserFramer<TDerived>. The framer calls these
+/// methods of TDerived, which may hide the defaults below:
+///
+/// - CNMEAParserData::ERROR_E ProcessRxCommand(char *pCmd, char *pData) (required)
+/// - CNMEAParserData::ERROR_E ProcessRxSentence(const CNMEAParserData::SENTENCE_VIEW_T &Sentence)
+/// - void TimeTag(void)
+/// - void OnError(CNMEAParserData::ERROR_E nError, char *pCmd)
+///
+/// They are called non-virtually and can be inlined. They must be public, or TDerived must
+/// make CNMEAParserFramer<TDerived> a friend. See CNMEAParserPacket for the state machine and the
+/// meaning of each hook; CNMEAParserPacket itself is a CNMEAParserFramer whose hooks are virtual.
+///
+template <class TDerived>
+class CNMEAParserFramer {
+
+private:
+
+	enum PARSE_STATE {
+		PARSE_STATE_SOM = 0,													///< Search for start of message
+		PARSE_STATE_CMD,														///< Get command
+		PARSE_STATE_DATA,														///< Get data
+		PARSE_STATE_CHECKSUM_1,													///< Get first checksum character
+		PARSE_STATE_CHECKSUM_2,													///< get second checksum character
+		PARSE_STATE_TAG,														///< Get tag block
+	};
+
+
+private:
+	PARSE_STATE						m_nState;									///< Current NMEA parse state
+	uint8_t							m_u8Checksum;								///< Calculated NMEA sentence checksum
+	uint8_t							m_u8ReceivedChecksum;						///< Received NMEA sentence checksum (if exists)
+	uint16_t						m_nIndex;									///< Index used for command and data
+	uint16_t						m_nCmdLen;									///< Length of the current NMEA command
+	char							m_pCommand[CNMEAParserData::c_uMaxCmdLen];	///< NMEA command
+	char							m_pData[CNMEAParserData::c_uMaxDataLen];	///< NMEA data
+	bool							m_bZeroCopy;								///< Pass complete in-buffer sentences to ProcessRxSentence() without copying
+	bool							m_bTimestamps;								///< Time stamp every sentence, see SetTimestamps()
+	uint64_t						m_u64Timestamp;								///< Time stamp of the current sentence
+	CNMEAParserLatency *			m_pLatency;									///< Optional latency histogram, NULL if none
+	uint16_t						m_nTagLen;									///< Number of tag block characters collected in m_Tag.pBlock
+	bool							m_bTagPending;								///< m_Tag holds a valid tag block for the next sentence
+	const CNMEAParserData::TAG_BLOCK_T *	m_pSentenceTag;						///< Tag block of the current sentence, NULL if none
+	CNMEAParserData::TAG_BLOCK_T	m_Tag;										///< Last tag block
+
+protected:
+	CNMEAParserTrace *				m_pTrace;									///< Optional event trace, NULL if not tracing
+
+public:
+	CNMEAParserFramer() :
+		m_nState(PARSE_STATE_SOM),
+		m_u8Checksum(0),
+		m_u8ReceivedChecksum(0),
+		m_nIndex(0),
+		m_nCmdLen(0),
+		m_bZeroCopy(false),
+		m_bTimestamps(false),
+		m_u64Timestamp(0),
+		m_pLatency(NULL),
+		m_nTagLen(0),
+		m_bTagPending(false),
+		m_pSentenceTag(NULL),
+		m_pTrace(NULL)
+	{
+		Reset();
+	}
+
+	///
+	/// \brief Parses pData for NMEA data.
+	///
+	/// This method will parse pData for NMEA data.
+	/// 
+	/// \param pData Pointer to buffer to parse
+	/// \param nBufferSize Number of bytes in pData to process.
+	/// \return CNMEAParserData::ERROR_E, if successful, ERROR_OK is returned.
+	///
+	CNMEAParserData::ERROR_E ProcessNMEABuffer(const char *pData, size_t nBufferSize);
+
+	///
+	/// \brief Enables or disables zero-copy mode.
+	///
+	/// In zero-copy mode, valid sentences are passed to ProcessRxSentence() instead of ProcessRxCommand().
+	/// A sentence that is completely contained in the buffer passed to ProcessNMEABuffer() is handed over
+	/// as a view into that buffer. Only sentences that straddle two calls are copied into the internal
+	/// command/data buffers. Zero-copy mode is disabled by default.
+	///
+	/// \param bEnable true to enable zero-copy mode
+	///
+	void SetZeroCopy(bool bEnable) { m_bZeroCopy = bEnable; }
+
+	///
+	/// \brief Enables or disables sentence time stamps.
+	///
+	/// With time stamps, the framer reads CNMEAParserClock::Now() when it receives the '$' of a sentence.
+	/// The time stamp is passed in CNMEAParserData::SENTENCE_VIEW_T::u64Timestamp and returned by
+	/// GetTimestamp(), so ProcessRxSentence() and ProcessRxCommand() know when their sentence arrived
+	/// without redefining TimeTag(). Time stamps are disabled by default.
+	///
+	/// \param bEnable true to time stamp every sentence
+	///
+	void SetTimestamps(bool bEnable) { m_bTimestamps = bEnable; }
+
+	///
+	/// \brief Returns true if sentence time stamps are enabled. See SetTimestamps().
+	///
+	bool GetTimestamps(void) const { return m_bTimestamps; }
+
+	///
+	/// \brief Returns the time stamp of the current sentence, see SetTimestamps().
+	///
+	/// During ProcessRxCommand() and ProcessRxSentence() this is the time at which the '$' of their sentence
+	/// was received, in CNMEAParserClock nanoseconds. It is 0 when time stamps are disabled.
+	///
+	uint64_t GetTimestamp(void) const { return m_u64Timestamp; }
+
+	///
+	/// \brief Attaches a latency histogram to the parser.
+	///
+	/// The time from the '$' of each valid sentence until ProcessRxSentence() or ProcessRxCommand() returns
+	/// is added to pLatency. Sentences are time stamped while a histogram is attached, even if
+	/// SetTimestamps() is off. The histogram must outlive the parser or be detached first.
+	///
+	/// \param pLatency Histogram or NULL to stop measuring.
+	///
+	void SetLatencyHistogram(CNMEAParserLatency *pLatency) { m_pLatency = pLatency; }
+
+	///
+	/// \brief Returns the attached latency histogram or NULL.
+	///
+	CNMEAParserLatency *GetLatencyHistogram(void) const { return m_pLatency; }
+
+	///
+	/// \brief Returns the tag block of the current sentence, or NULL if it has none.
+	///
+	/// An IEC 61162-450 tag block (\\s:GP0001,c:1577836800*2B\\) right in front of the '$' of a sentence is
+	/// checked and decoded while the framer searches for the '$', see CNMEAParserTag. During
+	/// ProcessRxCommand() and ProcessRxSentence() this returns it; it is also passed in
+	/// CNMEAParserData::SENTENCE_VIEW_T::pTag. A tag block with a bad checksum is reported to OnError()
+	/// as ERROR_TAG_BLOCK and its sentence is passed on without it.
+	///
+	const CNMEAParserData::TAG_BLOCK_T *GetTagBlock(void) const { return m_pSentenceTag; }
+
+	///
+	/// \brief Returns true if a sentence has started and continues in the next buffer passed to ProcessNMEABuffer().
+	///
+	/// An unfinished tag block does not count, see GetTagBlock().
+	///
+	bool IsInSentence(void) const { return (m_nState != PARSE_STATE_SOM) && (m_nState != PARSE_STATE_TAG); }
+
+	///
+	/// \brief Returns true if zero-copy mode is enabled. See SetZeroCopy().
+	///
+	bool GetZeroCopy(void) const { return m_bZeroCopy; }
+
+	///
+	/// \brief Attaches an event trace to the parser.
+	///
+	/// Parser errors and decoded/unknown sentences are recorded into pTrace. The trace object must
+	/// outlive the parser or be detached first. Tracing is only compiled in when the library is built
+	/// with NMEAPARSER_TRACE (cmake -DNMEAPARSER_ENABLE_TRACE=ON); otherwise this call has no effect.
+	///
+	/// \param pTrace Trace object or NULL to stop tracing.
+	///
+	void SetTrace(CNMEAParserTrace *pTrace) { m_pTrace = pTrace; }
+
+	///
+	/// \brief Returns the attached trace object or NULL.
+	///
+	CNMEAParserTrace *GetTrace(void) const { return m_pTrace; }
+
+	///
+	/// \brief Reset the parser.
+	///
+	/// A reset will restart the parser to start to look for the start of message.
+	///
+	void Reset(void);
+
+	///
+	/// \brief Default error hook, does nothing.
+	///
+	void OnError(CNMEAParserData::ERROR_E nError, char *pCmd) { UNUSED_PARAM(nError); UNUSED_PARAM(pCmd); }
+
+protected:
+	///
+	/// \brief Default zero-copy hook. Copies the sentence into the internal command/data buffers and calls ProcessRxCommand().
+	///
+	CNMEAParserData::ERROR_E ProcessRxSentence(const CNMEAParserData::SENTENCE_VIEW_T &Sentence);
+
+	///
+	/// \brief Default start of message hook, does nothing. See SetTimestamps() for a ready made time stamp.
+	///
+	void TimeTag(void) {}
+
+private:
+	///
+	/// \brief Returns this object as the derived class
+	///
+	TDerived &Derived(void) { return *static_cast<TDerived *>(this); }
+
+	///
+	/// \brief Passes a valid sentence to ProcessRxSentence() or ProcessRxCommand().
+	///
+	/// \param pCmdInBuffer Command in the caller's buffer, or NULL if the sentence is in the internal buffers
+	/// \param pDataInBuffer Data in the caller's buffer, or NULL if the sentence is in the internal buffers
+	///
+	void ProcessSentence(const char *pCmdInBuffer, const char *pDataInBuffer);
+
+	///
+	/// \brief Copies nCmdLen characters from pCmd into the command buffer and terminates it.
+	///
+	void CopyCommand(const char *pCmd, size_t nCmdLen);
+
+	///
+	/// \brief Reports a bad tag block. The command passed to OnError() is empty.
+	///
+	void TagError(void);
+};
+
+template <class TDerived>
+CNMEAParserData::ERROR_E CNMEAParserFramer<TDerived>::ProcessNMEABuffer(const char * pData, size_t nBufferSize)
+{
+	//
+	// Zero-copy bookkeeping. While pCmdInBuffer is not NULL, the current sentence started in
+	// this buffer and its command/data have not been copied into m_pCommand/m_pData.
+	//
+	const char *pCmdInBuffer = NULL;
+	const char *pDataInBuffer = NULL;
+
+	size_t i = 0;
+	while (i < nBufferSize) {
+		switch (m_nState)
+		{
+			///////////////////////////////////////////////////////////////////////
+			// Search for start of message '$', or '!' for encapsulated sentences like AIS
+		case PARSE_STATE_SOM:
+			//
+			// Skip everything up to the next start of message or tag block
+			//
+			i += CNMEAParserScan::FindChar3(&pData[i], nBufferSize - i, '$', '!', '\\');
+			if (i < nBufferSize && pData[i] == '\\')
+			{
+				m_bTagPending = false;
+				m_nTagLen = 0;
+				m_nState = PARSE_STATE_TAG;
+				i++;
+			}
+			else if (i < nBufferSize)
+			{
+				//
+				// The sentence takes the tag block that came right before it
+				//
+				m_pSentenceTag = m_bTagPending ? &m_Tag : NULL;
+				m_bTagPending = false;
+
+				//
+				// Time tag this message
+				//
+				m_u64Timestamp = (m_bTimestamps || (m_pLatency != NULL)) ? CNMEAParserClock::Now() : 0;
+				Derived().TimeTag();
+
+				m_u8Checksum = 0;			// reset checksum
+				m_nIndex = 0;				// reset index
+				m_nState = PARSE_STATE_CMD;
+				i++;
+
+				pCmdInBuffer = m_bZeroCopy ? &pData[i] : NULL;
+			}
+			break;
+
+			///////////////////////////////////////////////////////////////////////
+			// Retrieve command (NMEA Address)
+		case PARSE_STATE_CMD:
+			{
+				//
+				// Copy the command up to the field delimiter, but never past the end of the command buffer
+				//
+				size_t nRun = nBufferSize - i;
+				if (nRun > CNMEAParserData::c_uMaxCmdLen - m_nIndex)
+				{
+					nRun = CNMEAParserData::c_uMaxCmdLen - m_nIndex;
+				}
+				size_t nLen = CNMEAParserScan::FindChar2(&pData[i], nRun, ',', '*');
+				if (pCmdInBuffer != NULL)
+				{
+					m_u8Checksum ^= CNMEAParserScan::Checksum(&pData[i], nLen);
+				}
+				else
+				{
+					m_u8Checksum ^= CNMEAParserScan::CopyChecksum(&m_pCommand[m_nIndex], &pData[i], nLen);
+				}
+				m_nIndex += (uint16_t)nLen;
+				i += nLen;
+
+				if (nLen < nRun)
+				{
+					if (pCmdInBuffer != NULL)
+					{
+						pDataInBuffer = &pData[i + 1];
+					}
+					else
+					{
+						m_pCommand[m_nIndex] = '\0';	// terminate command
+					}
+					m_nCmdLen = m_nIndex;
+					m_u8Checksum ^= pData[i];
+					m_nIndex = 0;
+					m_nState = PARSE_STATE_DATA;	// goto get data state
+					i++;
+				}
+				// Check for command overflow
+				else if (m_nIndex >= CNMEAParserData::c_uMaxCmdLen)
+				{
+					if (pCmdInBuffer != NULL)
+					{
+						memcpy(m_pCommand, pCmdInBuffer, m_nIndex);
+						pCmdInBuffer = NULL;
+					}
+					NMEAPARSER_TRACE_EVENT(m_pTrace, CNMEAParserTrace::TE_ERROR, m_pCommand, m_nIndex, CNMEAParserData::ERROR_CMD_BUFFER_OVERFLOW);
+					Derived().OnError(CNMEAParserData::ERROR_CMD_BUFFER_OVERFLOW, m_pCommand);
+					m_nState = PARSE_STATE_SOM;
+				}
+			}
+			break;
+
+			///////////////////////////////////////////////////////////////////////
+			// Store data and check for end of sentence or checksum flag
+		case PARSE_STATE_DATA:
+			{
+				//
+				// Store data and calculate checksum up to the checksum flag or end of sentence,
+				// but never past the end of the data buffer
+				//
+				size_t nRun = nBufferSize - i;
+				if (nRun > CNMEAParserData::c_uMaxDataLen - m_nIndex)
+				{
+					nRun = CNMEAParserData::c_uMaxDataLen - m_nIndex;
+				}
+				size_t nLen = CNMEAParserScan::FindChar2(&pData[i], nRun, '*', '\r');
+				if (pCmdInBuffer != NULL)
+				{
+					m_u8Checksum ^= CNMEAParserScan::Checksum(&pData[i], nLen);
+				}
+				else
+				{
+					m_u8Checksum ^= CNMEAParserScan::CopyChecksum(&m_pData[m_nIndex], &pData[i], nLen);
+				}
+				m_nIndex += (uint16_t)nLen;
+				i += nLen;
+
+				if (nLen < nRun)
+				{
+					if (pCmdInBuffer == NULL)
+					{
+						m_pData[m_nIndex] = '\0';
+					}
+
+					if (pData[i] == '*') // checksum flag?
+					{
+						m_nState = PARSE_STATE_CHECKSUM_1;
+						i++;
+					}
+					//
+					// End of sentence with no checksum
+					//
+					else
+					{
+						ProcessSentence(pCmdInBuffer, pDataInBuffer);
+						pCmdInBuffer = NULL;
+						m_nState = PARSE_STATE_SOM;
+						i++;
+					}
+				}
+				// Check for buffer overflow
+				else if (m_nIndex >= CNMEAParserData::c_uMaxDataLen)
+				{
+					if (pCmdInBuffer != NULL)
+					{
+						CopyCommand(pCmdInBuffer, m_nCmdLen);
+						pCmdInBuffer = NULL;
+					}
+					NMEAPARSER_TRACE_EVENT(m_pTrace, CNMEAParserTrace::TE_ERROR, m_pCommand, m_nCmdLen, CNMEAParserData::ERROR_RX_BUFFER_OVERFLOW);
+					Derived().OnError(CNMEAParserData::ERROR_RX_BUFFER_OVERFLOW, m_pCommand);
+					m_nState = PARSE_STATE_SOM;
+				}
+			}
+			break;
+
+			///////////////////////////////////////////////////////////////////////
+		case PARSE_STATE_CHECKSUM_1:
+			if ((pData[i] - '0') <= 9)
+			{
+				m_u8ReceivedChecksum = (pData[i] - '0') << 4;
+			}
+			else
+			{
+				m_u8ReceivedChecksum = (pData[i] - 'A' + 10) << 4;
+			}
+
+			m_nState = PARSE_STATE_CHECKSUM_2;
+			i++;
+			break;
+
+			///////////////////////////////////////////////////////////////////////
+		case PARSE_STATE_CHECKSUM_2:
+			if ((pData[i] - '0') <= 9)
+			{
+				m_u8ReceivedChecksum |= (pData[i] - '0');
+			}
+			else
+			{
+				m_u8ReceivedChecksum |= (pData[i] - 'A' + 10);
+			}
+
+			if (m_u8Checksum == m_u8ReceivedChecksum)
+			{
+				ProcessSentence(pCmdInBuffer, pDataInBuffer);
+			}
+			// Checksum error
+			else {
+				if (pCmdInBuffer != NULL)
+				{
+					CopyCommand(pCmdInBuffer, m_nCmdLen);
+				}
+				NMEAPARSER_TRACE_EVENT(m_pTrace, CNMEAParserTrace::TE_ERROR, m_pCommand, m_nCmdLen, CNMEAParserData::ERROR_CHECKSUM);
+				Derived().OnError(CNMEAParserData::ERROR_CHECKSUM, m_pCommand);
+			}
+
+			pCmdInBuffer = NULL;
+			m_nState = PARSE_STATE_SOM;
+			i++;
+			break;
+
+			///////////////////////////////////////////////////////////////////////
+			// Collect a tag block up to its closing backslash
+		case PARSE_STATE_TAG:
+			{
+				size_t nRun = nBufferSize - i;
+				if (nRun > CNMEAParserData::c_uMaxTagLen - m_nTagLen)
+				{
+					nRun = CNMEAParserData::c_uMaxTagLen - m_nTagLen;
+				}
+				size_t nLen = CNMEAParserScan::FindChar3(&pData[i], nRun, '\\', '$', '!');
+				memcpy(&m_Tag.pBlock[m_nTagLen], &pData[i], nLen);
+				m_nTagLen += (uint16_t)nLen;
+				i += nLen;
+
+				if (nLen < nRun && pData[i] == '\\')
+				{
+					if (CNMEAParserTag::Parse(m_Tag.pBlock, m_nTagLen, m_Tag) == CNMEAParserData::ERROR_OK)
+					{
+						m_bTagPending = true;
+					}
+					else
+					{
+						TagError();
+					}
+					m_nState = PARSE_STATE_SOM;
+					i++;
+				}
+				//
+				// A '$' or '!' before the closing backslash or a tag block that does not fit. It is
+				// left for PARSE_STATE_SOM, its sentence goes on without the tag block.
+				//
+				else if (nLen < nRun || m_nTagLen >= CNMEAParserData::c_uMaxTagLen)
+				{
+					TagError();
+					m_nState = PARSE_STATE_SOM;
+				}
+			}
+			break;
+
+			///////////////////////////////////////////////////////////////////////
+		default: m_nState = PARSE_STATE_SOM; i++;
+		}
+	}
+
+	//
+	// The current sentence continues in the next buffer. Move what we have so far into the
+	// internal buffers, since the caller's buffer will be gone by then.
+	//
+	if (pCmdInBuffer != NULL && m_nState != PARSE_STATE_SOM)
+	{
+		if (m_nState == PARSE_STATE_CMD)
+		{
+			memcpy(m_pCommand, pCmdInBuffer, m_nIndex);
+		}
+		else
+		{
+			CopyCommand(pCmdInBuffer, m_nCmdLen);
+			memcpy(m_pData, pDataInBuffer, m_nIndex);
+			m_pData[m_nIndex] = '\0';
+		}
+	}
+
+	return CNMEAParserData::ERROR_OK;
+}
+
+template <class TDerived>
+CNMEAParserData::ERROR_E CNMEAParserFramer<TDerived>::ProcessRxSentence(const CNMEAParserData::SENTENCE_VIEW_T &Sentence)
+{
+	//
+	// Make sure the sentence is in the internal buffers. It is already there if it was
+	// split across ProcessNMEABuffer() calls.
+	//
+	if (Sentence.pCmd != m_pCommand)
+	{
+		size_t nDataLen = Sentence.nDataLen;
+		if (nDataLen >= CNMEAParserData::c_uMaxDataLen)
+		{
+			nDataLen = CNMEAParserData::c_uMaxDataLen - 1;
+		}
+		CopyCommand(Sentence.pCmd, Sentence.nCmdLen);
+		memcpy(m_pData, Sentence.pData, nDataLen);
+		m_pData[nDataLen] = '\0';
+	}
+	return Derived().ProcessRxCommand(m_pCommand, m_pData);
+}
+
+template <class TDerived>
+void CNMEAParserFramer<TDerived>::ProcessSentence(const char *pCmdInBuffer, const char *pDataInBuffer)
+{
+	if (pCmdInBuffer != NULL)
+	{
+		CNMEAParserData::SENTENCE_VIEW_T Sentence = { pCmdInBuffer, m_nCmdLen, pDataInBuffer, m_nIndex, m_u64Timestamp, m_pSentenceTag };
+		Derived().ProcessRxSentence(Sentence);
+	}
+	else if (m_bZeroCopy)
+	{
+		CNMEAParserData::SENTENCE_VIEW_T Sentence = { m_pCommand, m_nCmdLen, m_pData, m_nIndex, m_u64Timestamp, m_pSentenceTag };
+		Derived().ProcessRxSentence(Sentence);
+	}
+	else
+	{
+		Derived().ProcessRxCommand(m_pCommand, m_pData);
+	}
+
+	// No time stamp when the histogram was attached after the '$' of this sentence
+	if ((m_pLatency != NULL) && (m_u64Timestamp != 0))
+	{
+		m_pLatency->Add(CNMEAParserClock::Now() - m_u64Timestamp);
+	}
+}
+
+template <class TDerived>
+void CNMEAParserFramer<TDerived>::CopyCommand(const char *pCmd, size_t nCmdLen)
+{
+	if (nCmdLen >= CNMEAParserData::c_uMaxCmdLen)
+	{
+		nCmdLen = CNMEAParserData::c_uMaxCmdLen - 1;
+	}
+	memcpy(m_pCommand, pCmd, nCmdLen);
+	m_pCommand[nCmdLen] = '\0';
+}
+
+template <class TDerived>
+void CNMEAParserFramer<TDerived>::TagError(void)
+{
+	NMEAPARSER_TRACE_EVENT(m_pTrace, CNMEAParserTrace::TE_ERROR, m_Tag.pBlock, m_nTagLen, CNMEAParserData::ERROR_TAG_BLOCK);
+	m_pCommand[0] = '\0';
+	Derived().OnError(CNMEAParserData::ERROR_TAG_BLOCK, m_pCommand);
+}
+
+template <class TDerived>
+void CNMEAParserFramer<TDerived>::Reset(void) {
+	m_nState = PARSE_STATE_SOM;
+	m_u8Checksum = m_u8ReceivedChecksum = 0;
+	m_nIndex = 0;
+	m_nCmdLen = 0;
+	m_nTagLen = 0;
+	m_bTagPending = false;
+	m_pSentenceTag = NULL;
+}
+
@@ -0,0 +1,127 @@
+/*
+* MIT License
+*
+*  Copyright (c) 2018 VisualGPS, LLC
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this software and associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright notice and this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*
+*/
+#include <string.h>
+#include "NMEAParserHash.h"
+
+CNMEAParserHash::CNMEAParserHash()
+{
+	Clear();
+}
+
+void CNMEAParserHash::Clear(void)
+{
+	memset(m_puKeys, 0, sizeof(m_puKeys));
+	memset(m_pu8Values, c_u8NotFound, sizeof(m_pu8Values));
+	m_uMultiplier = 0x9E3779B1;
+	m_nShift = 32 - c_nTableBits;
+	m_nCount = 0;
+}
+
+bool CNMEAParserHash::Insert(uint32_t uKey, uint8_t u8Value)
+{
+	if (uKey == 0 || u8Value == c_u8NotFound) {
+		return false;
+	}
+
+	//
+	// Replace the value if the key already exists
+	//
+	int nBucket = (int)((uKey * m_uMultiplier) >> m_nShift);
+	if (m_puKeys[nBucket] == uKey) {
+		m_pu8Values[nBucket] = u8Value;
+		return true;
+	}
+
+	if (m_nCount >= c_nMaxKeys) {
+		return false;
+	}
+
+	//
+	// Gather the current keys plus the new one
+	//
+	uint32_t puKeys[c_nMaxKeys];
+	uint8_t pu8Values[c_nMaxKeys];
+	int nCount = 0;
+	for (int i = 0; i < c_nTableSize; i++) {
+		if (m_puKeys[i] != 0) {
+			puKeys[nCount] = m_puKeys[i];
+			pu8Values[nCount] = m_pu8Values[i];
+			nCount++;
+		}
+	}
+	puKeys[nCount] = uKey;
+	pu8Values[nCount] = u8Value;
+	nCount++;
+
+	//
+	// Find a multiplier that puts every key in its own bucket. Walk odd multipliers
+	// with a Weyl sequence so the search is deterministic. The search is bounded, when
+	// it fails the table grows by one bit and the search starts over.
+	//
+	uint32_t uMultiplier = m_uMultiplier;
+	int nShift = m_nShift;
+	int nAttempts = 0;
+	while (!IsPerfect(puKeys, nCount, uMultiplier, nShift)) {
+		if (++nAttempts >= c_nMaxAttempts) {
+			if (nShift <= 32 - c_nMaxTableBits) {
+				return false;
+			}
+			nShift--;
+			nAttempts = 0;
+		}
+		uMultiplier += 0x6A09E668;
+		uMultiplier |= 1;
+	}
+
+	//
+	// Rebuild the table
+	//
+	memset(m_puKeys, 0, sizeof(m_puKeys));
+	memset(m_pu8Values, c_u8NotFound, sizeof(m_pu8Values));
+	m_uMultiplier = uMultiplier;
+	m_nShift = nShift;
+	for (int i = 0; i < nCount; i++) {
+		nBucket = (int)((puKeys[i] * m_uMultiplier) >> m_nShift);
+		m_puKeys[nBucket] = puKeys[i];
+		m_pu8Values[nBucket] = pu8Values[i];
+	}
+	m_nCount = nCount;
+
+	return true;
+}
+
+bool CNMEAParserHash::IsPerfect(const uint32_t *puKeys, int nCount, uint32_t uMultiplier, int nShift) const
+{
+	uint64_t pu64Used[(c_nTableSize + 63) / 64] = { 0 };
+	for (int i = 0; i < nCount; i++) {
+		uint32_t uBucket = (puKeys[i] * uMultiplier) >> nShift;
+		uint64_t u64Bit = (uint64_t)1 << (uBucket & 63);
+		if (pu64Used[uBucket >> 6] & u64Bit) {
+			return false;
+		}
+		pu64Used[uBucket >> 6] |= u64Bit;
+	}
+	return true;
+}
@@ -0,0 +1,136 @@
+/*
+* MIT License
+*
+*  Copyright (c) 2018 VisualGPS, LLC
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this software and associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright notice and this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*
+*/
+
+#pragma once
+#include <cstddef>
+#include <stdint.h>
+#include "NMEAParserConfig.h"
+
+///
+/// \class CNMEAParserHash
+/// \brief Small perfect hash table that maps packed NMEA addresses to a slot index.
+///
+/// The table is built so that no two keys share a bucket. A lookup is a multiply, a shift and
+/// one key compare, so every key - including unknown ones - costs the same. Each Insert()
+/// searches for a multiplier that keeps the table collision free. The search tries at most
+/// c_nMaxAttempts multipliers, then doubles the number of buckets once. Inserts are expected to
+/// be rare (construction time or the first time a talker/sentence is seen).
+///
+class CNMEAParserHash
+{
+public:
+	static const int				c_nMaxKeys = NMEAPARSER_MAX_SLOTS;			///< Maximum number of keys in the table
+	static const int				c_nTableBits = (c_nMaxKeys <= 12) ? 5 : (c_nMaxKeys <= 24) ? 6 : 7;	///< Number of bits used to index the table, about 2.7 buckets per key
+	static const int				c_nMaxTableBits = c_nTableBits + 1;			///< Number of bits after the table has grown
+	static const int				c_nTableSize = 1 << c_nMaxTableBits;		///< Number of buckets allocated, room for the grown table
+	static const int				c_nMaxAttempts = 512;						///< Multipliers tried per table size before growing or failing
+	static const uint8_t			c_u8NotFound = 0xFF;						///< Returned by Find() for unknown keys
+
+private:
+	uint32_t						m_puKeys[c_nTableSize];						///< Keys, 0 is an empty bucket
+	uint8_t							m_pu8Values[c_nTableSize];					///< Value stored with each key
+	uint32_t						m_uMultiplier;								///< Current collision free multiplier
+	int								m_nShift;									///< 32 minus the number of bits in use
+	int								m_nCount;									///< Number of keys in the table
+
+public:
+	CNMEAParserHash();
+
+	///
+	/// \brief Removes all keys from the table
+	///
+	void Clear(void);
+
+	///
+	/// \brief Adds or replaces a key.
+	///
+	/// \param uKey Packed address key, see MakeKey(). Must not be 0.
+	/// \param u8Value Value to associate with uKey. Must not be c_u8NotFound.
+	/// \return true if successful, false if the table is full or no collision free multiplier was found.
+	///
+	bool Insert(uint32_t uKey, uint8_t u8Value);
+
+	///
+	/// \brief Looks up a key.
+	///
+	/// \param uKey Packed address key, see MakeKey().
+	/// \return The value stored with uKey or c_u8NotFound.
+	///
+	uint8_t Find(uint32_t uKey) const {
+		int nBucket = (int)((uKey * m_uMultiplier) >> m_nShift);
+		return (m_puKeys[nBucket] == uKey) ? m_pu8Values[nBucket] : c_u8NotFound;
+	}
+
+	///
+	/// \brief Returns the number of keys in the table
+	///
+	int GetCount(void) const { return m_nCount; }
+
+	///
+	/// \brief Packs a 5 character NMEA address (2 character talker + 3 character sentence ID) into a key.
+	///
+	/// Each character is stored in 6 bits (ASCII 0x20 to 0x5F), which covers upper case letters
+	/// and digits.
+	///
+	/// \param pCmd NMEA command, does not need to be NUL terminated
+	/// \param nCmdLen Number of characters in pCmd
+	/// \return The packed key or 0 if pCmd is not a 5 character address or contains characters that cannot be packed.
+	///
+	static uint32_t MakeKey(const char *pCmd, size_t nCmdLen) {
+		if (nCmdLen != 5) {
+			return 0;
+		}
+		uint32_t uKey = 0;
+		for (int i = 0; i < 5; i++) {
+			uint32_t uChar = (uint32_t)((uint8_t)pCmd[i]) - 0x20;
+			if (uChar >= 0x40) {
+				return 0;
+			}
+			uKey = (uKey << 6) | uChar;
+		}
+		return uKey;
+	}
+
+	///
+	/// \brief Packs a talker ID and a sentence ID into a key. See MakeKey(const char *, size_t).
+	///
+	/// \param nTalkerID Talker ID, CNMEAParserData::TALKER_ID_E
+	/// \param nSentenceID Sentence ID, CNMEAParserData::SENTENCE_ID_E
+	/// \return The packed key or 0 if the IDs cannot be packed.
+	///
+	static uint32_t MakeKey(uint32_t nTalkerID, uint32_t nSentenceID) {
+		char pCmd[5] = {
+			(char)(nTalkerID >> 8), (char)nTalkerID,
+			(char)(nSentenceID >> 16), (char)(nSentenceID >> 8), (char)nSentenceID
+		};
+		return MakeKey(pCmd, 5);
+	}
+
+private:
+	///
+	/// \brief Returns true if uMultiplier places every key in puKeys in its own bucket.
+	///
+	bool IsPerfect(const uint32_t *puKeys, int nCount, uint32_t uMultiplier, int nShift) const;
+};
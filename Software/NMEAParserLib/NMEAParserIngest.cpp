@@ -0,0 +1,262 @@
+/*
+* MIT License
+*
+*  Copyright (c) 2018 VisualGPS, LLC
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this software and associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright notice and this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*
+*/
+#include "NMEAParserIngest.h"
+
+#if defined(__linux__)
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+///
+/// epoll user data of the Stop() eventfd
+///
+static const uint32_t c_uWakeupSource = 0xFFFFFFFF;
+
+CNMEAParserIngest::CNMEAParserIngest() :
+	m_nEpoll(-1),
+	m_nWakeup(-1),
+	m_nCount(0),
+	m_nRegular(0),
+	m_Buffer(c_nReadSize),
+	m_bStop(false)
+{
+	m_nEpoll = epoll_create1(EPOLL_CLOEXEC);
+	m_nWakeup = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+	if ((m_nEpoll >= 0) && (m_nWakeup >= 0)) {
+		struct epoll_event Event;
+		Event.events = EPOLLIN;
+		Event.data.u32 = c_uWakeupSource;
+		epoll_ctl(m_nEpoll, EPOLL_CTL_ADD, m_nWakeup, &Event);
+	}
+}
+
+CNMEAParserIngest::~CNMEAParserIngest()
+{
+	for (size_t i = 0; i < m_Sources.size(); i++) {
+		if (m_Sources[i].nFD >= 0) {
+			Remove((int)i);
+		}
+	}
+	if (m_nWakeup >= 0) {
+		close(m_nWakeup);
+	}
+	if (m_nEpoll >= 0) {
+		close(m_nEpoll);
+	}
+}
+
+CNMEAParserData::ERROR_E CNMEAParserIngest::AddDescriptor(int nFD, CNMEAParserPacket *pParser, bool bClose)
+{
+	if ((m_nEpoll < 0) || (nFD < 0) || (pParser == NULL) || (Find(nFD) >= 0)) {
+		return CNMEAParserData::ERROR_FAIL;
+	}
+
+	struct stat Stat;
+	if (fstat(nFD, &Stat) != 0) {
+		return CNMEAParserData::ERROR_FAIL;
+	}
+
+	int nFlags = fcntl(nFD, F_GETFL);
+	if ((nFlags < 0) || (fcntl(nFD, F_SETFL, nFlags | O_NONBLOCK) != 0)) {
+		return CNMEAParserData::ERROR_FAIL;
+	}
+
+	//
+	// Reuse a free entry, its index is the epoll user data
+	//
+	int nSource = Find(-1);
+	if (nSource < 0) {
+		nSource = (int)m_Sources.size();
+		m_Sources.push_back(SOURCE_T());
+	}
+
+	SOURCE_T &Source = m_Sources[nSource];
+	Source.nFD = nFD;
+	Source.pParser = pParser;
+	Source.bClose = bClose;
+	Source.bRegular = S_ISREG(Stat.st_mode);
+	Source.bTTY = (isatty(nFD) != 0);
+	Source.u64Bytes = 0;
+
+	//
+	// Regular files are always readable and epoll refuses them
+	//
+	if (!Source.bRegular) {
+		struct epoll_event Event;
+		Event.events = EPOLLIN;
+		Event.data.u32 = (uint32_t)nSource;
+		if (epoll_ctl(m_nEpoll, EPOLL_CTL_ADD, nFD, &Event) != 0) {
+			Source.nFD = -1;
+			return CNMEAParserData::ERROR_FAIL;
+		}
+	}
+	else {
+		m_nRegular++;
+	}
+
+	m_nCount++;
+	return CNMEAParserData::ERROR_OK;
+}
+
+CNMEAParserData::ERROR_E CNMEAParserIngest::RemoveDescriptor(int nFD)
+{
+	int nSource = (nFD < 0) ? -1 : Find(nFD);
+	if (nSource < 0) {
+		return CNMEAParserData::ERROR_FAIL;
+	}
+	Remove(nSource);
+	return CNMEAParserData::ERROR_OK;
+}
+
+uint64_t CNMEAParserIngest::GetBytesRead(int nFD) const
+{
+	int nSource = (nFD < 0) ? -1 : Find(nFD);
+	return (nSource < 0) ? 0 : m_Sources[nSource].u64Bytes;
+}
+
+int CNMEAParserIngest::Poll(int nTimeoutMs)
+{
+	if (m_nEpoll < 0) {
+		return -1;
+	}
+
+	struct epoll_event pEvents[c_nMaxEvents];
+	int nEvents = epoll_wait(m_nEpoll, pEvents, c_nMaxEvents, (m_nRegular > 0) ? 0 : nTimeoutMs);
+	if (nEvents < 0) {
+		return (errno == EINTR) ? 0 : -1;
+	}
+
+	int nRead = 0;
+	for (int i = 0; i < nEvents; i++) {
+		uint32_t uSource = pEvents[i].data.u32;
+		if (uSource == c_uWakeupSource) {
+			uint64_t u64Value;
+			while (read(m_nWakeup, &u64Value, sizeof(u64Value)) > 0) {
+			}
+			continue;
+		}
+
+		//
+		// A parser hook may have removed the descriptor since epoll_wait()
+		//
+		if ((uSource < m_Sources.size()) && (m_Sources[uSource].nFD >= 0) && !m_Sources[uSource].bRegular) {
+			bool bHangup = (pEvents[i].events & (EPOLLHUP | EPOLLERR)) != 0;
+			if (ReadSource((int)uSource, bHangup)) {
+				nRead++;
+			}
+		}
+	}
+
+	if (m_nRegular > 0) {
+		for (size_t i = 0; i < m_Sources.size(); i++) {
+			if ((m_Sources[i].nFD >= 0) && m_Sources[i].bRegular && ReadSource((int)i, false)) {
+				nRead++;
+			}
+		}
+	}
+	return nRead;
+}
+
+void CNMEAParserIngest::Run(void)
+{
+	while (!m_bStop.load() && (m_nCount > 0)) {
+		if (Poll(-1) < 0) {
+			break;
+		}
+	}
+	m_bStop.store(false);
+}
+
+void CNMEAParserIngest::Stop(void)
+{
+	m_bStop.store(true);
+	if (m_nWakeup >= 0) {
+		uint64_t u64Value = 1;
+		ssize_t nWritten = write(m_nWakeup, &u64Value, sizeof(u64Value));
+		UNUSED_PARAM(nWritten);
+	}
+}
+
+int CNMEAParserIngest::Find(int nFD) const
+{
+	for (size_t i = 0; i < m_Sources.size(); i++) {
+		if (m_Sources[i].nFD == nFD) {
+			return (int)i;
+		}
+	}
+	return -1;
+}
+
+bool CNMEAParserIngest::ReadSource(int nSource, bool bHangup)
+{
+	SOURCE_T &Source = m_Sources[nSource];
+	ssize_t nLen = read(Source.nFD, m_Buffer.data(), m_Buffer.size());
+
+	if (nLen > 0) {
+		Source.u64Bytes += (uint64_t)nLen;
+		Source.pParser->ProcessNMEABuffer(m_Buffer.data(), (size_t)nLen);
+		return true;
+	}
+
+	int nError = (nLen < 0) ? errno : 0;
+	if (((nError == EAGAIN) || (nError == EWOULDBLOCK) || (nError == EINTR)) && !bHangup) {
+		return false;
+	}
+
+	//
+	// A terminal returns 0 bytes when it has nothing to read, it only ends when it hangs up
+	//
+	if ((nLen == 0) && Source.bTTY && !bHangup) {
+		return false;
+	}
+
+	int nFD = Source.nFD;
+	Remove(nSource);
+	OnClose(nFD, nError);
+	return false;
+}
+
+void CNMEAParserIngest::Remove(int nSource)
+{
+	SOURCE_T &Source = m_Sources[nSource];
+	if (Source.bRegular) {
+		m_nRegular--;
+	}
+	else {
+		epoll_ctl(m_nEpoll, EPOLL_CTL_DEL, Source.nFD, NULL);
+	}
+	if (Source.bClose) {
+		close(Source.nFD);
+	}
+	Source.nFD = -1;
+	m_nCount--;
+}
+
+#endif
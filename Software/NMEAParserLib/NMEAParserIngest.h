@@ -0,0 +1,165 @@
+/*
+* MIT License
+*
+*  Copyright (c) 2018 VisualGPS, LLC
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this software and associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright notice and this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*
+*/
+#pragma once
+#include <cstddef>
+#include <stdint.h>
+#include <atomic>
+#include <vector>
+
+#include "NMEAParserData.h"
+#include "NMEAParserPacket.h"
+
+#if defined(__linux__)
+
+///
+/// \class CNMEAParserIngest
+/// \brief Reads many file descriptors from one thread with epoll and feeds each one to its own parser.
+///
+/// Any readable descriptor can be added: serial ports, ptys, pipes, sockets and regular files. The
+/// descriptors are switched to non-blocking mode and read in reads of up to c_nReadSize bytes, one
+/// read per ready descriptor and Poll() so that a busy receiver cannot starve the others. A regular
+/// file cannot wait in epoll, it is read on every Poll() until its end.
+///
+/// A descriptor is removed when it reaches its end or fails, for example when the device goes away
+/// or the other side of a pty or pipe is closed. OnClose() is then called.
+///
+/// The parsers, AddDescriptor() and RemoveDescriptor() are used from the thread that calls Poll() or
+/// Run() only, or while the ingest is not polling. Stop() may be called from any thread.
+///
+/// This class is only available on Linux.
+///
+class CNMEAParserIngest
+{
+public:
+	static const size_t				c_nReadSize = 65536;						///< Largest single read
+	static const int				c_nMaxEvents = 64;							///< Largest number of events taken from epoll at once
+
+private:
+	///
+	/// \brief A descriptor being read
+	///
+	typedef struct _SOURCE_T {
+		int							nFD;										///< The descriptor, -1 if the entry is free
+		CNMEAParserPacket *			pParser;									///< Parser of the descriptor
+		bool						bClose;										///< Close the descriptor when it is removed
+		bool						bRegular;									///< Regular file, read on every Poll()
+		bool						bTTY;										///< Terminal, a read of 0 bytes is not the end
+		uint64_t					u64Bytes;									///< Bytes read
+	} SOURCE_T;
+
+	int								m_nEpoll;									///< The epoll instance, -1 if it could not be created
+	int								m_nWakeup;									///< eventfd that wakes epoll_wait() for Stop()
+	std::vector<SOURCE_T>			m_Sources;									///< Descriptors, indexed by the epoll user data
+	int								m_nCount;									///< Number of descriptors being read
+	int								m_nRegular;									///< Number of regular files being read
+	std::vector<char>				m_Buffer;									///< Read buffer shared by all descriptors
+	std::atomic<bool>				m_bStop;									///< Run() returns when set
+
+public:
+	CNMEAParserIngest();
+	virtual ~CNMEAParserIngest();
+
+	///
+	/// \brief Returns true if the epoll instance was created
+	///
+	bool IsValid(void) const { return m_nEpoll >= 0; }
+
+	///
+	/// \brief Adds a descriptor and switches it to non-blocking mode
+	///
+	/// \param nFD The descriptor. A serial port should already be configured (baud rate, raw mode).
+	/// \param pParser Parser that receives everything read from nFD. It must outlive the descriptor.
+	/// \param bClose true to close nFD when it is removed
+	/// \return CNMEAParserData::ERROR_OK if successful, ERROR_FAIL if nFD is already added or cannot be polled
+	///
+	CNMEAParserData::ERROR_E AddDescriptor(int nFD, CNMEAParserPacket *pParser, bool bClose = false);
+
+	///
+	/// \brief Removes a descriptor. OnClose() is not called.
+	///
+	/// \return CNMEAParserData::ERROR_OK if successful, ERROR_FAIL if nFD was not added
+	///
+	CNMEAParserData::ERROR_E RemoveDescriptor(int nFD);
+
+	///
+	/// \brief Returns the number of descriptors being read
+	///
+	int GetDescriptorCount(void) const { return m_nCount; }
+
+	///
+	/// \brief Returns the number of bytes read from a descriptor, 0 if it is not being read
+	///
+	uint64_t GetBytesRead(int nFD) const;
+
+	///
+	/// \brief Waits for data and reads every descriptor that has some, once.
+	///
+	/// \param nTimeoutMs Longest time to wait in milliseconds, -1 to wait until there is data. It does
+	/// not wait while a regular file is being read.
+	/// \return Number of descriptors that were read, or -1 if epoll failed
+	///
+	int Poll(int nTimeoutMs);
+
+	///
+	/// \brief Calls Poll() until Stop() is called or no descriptor is left
+	///
+	void Run(void);
+
+	///
+	/// \brief Makes Run() return. Safe to call from any thread.
+	///
+	void Stop(void);
+
+protected:
+	///
+	/// \brief Called when a descriptor reached its end or failed and was removed.
+	///
+	/// \param nFD The descriptor. It is already closed if it was added with bClose.
+	/// \param nError errno of the failed read, 0 at the end of the data
+	///
+	virtual void OnClose(int nFD, int nError) { UNUSED_PARAM(nFD); UNUSED_PARAM(nError); }
+
+private:
+	///
+	/// \brief Returns the index of a descriptor in m_Sources, -1 if it is not being read
+	///
+	int Find(int nFD) const;
+
+	///
+	/// \brief Reads a descriptor once and parses what was read
+	///
+	/// \param nSource Index in m_Sources
+	/// \param bHangup epoll reported a hang up or an error
+	/// \return true if data was read
+	///
+	bool ReadSource(int nSource, bool bHangup);
+
+	///
+	/// \brief Stops reading a descriptor and closes it if it was added with bClose
+	///
+	void Remove(int nSource);
+};
+
+#endif
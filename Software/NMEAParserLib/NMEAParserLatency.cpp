@@ -0,0 +1,140 @@
+/*
+* MIT License
+*
+*  Copyright (c) 2018 VisualGPS, LLC
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this software and associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright notice and this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*
+*/
+#include "NMEAParserLatency.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+///
+/// \brief Returns the index of the highest set bit. u64Value must not be zero.
+///
+static inline int HighestBit(uint64_t u64Value)
+{
+#if defined(_MSC_VER) && defined(_M_X64)
+	unsigned long ulIndex;
+	_BitScanReverse64(&ulIndex, u64Value);
+	return (int)ulIndex;
+#elif defined(_MSC_VER)
+	int nIndex = 63;
+	while ((u64Value >> nIndex) == 0) {
+		nIndex--;
+	}
+	return nIndex;
+#else
+	return 63 - __builtin_clzll(u64Value);
+#endif
+}
+
+CNMEAParserLatency::CNMEAParserLatency()
+{
+	Reset();
+}
+
+CNMEAParserLatency::~CNMEAParserLatency()
+{
+}
+
+void CNMEAParserLatency::Add(uint64_t u64Nanoseconds)
+{
+	m_pu64Buckets[GetBucket(u64Nanoseconds)].fetch_add(1, std::memory_order_relaxed);
+	m_u64Count.fetch_add(1, std::memory_order_relaxed);
+	m_u64Sum.fetch_add(u64Nanoseconds, std::memory_order_relaxed);
+
+	uint64_t u64Max = m_u64Max.load(std::memory_order_relaxed);
+	while ((u64Nanoseconds > u64Max) && !m_u64Max.compare_exchange_weak(u64Max, u64Nanoseconds, std::memory_order_relaxed)) {
+	}
+}
+
+void CNMEAParserLatency::Reset(void)
+{
+	for (int i = 0; i < c_nBuckets; i++) {
+		m_pu64Buckets[i].store(0, std::memory_order_relaxed);
+	}
+	m_u64Count.store(0, std::memory_order_relaxed);
+	m_u64Sum.store(0, std::memory_order_relaxed);
+	m_u64Max.store(0, std::memory_order_relaxed);
+}
+
+uint64_t CNMEAParserLatency::GetMean(void) const
+{
+	uint64_t u64Count = GetCount();
+	return (u64Count == 0) ? 0 : m_u64Sum.load(std::memory_order_relaxed) / u64Count;
+}
+
+uint64_t CNMEAParserLatency::GetPercentile(double dPercent) const
+{
+	//
+	// Count the buckets instead of using GetCount(), values may be added meanwhile
+	//
+	uint64_t u64Total = 0;
+	for (int i = 0; i < c_nBuckets; i++) {
+		u64Total += GetBucketCount(i);
+	}
+	if (u64Total == 0) {
+		return 0;
+	}
+
+	if (dPercent < 0.0) {
+		dPercent = 0.0;
+	}
+	uint64_t u64Rank = (uint64_t)(dPercent / 100.0 * (double)u64Total + 0.5);
+	if (u64Rank == 0) {
+		u64Rank = 1;
+	}
+
+	uint64_t u64Max = GetMax();
+	uint64_t u64Seen = 0;
+	for (int i = 0; i < c_nBuckets - 1; i++) {
+		u64Seen += GetBucketCount(i);
+		if (u64Seen >= u64Rank) {
+			uint64_t u64End = GetBucketStart(i + 1) - 1;
+			return (u64End < u64Max) ? u64End : u64Max;
+		}
+	}
+	return u64Max;
+}
+
+uint64_t CNMEAParserLatency::GetBucketStart(int nBucket)
+{
+	if (nBucket < 8) {
+		return (uint64_t)nBucket;
+	}
+	int nExponent = nBucket / 4 + 1;
+	return (uint64_t)(4 + (nBucket & 3)) << (nExponent - 2);
+}
+
+int CNMEAParserLatency::GetBucket(uint64_t u64Nanoseconds)
+{
+	if (u64Nanoseconds < 8) {
+		return (int)u64Nanoseconds;
+	}
+
+	//
+	// The highest bit selects the power of two, the two bits below it the quarter
+	//
+	int nExponent = HighestBit(u64Nanoseconds);
+	return (nExponent - 1) * 4 + (int)((u64Nanoseconds >> (nExponent - 2)) & 3);
+}
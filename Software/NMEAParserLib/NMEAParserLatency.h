@@ -0,0 +1,106 @@
+/*
+* MIT License
+*
+*  Copyright (c) 2018 VisualGPS, LLC
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this software and associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright notice and this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*
+*/
+#pragma once
+#include <cstddef>
+#include <stdint.h>
+#include <atomic>
+
+///
+/// \class CNMEAParserLatency
+/// \brief Histogram of the time from the '$' of a sentence until it is decoded, in nanoseconds.
+///
+/// Each power of two is split into four buckets, so a bucket is at most 25% wide. Values below 8 ns
+/// have a bucket each. Add() is lock-free and may be called by several parsers at once; the GetXXX()
+/// methods may be called from any thread while they do.
+///
+/// Attach a histogram to a parser with SetLatencyHistogram(). The parser then time stamps every
+/// sentence, see SetTimestamps().
+///
+class CNMEAParserLatency
+{
+public:
+	static const int				c_nBuckets = 252;							///< Number of buckets, enough for any 64 bit value
+
+private:
+	std::atomic<uint64_t>			m_pu64Buckets[c_nBuckets];					///< Number of values in each bucket
+	std::atomic<uint64_t>			m_u64Count;									///< Number of values
+	std::atomic<uint64_t>			m_u64Sum;									///< Sum of the values
+	std::atomic<uint64_t>			m_u64Max;									///< Largest value
+
+public:
+	CNMEAParserLatency();
+	~CNMEAParserLatency();
+
+	///
+	/// \brief Adds a value
+	///
+	/// \param u64Nanoseconds Time from the '$' of a sentence until it was decoded
+	///
+	void Add(uint64_t u64Nanoseconds);
+
+	///
+	/// \brief Empties the histogram. Values added at the same time may be lost.
+	///
+	void Reset(void);
+
+	///
+	/// \brief Returns the number of values
+	///
+	uint64_t GetCount(void) const { return m_u64Count.load(std::memory_order_relaxed); }
+
+	///
+	/// \brief Returns the mean of the values in nanoseconds, 0 if there are none
+	///
+	uint64_t GetMean(void) const;
+
+	///
+	/// \brief Returns the largest value in nanoseconds
+	///
+	uint64_t GetMax(void) const { return m_u64Max.load(std::memory_order_relaxed); }
+
+	///
+	/// \brief Returns the value below which dPercent percent of the values are.
+	///
+	/// \param dPercent Percentile, 0 to 100
+	/// \return The upper bound of the bucket that holds the percentile, but never more than GetMax(). 0 if
+	/// there are no values.
+	///
+	uint64_t GetPercentile(double dPercent) const;
+
+	///
+	/// \brief Returns the number of values in a bucket
+	///
+	uint64_t GetBucketCount(int nBucket) const { return m_pu64Buckets[nBucket].load(std::memory_order_relaxed); }
+
+	///
+	/// \brief Returns the smallest value of a bucket. The bucket ends where the next one starts.
+	///
+	static uint64_t GetBucketStart(int nBucket);
+
+	///
+	/// \brief Returns the bucket of a value
+	///
+	static int GetBucket(uint64_t u64Nanoseconds);
+};
@@ -0,0 +1,324 @@
+/*
+* MIT License
+*
+*  Copyright (c) 2018 VisualGPS, LLC
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this software and associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright notice and this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*
+*/
+#include <stdio.h>
+#include <string.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include "NMEAParserLog.h"
+#include "NMEAParserScan.h"
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+///
+/// \brief Parser of the chunks of one worker, forwards its hooks to the sink
+///
+class CNMEAParserLogChunk : public CNMEAParser
+{
+private:
+	CNMEAParserLogSink *			m_pSink;									///< Sink of the log
+	int								m_nChunk;									///< Chunk being parsed
+	bool							m_bPriming;									///< true while the tail of the chunk before is parsed
+
+public:
+	CNMEAParserLogChunk(CNMEAParserLogSink *pSink) : m_pSink(pSink), m_nChunk(0), m_bPriming(false) { SetZeroCopy(true); }
+
+	///
+	/// \brief Parses the chunk from nStart to nEnd, and on into the next chunk to finish its last sentence
+	///
+	/// The sentences from nPrime to nStart are parsed first without reporting them, so that the data
+	/// built up by the chunk before is there for the first sentences of this one.
+	///
+	void ParseChunk(int nChunk, const char *pData, size_t nPrime, size_t nStart, size_t nEnd, size_t nSize) {
+		m_nChunk = nChunk;
+		Reset();
+		ResetData();
+		m_pSink->OnChunkStart(nChunk, *this);
+
+		if (nPrime < nStart) {
+			m_bPriming = true;
+			ProcessNMEABuffer(&pData[nPrime], nStart - nPrime);
+			m_bPriming = false;
+			Reset();
+		}
+
+		ProcessNMEABuffer(&pData[nStart], nEnd - nStart);
+
+		//
+		// Byte by byte, so that the parser stops right where the sentence ends. A sentence
+		// never takes more than this, the parser reports an overflow before.
+		//
+		size_t nLimit = nEnd + CNMEAParserData::c_uMaxCmdLen + CNMEAParserData::c_uMaxDataLen + 4;
+		for (size_t i = nEnd; (i < nSize) && (i < nLimit) && IsInSentence(); i++) {
+			ProcessNMEABuffer(&pData[i], 1);
+		}
+	}
+
+protected:
+	virtual CNMEAParserData::ERROR_E ProcessRxCommand(char *pCmd, char *pData) {
+		CNMEAParserData::SENTENCE_VIEW_T Sentence = { pCmd, strlen(pCmd), pData, strlen(pData), GetTimestamp(), GetTagBlock() };
+		return ProcessRxSentence(Sentence);
+	}
+
+	virtual CNMEAParserData::ERROR_E ProcessRxSentence(const CNMEAParserData::SENTENCE_VIEW_T &Sentence) {
+		CNMEAParserData::ERROR_E nError = CNMEAParser::ProcessRxSentence(Sentence);
+		if (m_bPriming) {
+			return nError;
+		}
+		if (nError == CNMEAParserData::ERROR_OK) {
+			m_pSink->OnSentence(m_nChunk, *this, Sentence);
+		}
+		else {
+			// The command points into the log, the sink gets it terminated
+			char szCmd[CNMEAParserData::c_uMaxCmdLen + 1];
+			size_t nCmdLen = (Sentence.nCmdLen < CNMEAParserData::c_uMaxCmdLen) ? Sentence.nCmdLen : CNMEAParserData::c_uMaxCmdLen;
+			memcpy(szCmd, Sentence.pCmd, nCmdLen);
+			szCmd[nCmdLen] = '\0';
+			m_pSink->OnError(m_nChunk, nError, szCmd);
+		}
+		return nError;
+	}
+
+	virtual void OnError(CNMEAParserData::ERROR_E nError, char *pCmd) {
+		if (!m_bPriming) {
+			m_pSink->OnError(m_nChunk, nError, pCmd);
+		}
+	}
+
+	virtual void OnEpoch(const CNMEAParserData::EPOCH_DATA_T &Epoch) {
+		if (!m_bPriming) {
+			m_pSink->OnEpoch(m_nChunk, Epoch);
+		}
+	}
+
+	virtual void OnAISMessage(const CNMEAParserData::AIS_MESSAGE_T &Message) {
+		if (!m_bPriming) {
+			m_pSink->OnAISMessage(m_nChunk, Message);
+		}
+	}
+};
+
+CNMEAParserLog::CNMEAParserLog() :
+	m_pData(NULL),
+	m_nSize(0),
+	m_pMapping(NULL),
+	m_nPrimeSize(c_nDefaultPrimeSize)
+{
+}
+
+CNMEAParserLog::~CNMEAParserLog()
+{
+	Close();
+}
+
+CNMEAParserData::ERROR_E CNMEAParserLog::Open(const char *pszFileName)
+{
+	Close();
+
+#if defined(_WIN32)
+	FILE *fp = fopen(pszFileName, "rb");
+	if (fp == NULL) {
+		return CNMEAParserData::ERROR_FAIL;
+	}
+
+	char pBuff[65536];
+	size_t nRead;
+	while ((nRead = fread(pBuff, 1, sizeof(pBuff), fp)) > 0) {
+		m_Buffer.insert(m_Buffer.end(), pBuff, pBuff + nRead);
+	}
+	fclose(fp);
+
+	m_pData = m_Buffer.empty() ? NULL : m_Buffer.data();
+	m_nSize = m_Buffer.size();
+#else
+	int fd = open(pszFileName, O_RDONLY);
+	if (fd < 0) {
+		return CNMEAParserData::ERROR_FAIL;
+	}
+
+	struct stat Stat;
+	if (fstat(fd, &Stat) != 0) {
+		close(fd);
+		return CNMEAParserData::ERROR_FAIL;
+	}
+
+	//
+	// An empty file cannot be mapped, it is an empty log
+	//
+	if (Stat.st_size > 0) {
+		void *pMapping = mmap(NULL, (size_t)Stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (pMapping == MAP_FAILED) {
+			close(fd);
+			return CNMEAParserData::ERROR_FAIL;
+		}
+#if defined(MADV_SEQUENTIAL)
+		madvise(pMapping, (size_t)Stat.st_size, MADV_SEQUENTIAL);
+#endif
+		m_pMapping = pMapping;
+		m_pData = (const char *)pMapping;
+		m_nSize = (size_t)Stat.st_size;
+	}
+	close(fd);
+#endif
+
+	return CNMEAParserData::ERROR_OK;
+}
+
+void CNMEAParserLog::Close(void)
+{
+#if !defined(_WIN32)
+	if (m_pMapping != NULL) {
+		munmap(m_pMapping, m_nSize);
+	}
+#endif
+	m_pMapping = NULL;
+	m_Buffer.clear();
+	m_pData = NULL;
+	m_nSize = 0;
+}
+
+CNMEAParserData::ERROR_E CNMEAParserLog::Process(CNMEAParserLogSink *pSink, int nThreads, size_t nChunkSize)
+{
+	return ProcessBuffer(m_pData, m_nSize, pSink, nThreads, nChunkSize);
+}
+
+CNMEAParserData::ERROR_E CNMEAParserLog::ProcessBuffer(const char *pData, size_t nSize, CNMEAParserLogSink *pSink, int nThreads, size_t nChunkSize)
+{
+	if (pSink == NULL) {
+		return CNMEAParserData::ERROR_FAIL;
+	}
+
+	Split(pData, nSize, (nChunkSize == 0) ? c_nDefaultChunkSize : nChunkSize);
+	int nChunks = (int)m_Chunks.size();
+	if (nChunks == 0) {
+		return CNMEAParserData::ERROR_OK;
+	}
+
+	if (nThreads <= 0) {
+		nThreads = (int)std::thread::hardware_concurrency();
+		if (nThreads <= 0) {
+			nThreads = 1;
+		}
+	}
+	if (nThreads > nChunks) {
+		nThreads = nChunks;
+	}
+
+	//
+	// Workers take the chunks in file order, so the merge below rarely waits for a late chunk
+	//
+	std::atomic<int> nNextChunk(0);
+	std::vector<char> Done(nChunks, 0);
+	std::mutex Mutex;
+	std::condition_variable DoneCondition;
+
+	std::vector<std::thread> Workers;
+	for (int i = 0; i < nThreads; i++) {
+		Workers.push_back(std::thread([&]() {
+			CNMEAParserLogChunk Parser(pSink);
+			int nChunk;
+			while ((nChunk = nNextChunk++) < nChunks) {
+				size_t nEnd = (nChunk + 1 < nChunks) ? m_Chunks[nChunk + 1] : nSize;
+				Parser.ParseChunk(nChunk, pData, GetPrimeOffset(pData, nChunk), m_Chunks[nChunk], nEnd, nSize);
+				{
+					std::lock_guard<std::mutex> Lock(Mutex);
+					Done[nChunk] = 1;
+				}
+				DoneCondition.notify_all();
+			}
+		}));
+	}
+
+	for (int nChunk = 0; nChunk < nChunks; nChunk++) {
+		{
+			std::unique_lock<std::mutex> Lock(Mutex);
+			while (!Done[nChunk]) {
+				DoneCondition.wait(Lock);
+			}
+		}
+		pSink->OnChunkEnd(nChunk);
+	}
+
+	for (size_t i = 0; i < Workers.size(); i++) {
+		Workers[i].join();
+	}
+	return CNMEAParserData::ERROR_OK;
+}
+
+void CNMEAParserLog::Split(const char *pData, size_t nSize, size_t nChunkSize)
+{
+	m_Chunks.clear();
+	if (nSize == 0) {
+		return;
+	}
+
+	//
+	// The first chunk starts at the start of the log, whatever is there. Every other chunk starts
+	// at the first '$' or '!' after its nominal start, a chunk that has none is merged into the one
+	// before. A tag block right in front of the sentence belongs to it, the chunk then starts at the
+	// backslash that opens it.
+	//
+	m_Chunks.push_back(0);
+	for (size_t nOffset = nChunkSize; nOffset < nSize; nOffset += nChunkSize) {
+		nOffset += CNMEAParserScan::FindChar2(&pData[nOffset], nSize - nOffset, '$', '!');
+		if (nOffset >= nSize) {
+			break;
+		}
+		if (pData[nOffset - 1] == '\\') {
+			for (size_t n = 2; (n <= CNMEAParserData::c_uMaxTagLen + 1) && (nOffset - n > m_Chunks.back()); n++) {
+				if (pData[nOffset - n] == '\\') {
+					nOffset -= n;
+					break;
+				}
+			}
+		}
+		m_Chunks.push_back(nOffset);
+	}
+}
+
+size_t CNMEAParserLog::GetPrimeOffset(const char *pData, int nChunk) const
+{
+	size_t nStart = m_Chunks[nChunk];
+	if ((nChunk == 0) || (m_nPrimeSize == 0)) {
+		return nStart;
+	}
+
+	//
+	// At most m_nPrimeSize bytes back and not before the chunk before, from the first '$' or '!'
+	// there. Without one the chunk is not primed.
+	//
+	size_t nPrevious = m_Chunks[nChunk - 1];
+	if (nStart - nPrevious <= m_nPrimeSize) {
+		return nPrevious;
+	}
+	size_t nPrime = nStart - m_nPrimeSize;
+	return nPrime + CNMEAParserScan::FindChar2(&pData[nPrime], nStart - nPrime, '$', '!');
+}
@@ -0,0 +1,208 @@
+/*
+* MIT License
+*
+*  Copyright (c) 2018 VisualGPS, LLC
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this software and associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright notice and this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*
+*/
+#pragma once
+#include <cstddef>
+#include <stdint.h>
+#include <vector>
+
+#include "NMEAParserData.h"
+#include "NMEAParser.h"
+
+///
+/// \class CNMEAParserLogSink
+/// \brief Receives the results of CNMEAParserLog::Process().
+///
+/// The log is split into chunks that are parsed in parallel. OnChunkStart(), OnSentence(), OnEpoch(),
+/// OnAISMessage() and OnError() are called from the worker that parses a chunk: the calls for one chunk
+/// are in file order, but calls for different chunks run concurrently. Collect the results of each chunk
+/// separately and merge them in OnChunkEnd(), which is called from the thread that called Process(), once
+/// per chunk and in file order.
+///
+class CNMEAParserLogSink
+{
+public:
+	virtual ~CNMEAParserLogSink() {}
+
+	///
+	/// \brief Called before a chunk is parsed.
+	///
+	/// The parser is reset before every chunk. Configure it here, for example with SetEpochAssembly(),
+	/// if the same settings are needed for every chunk. It is then primed with the tail of the chunk
+	/// before, see CNMEAParserLog::SetPrimeSize().
+	///
+	/// \param nChunk Index of the chunk, counting from zero in file order
+	/// \param Parser Parser of the chunk
+	///
+	virtual void OnChunkStart(int nChunk, CNMEAParser &Parser) { UNUSED_PARAM(nChunk); UNUSED_PARAM(Parser); }
+
+	///
+	/// \brief Called for every sentence of a chunk after it is decoded.
+	///
+	/// \param nChunk Index of the chunk
+	/// \param Parser Parser of the chunk. Its GetXXX() methods return the data of this sentence.
+	/// \param Sentence The sentence, it points into the log
+	///
+	virtual void OnSentence(int nChunk, CNMEAParser &Parser, const CNMEAParserData::SENTENCE_VIEW_T &Sentence) = 0;
+
+	///
+	/// \brief Called for every epoch of a chunk that closes, see CNMEAParserDispatcher::SetEpochAssembly().
+	///
+	virtual void OnEpoch(int nChunk, const CNMEAParserData::EPOCH_DATA_T &Epoch) { UNUSED_PARAM(nChunk); UNUSED_PARAM(Epoch); }
+
+	///
+	/// \brief Called for every complete AIS message of a chunk, see CNMEAParserDispatcher::SetAIS().
+	///
+	/// A message whose fragments straddle two chunks is kept if its first fragment is within the
+	/// priming of the second chunk, otherwise it is lost.
+	///
+	virtual void OnAISMessage(int nChunk, const CNMEAParserData::AIS_MESSAGE_T &Message) { UNUSED_PARAM(nChunk); UNUSED_PARAM(Message); }
+
+	///
+	/// \brief Called when a chunk has a framing error or a sentence fails to decode.
+	///
+	/// A sentence that fails to decode is reported here instead of to OnSentence().
+	///
+	/// \param nChunk Index of the chunk
+	/// \param nError The error
+	/// \param pCmd NMEA command of the sentence, as passed to CNMEAParserPacket::OnError(). It may be
+	/// incomplete or empty.
+	///
+	virtual void OnError(int nChunk, CNMEAParserData::ERROR_E nError, const char *pCmd) { UNUSED_PARAM(nChunk); UNUSED_PARAM(nError); UNUSED_PARAM(pCmd); }
+
+	///
+	/// \brief Called in file order once a chunk and every chunk before it are parsed.
+	///
+	/// \param nChunk Index of the chunk
+	///
+	virtual void OnChunkEnd(int nChunk) { UNUSED_PARAM(nChunk); }
+};
+
+///
+/// \class CNMEAParserLog
+/// \brief Parses a recorded NMEA log in parallel.
+///
+/// The log is memory mapped and split into chunks of about the same size. Each chunk starts at a '$' or '!',
+/// so it holds whole sentences and is parsed by its own parser without waiting for the chunk before it.
+/// A sentence that the parser has not finished at the end of a chunk (one without a checksum and line
+/// end, or a corrupt one) is completed by parsing on into the next chunk. The results are merged back
+/// in file order by CNMEAParserLogSink::OnChunkEnd().
+///
+/// The parser of a chunk is reset and then primed with the tail of the chunk before, see SetPrimeSize(),
+/// without reporting it. Data that builds up over several sentences, like the last fix that a GGA
+/// without a fix keeps, the previous GGA for the vertical speed, a GSV group or an epoch, is then the
+/// same as when the whole log is parsed in one go. Only data that goes back further than the priming
+/// can differ at the start of a chunk.
+///
+class CNMEAParserLog
+{
+public:
+	static const size_t				c_nDefaultChunkSize = 4 * 1024 * 1024;		///< Default chunk size in bytes
+	static const size_t				c_nDefaultPrimeSize = 64 * 1024;			///< Default size of the tail of the chunk before that primes a chunk
+
+private:
+	const char *					m_pData;									///< The log, mapped or in m_Buffer
+	size_t							m_nSize;									///< Size of the log in bytes
+	void *							m_pMapping;									///< Memory mapping of the log, NULL if not mapped
+	std::vector<char>				m_Buffer;									///< The log where it cannot be mapped
+	std::vector<size_t>				m_Chunks;									///< Offset of each chunk of the last Process() call
+	size_t							m_nPrimeSize;								///< Bytes of the chunk before that prime a chunk
+
+public:
+	CNMEAParserLog();
+	~CNMEAParserLog();
+
+	///
+	/// \brief Opens and maps a log file
+	///
+	/// \param pszFileName Name of the log file
+	/// \return CNMEAParserData::ERROR_OK if successful, ERROR_FAIL if the file cannot be opened
+	///
+	CNMEAParserData::ERROR_E Open(const char *pszFileName);
+
+	///
+	/// \brief Unmaps the log file
+	///
+	void Close(void);
+
+	///
+	/// \brief Returns the log, or NULL if no log is open
+	///
+	const char *GetData(void) const { return m_pData; }
+
+	///
+	/// \brief Returns the size of the log in bytes
+	///
+	size_t GetSize(void) const { return m_nSize; }
+
+	///
+	/// \brief Returns the number of chunks of the last Process() call
+	///
+	int GetChunkCount(void) const { return (int)m_Chunks.size(); }
+
+	///
+	/// \brief Returns the offset in the log of a chunk of the last Process() call
+	///
+	size_t GetChunkOffset(int nChunk) const { return m_Chunks[nChunk]; }
+
+	///
+	/// \brief Sets how much of the tail of the chunk before primes the parser of a chunk
+	///
+	/// \param nPrimeSize Size in bytes, 0 to start every chunk with a reset parser
+	///
+	void SetPrimeSize(size_t nPrimeSize) { m_nPrimeSize = nPrimeSize; }
+
+	///
+	/// \brief Parses the open log. Returns once every chunk is parsed and merged.
+	///
+	/// \param pSink Receives the results
+	/// \param nThreads Number of worker threads, 0 for one per hardware thread
+	/// \param nChunkSize Approximate chunk size in bytes, 0 for c_nDefaultChunkSize
+	/// \return CNMEAParserData::ERROR_OK if successful, ERROR_FAIL if pSink is NULL
+	///
+	CNMEAParserData::ERROR_E Process(CNMEAParserLogSink *pSink, int nThreads = 0, size_t nChunkSize = 0);
+
+	///
+	/// \brief Parses a log that is already in memory instead of the open log, see Process().
+	///
+	/// \param pData The log
+	/// \param nSize Size of the log in bytes
+	/// \param pSink Receives the results
+	/// \param nThreads Number of worker threads, 0 for one per hardware thread
+	/// \param nChunkSize Approximate chunk size in bytes, 0 for c_nDefaultChunkSize
+	/// \return CNMEAParserData::ERROR_OK if successful, ERROR_FAIL if pSink is NULL
+	///
+	CNMEAParserData::ERROR_E ProcessBuffer(const char *pData, size_t nSize, CNMEAParserLogSink *pSink, int nThreads = 0, size_t nChunkSize = 0);
+
+private:
+	///
+	/// \brief Splits a log into chunks that start at a '$' or '!'
+	///
+	void Split(const char *pData, size_t nSize, size_t nChunkSize);
+
+	///
+	/// \brief Returns where the priming of a chunk starts, its own start if it is not primed
+	///
+	size_t GetPrimeOffset(const char *pData, int nChunk) const;
+};
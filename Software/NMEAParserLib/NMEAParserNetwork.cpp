@@ -0,0 +1,596 @@
+/*
+* MIT License
+*
+*  Copyright (c) 2018 VisualGPS, LLC
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this software and associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright notice and this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*
+*/
+#include "NMEAParserNetwork.h"
+
+#if defined(__linux__)
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+///
+/// epoll user data of the Stop() eventfd
+///
+static const uint32_t c_uWakeupSocket = 0xFFFFFFFF;
+
+///
+/// Largest number of recvmmsg() calls per UDP socket and Poll(), so that a flood on one socket cannot starve the others
+///
+static const int c_nMaxRounds = 4;
+
+///
+/// Largest sender key, see MakeKey()
+///
+static const size_t c_nMaxKeySize = 24;
+
+///
+/// \brief recvmmsg() buffers, kept out of the header to keep the socket headers out of it
+///
+struct CNMEAParserNetwork::BATCH_T {
+	struct mmsghdr					pMessages[c_nBatch];						///< One message per datagram
+	struct iovec					pIOV[c_nBatch];								///< Points into pData
+	struct sockaddr_storage			pNames[c_nBatch];							///< Sender addresses
+	char							pData[c_nBatch][c_nDatagramSize];			///< Datagram data
+};
+
+///
+/// \brief Builds the key of a sender from its address: family, port, address and for IPv6 the scope.
+///
+/// Fields that may change between datagrams of one sender, like the IPv6 flow label, are left out.
+///
+/// \return Length of the key, 0 if the address family is not supported
+///
+static size_t MakeKey(const struct sockaddr_storage *pAddress, char *pKey)
+{
+	uint16_t u16Family = (uint16_t)pAddress->ss_family;
+	memcpy(pKey, &u16Family, sizeof(u16Family));
+
+	if (pAddress->ss_family == AF_INET) {
+		const struct sockaddr_in *pIn = (const struct sockaddr_in *)pAddress;
+		memcpy(pKey + 2, &pIn->sin_port, 2);
+		memcpy(pKey + 4, &pIn->sin_addr, 4);
+		return 8;
+	}
+	if (pAddress->ss_family == AF_INET6) {
+		const struct sockaddr_in6 *pIn6 = (const struct sockaddr_in6 *)pAddress;
+		memcpy(pKey + 2, &pIn6->sin6_port, 2);
+		memcpy(pKey + 4, &pIn6->sin6_addr, 16);
+		memcpy(pKey + 20, &pIn6->sin6_scope_id, 4);
+		return 24;
+	}
+	return 0;
+}
+
+///
+/// \brief Switches a socket to non-blocking mode
+///
+static bool SetNonBlocking(int nFD)
+{
+	int nFlags = fcntl(nFD, F_GETFL);
+	return (nFlags >= 0) && (fcntl(nFD, F_SETFL, nFlags | O_NONBLOCK) == 0);
+}
+
+CNMEAParserNetwork::CNMEAParserNetwork(CNMEAParserStreamSink *pSink, int nMaxSenders) :
+	m_pSink(pSink),
+	m_nMaxSenders(nMaxSenders),
+	m_nEpoll(-1),
+	m_nWakeup(-1),
+	m_nCount(0),
+	m_nLastSender(-1),
+	m_pBatch(new BATCH_T),
+	m_Buffer(c_nReadSize),
+	m_u16LocalPort(0),
+	m_u64Datagrams(0),
+	m_u64ReceiveCalls(0),
+	m_u64Dropped(0),
+	m_bStop(false)
+{
+	BATCH_T &Batch = *m_pBatch;
+	memset(Batch.pMessages, 0, sizeof(Batch.pMessages));
+	for (int i = 0; i < c_nBatch; i++) {
+		Batch.pIOV[i].iov_base = Batch.pData[i];
+		Batch.pIOV[i].iov_len = c_nDatagramSize;
+		Batch.pMessages[i].msg_hdr.msg_iov = &Batch.pIOV[i];
+		Batch.pMessages[i].msg_hdr.msg_iovlen = 1;
+		Batch.pMessages[i].msg_hdr.msg_name = &Batch.pNames[i];
+	}
+
+	m_nEpoll = epoll_create1(EPOLL_CLOEXEC);
+	m_nWakeup = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+	if ((m_nEpoll >= 0) && (m_nWakeup >= 0)) {
+		struct epoll_event Event;
+		Event.events = EPOLLIN;
+		Event.data.u32 = c_uWakeupSocket;
+		epoll_ctl(m_nEpoll, EPOLL_CTL_ADD, m_nWakeup, &Event);
+	}
+}
+
+CNMEAParserNetwork::~CNMEAParserNetwork()
+{
+	for (size_t i = 0; i < m_Sockets.size(); i++) {
+		if (m_Sockets[i].nFD >= 0) {
+			RemoveSocket((int)i);
+		}
+	}
+	if (m_nWakeup >= 0) {
+		close(m_nWakeup);
+	}
+	if (m_nEpoll >= 0) {
+		close(m_nEpoll);
+	}
+}
+
+CNMEAParserData::ERROR_E CNMEAParserNetwork::OpenUDP(uint16_t u16Port, const char *pszAddress)
+{
+	int nFD = Bind(SOCK_DGRAM, u16Port, pszAddress);
+	if (nFD < 0) {
+		return CNMEAParserData::ERROR_FAIL;
+	}
+	return AddSocket(nFD, SOCKET_UDP, -1);
+}
+
+CNMEAParserData::ERROR_E CNMEAParserNetwork::ListenTCP(uint16_t u16Port, const char *pszAddress)
+{
+	int nFD = Bind(SOCK_STREAM, u16Port, pszAddress);
+	if (nFD < 0) {
+		return CNMEAParserData::ERROR_FAIL;
+	}
+	if (listen(nFD, SOMAXCONN) != 0) {
+		close(nFD);
+		return CNMEAParserData::ERROR_FAIL;
+	}
+	return AddSocket(nFD, SOCKET_LISTEN, -1);
+}
+
+CNMEAParserData::ERROR_E CNMEAParserNetwork::ConnectTCP(const char *pszHost, uint16_t u16Port)
+{
+	if ((m_nEpoll < 0) || (pszHost == NULL)) {
+		return CNMEAParserData::ERROR_FAIL;
+	}
+
+	char pszPort[8];
+	snprintf(pszPort, sizeof(pszPort), "%u", (unsigned int)u16Port);
+
+	struct addrinfo Hints;
+	memset(&Hints, 0, sizeof(Hints));
+	Hints.ai_family = AF_UNSPEC;
+	Hints.ai_socktype = SOCK_STREAM;
+
+	struct addrinfo *pList = NULL;
+	if (getaddrinfo(pszHost, pszPort, &Hints, &pList) != 0) {
+		return CNMEAParserData::ERROR_FAIL;
+	}
+
+	//
+	// Try every address of the host, the connect is blocking
+	//
+	int nFD = -1;
+	struct sockaddr_storage Address;
+	for (struct addrinfo *pInfo = pList; pInfo != NULL; pInfo = pInfo->ai_next) {
+		nFD = socket(pInfo->ai_family, pInfo->ai_socktype | SOCK_CLOEXEC, pInfo->ai_protocol);
+		if (nFD < 0) {
+			continue;
+		}
+		if (connect(nFD, pInfo->ai_addr, pInfo->ai_addrlen) == 0) {
+			memset(&Address, 0, sizeof(Address));
+			memcpy(&Address, pInfo->ai_addr, pInfo->ai_addrlen);
+			break;
+		}
+		close(nFD);
+		nFD = -1;
+	}
+	freeaddrinfo(pList);
+
+	if ((nFD < 0) || !SetNonBlocking(nFD)) {
+		if (nFD >= 0) {
+			close(nFD);
+		}
+		return CNMEAParserData::ERROR_FAIL;
+	}
+
+	char pKey[c_nMaxKeySize];
+	size_t nKeyLen = MakeKey(&Address, pKey);
+	int nSender = AddSender(std::string(pKey, nKeyLen));
+	if (nSender < 0) {
+		m_u64Dropped++;
+		close(nFD);
+		return CNMEAParserData::ERROR_FAIL;
+	}
+	if (AddSocket(nFD, SOCKET_TCP, nSender) != CNMEAParserData::ERROR_OK) {
+		m_FreeSenders.push_back(nSender);
+		return CNMEAParserData::ERROR_FAIL;
+	}
+	return CNMEAParserData::ERROR_OK;
+}
+
+int CNMEAParserNetwork::Poll(int nTimeoutMs)
+{
+	if (m_nEpoll < 0) {
+		return -1;
+	}
+
+	struct epoll_event pEvents[c_nMaxEvents];
+	int nEvents = epoll_wait(m_nEpoll, pEvents, c_nMaxEvents, nTimeoutMs);
+	if (nEvents < 0) {
+		return (errno == EINTR) ? 0 : -1;
+	}
+
+	int nRead = 0;
+	for (int i = 0; i < nEvents; i++) {
+		uint32_t uSocket = pEvents[i].data.u32;
+		if (uSocket == c_uWakeupSocket) {
+			uint64_t u64Value;
+			while (read(m_nWakeup, &u64Value, sizeof(u64Value)) > 0) {
+			}
+			continue;
+		}
+
+		//
+		// The socket may have been closed since epoll_wait()
+		//
+		if ((uSocket >= m_Sockets.size()) || (m_Sockets[uSocket].nFD < 0)) {
+			continue;
+		}
+
+		bool bRead = false;
+		switch (m_Sockets[uSocket].nType) {
+		case SOCKET_UDP:
+			bRead = ReadUDP((int)uSocket);
+			break;
+		case SOCKET_LISTEN:
+			bRead = Accept((int)uSocket);
+			break;
+		case SOCKET_TCP:
+			bRead = ReadTCP((int)uSocket, (pEvents[i].events & (EPOLLHUP | EPOLLERR)) != 0);
+			break;
+		}
+		if (bRead) {
+			nRead++;
+		}
+	}
+	return nRead;
+}
+
+void CNMEAParserNetwork::Run(void)
+{
+	while (!m_bStop.load() && (m_nCount > 0)) {
+		if (Poll(-1) < 0) {
+			break;
+		}
+	}
+	m_bStop.store(false);
+}
+
+void CNMEAParserNetwork::Stop(void)
+{
+	m_bStop.store(true);
+	if (m_nWakeup >= 0) {
+		uint64_t u64Value = 1;
+		ssize_t nWritten = write(m_nWakeup, &u64Value, sizeof(u64Value));
+		UNUSED_PARAM(nWritten);
+	}
+}
+
+CNMEAParser *CNMEAParserNetwork::GetParser(int nSender)
+{
+	if ((nSender < 0) || (nSender >= (int)m_Senders.size())) {
+		return NULL;
+	}
+	return &m_Senders[nSender]->Parser;
+}
+
+bool CNMEAParserNetwork::GetSenderName(int nSender, char *pszName, size_t nSize) const
+{
+	if ((nSender < 0) || (nSender >= (int)m_Senders.size()) || (pszName == NULL) || (nSize == 0)) {
+		return false;
+	}
+
+	//
+	// Unpack the key built by MakeKey()
+	//
+	const std::string &Key = m_Senders[nSender]->Address;
+	uint16_t u16Family = 0;
+	uint16_t u16Port = 0;
+	if (Key.size() >= 4) {
+		memcpy(&u16Family, Key.data(), 2);
+		memcpy(&u16Port, Key.data() + 2, 2);
+	}
+
+	char pszAddress[INET6_ADDRSTRLEN];
+	if ((u16Family == AF_INET) && (Key.size() == 8)) {
+		inet_ntop(AF_INET, Key.data() + 4, pszAddress, sizeof(pszAddress));
+		snprintf(pszName, nSize, "%s:%u", pszAddress, (unsigned int)ntohs(u16Port));
+	}
+	else if ((u16Family == AF_INET6) && (Key.size() == 24)) {
+		inet_ntop(AF_INET6, Key.data() + 4, pszAddress, sizeof(pszAddress));
+		snprintf(pszName, nSize, "[%s]:%u", pszAddress, (unsigned int)ntohs(u16Port));
+	}
+	else {
+		snprintf(pszName, nSize, "?");
+	}
+	return true;
+}
+
+uint64_t CNMEAParserNetwork::GetBytesReceived(int nSender) const
+{
+	if ((nSender < 0) || (nSender >= (int)m_Senders.size())) {
+		return 0;
+	}
+	return m_Senders[nSender]->u64Bytes;
+}
+
+CNMEAParserData::ERROR_E CNMEAParserNetwork::AddSocket(int nFD, SOCKET_E nType, int nSender)
+{
+	if (m_nEpoll < 0) {
+		close(nFD);
+		return CNMEAParserData::ERROR_FAIL;
+	}
+
+	//
+	// Reuse a free entry, its index is the epoll user data
+	//
+	int nSocket = -1;
+	for (size_t i = 0; i < m_Sockets.size(); i++) {
+		if (m_Sockets[i].nFD < 0) {
+			nSocket = (int)i;
+			break;
+		}
+	}
+	if (nSocket < 0) {
+		nSocket = (int)m_Sockets.size();
+		m_Sockets.push_back(SOCKET_T());
+	}
+
+	struct epoll_event Event;
+	Event.events = EPOLLIN;
+	Event.data.u32 = (uint32_t)nSocket;
+	if (epoll_ctl(m_nEpoll, EPOLL_CTL_ADD, nFD, &Event) != 0) {
+		close(nFD);
+		m_Sockets[nSocket].nFD = -1;
+		return CNMEAParserData::ERROR_FAIL;
+	}
+
+	m_Sockets[nSocket].nFD = nFD;
+	m_Sockets[nSocket].nType = nType;
+	m_Sockets[nSocket].nSender = nSender;
+	m_nCount++;
+	return CNMEAParserData::ERROR_OK;
+}
+
+void CNMEAParserNetwork::RemoveSocket(int nSocket)
+{
+	SOCKET_T &Socket = m_Sockets[nSocket];
+	epoll_ctl(m_nEpoll, EPOLL_CTL_DEL, Socket.nFD, NULL);
+	close(Socket.nFD);
+	Socket.nFD = -1;
+	m_nCount--;
+}
+
+int CNMEAParserNetwork::Bind(int nType, uint16_t u16Port, const char *pszAddress)
+{
+	if (m_nEpoll < 0) {
+		return -1;
+	}
+
+	char pszPort[8];
+	snprintf(pszPort, sizeof(pszPort), "%u", (unsigned int)u16Port);
+
+	struct addrinfo Hints;
+	memset(&Hints, 0, sizeof(Hints));
+	Hints.ai_family = (pszAddress == NULL) ? AF_INET : AF_UNSPEC;
+	Hints.ai_socktype = nType;
+	Hints.ai_flags = AI_PASSIVE | AI_NUMERICHOST;
+
+	struct addrinfo *pList = NULL;
+	if ((getaddrinfo(pszAddress, pszPort, &Hints, &pList) != 0) || (pList == NULL)) {
+		return -1;
+	}
+
+	int nFD = socket(pList->ai_family, pList->ai_socktype | SOCK_NONBLOCK | SOCK_CLOEXEC, pList->ai_protocol);
+	if (nFD >= 0) {
+		int nOn = 1;
+		setsockopt(nFD, SOL_SOCKET, SO_REUSEADDR, &nOn, sizeof(nOn));
+		if (nType == SOCK_DGRAM) {
+			setsockopt(nFD, SOL_SOCKET, SO_BROADCAST, &nOn, sizeof(nOn));
+		}
+		if (bind(nFD, pList->ai_addr, pList->ai_addrlen) != 0) {
+			close(nFD);
+			nFD = -1;
+		}
+	}
+	freeaddrinfo(pList);
+
+	//
+	// Learn the port when the system picked it
+	//
+	if (nFD >= 0) {
+		struct sockaddr_storage Address;
+		socklen_t nLen = sizeof(Address);
+		if (getsockname(nFD, (struct sockaddr *)&Address, &nLen) == 0) {
+			if (Address.ss_family == AF_INET) {
+				m_u16LocalPort = ntohs(((struct sockaddr_in *)&Address)->sin_port);
+			}
+			else if (Address.ss_family == AF_INET6) {
+				m_u16LocalPort = ntohs(((struct sockaddr_in6 *)&Address)->sin6_port);
+			}
+		}
+	}
+	return nFD;
+}
+
+int CNMEAParserNetwork::AddSender(const std::string &Address)
+{
+	//
+	// Take the number of a closed TCP connection first. Its parser starts over, the settings
+	// made through GetParser() are kept.
+	//
+	if (!m_FreeSenders.empty()) {
+		int nSender = m_FreeSenders.back();
+		m_FreeSenders.pop_back();
+		SENDER_T &Sender = *m_Senders[nSender];
+		Sender.Address = Address;
+		Sender.u64Bytes = 0;
+		Sender.Parser.Reset();
+		Sender.Parser.ResetData();
+		return nSender;
+	}
+
+	if ((int)m_Senders.size() >= m_nMaxSenders) {
+		return -1;
+	}
+
+	int nSender = (int)m_Senders.size();
+	m_Senders.push_back(std::unique_ptr<SENDER_T>(new SENDER_T(nSender, m_pSink)));
+	m_Senders[nSender]->Address = Address;
+	return nSender;
+}
+
+bool CNMEAParserNetwork::ReadUDP(int nSocket)
+{
+	BATCH_T &Batch = *m_pBatch;
+	int nFD = m_Sockets[nSocket].nFD;
+	bool bRead = false;
+
+	for (int nRound = 0; nRound < c_nMaxRounds; nRound++) {
+		for (int i = 0; i < c_nBatch; i++) {
+			Batch.pMessages[i].msg_hdr.msg_namelen = sizeof(struct sockaddr_storage);
+		}
+
+		int nCount = recvmmsg(nFD, Batch.pMessages, c_nBatch, MSG_DONTWAIT, NULL);
+		if (nCount <= 0) {
+			break;
+		}
+		m_u64ReceiveCalls++;
+		m_u64Datagrams += (uint64_t)nCount;
+		bRead = true;
+
+		for (int i = 0; i < nCount; i++) {
+			char pKey[c_nMaxKeySize];
+			size_t nKeyLen = MakeKey(&Batch.pNames[i], pKey);
+
+			//
+			// Senders usually send several datagrams in a row, try the last one before the map
+			//
+			int nSender = m_nLastSender;
+			if ((nSender < 0) || (m_Senders[nSender]->Address.compare(0, std::string::npos, pKey, nKeyLen) != 0)) {
+				std::string Key(pKey, nKeyLen);
+				std::unordered_map<std::string, int>::const_iterator It = m_SenderMap.find(Key);
+				if (It != m_SenderMap.end()) {
+					nSender = It->second;
+				}
+				else {
+					nSender = AddSender(Key);
+					if (nSender < 0) {
+						m_u64Dropped++;
+						continue;
+					}
+					m_SenderMap[Key] = nSender;
+				}
+				m_nLastSender = nSender;
+			}
+
+			size_t nLen = Batch.pMessages[i].msg_len;
+			m_Senders[nSender]->u64Bytes += (uint64_t)nLen;
+			m_Senders[nSender]->Parser.ProcessNMEABuffer(Batch.pData[i], nLen);
+		}
+
+		if (nCount < c_nBatch) {
+			break;
+		}
+	}
+	return bRead;
+}
+
+bool CNMEAParserNetwork::Accept(int nSocket)
+{
+	int nListen = m_Sockets[nSocket].nFD;
+	bool bAccepted = false;
+
+	for (;;) {
+		struct sockaddr_storage Address;
+		socklen_t nLen = sizeof(Address);
+		memset(&Address, 0, sizeof(Address));
+		int nFD = accept4(nListen, (struct sockaddr *)&Address, &nLen, SOCK_NONBLOCK | SOCK_CLOEXEC);
+		if (nFD < 0) {
+			break;
+		}
+		bAccepted = true;
+
+		//
+		// Every connection is a new sender, even from an address that was seen before
+		//
+		char pKey[c_nMaxKeySize];
+		size_t nKeyLen = MakeKey(&Address, pKey);
+		int nSender = AddSender(std::string(pKey, nKeyLen));
+		if (nSender < 0) {
+			m_u64Dropped++;
+			close(nFD);
+			continue;
+		}
+		// AddSocket() closes the connection when it fails, the sender goes back for the next one
+		if (AddSocket(nFD, SOCKET_TCP, nSender) != CNMEAParserData::ERROR_OK) {
+			m_FreeSenders.push_back(nSender);
+			m_u64Dropped++;
+		}
+	}
+	return bAccepted;
+}
+
+bool CNMEAParserNetwork::ReadTCP(int nSocket, bool bHangup)
+{
+	SOCKET_T &Socket = m_Sockets[nSocket];
+	ssize_t nLen = read(Socket.nFD, m_Buffer.data(), m_Buffer.size());
+
+	if (nLen > 0) {
+		SENDER_T &Sender = *m_Senders[Socket.nSender];
+		Sender.u64Bytes += (uint64_t)nLen;
+		Sender.Parser.ProcessNMEABuffer(m_Buffer.data(), (size_t)nLen);
+		return true;
+	}
+
+	int nError = (nLen < 0) ? errno : 0;
+	if (((nError == EAGAIN) || (nError == EWOULDBLOCK) || (nError == EINTR)) && !bHangup) {
+		return false;
+	}
+
+	//
+	// The sender closed the connection or it failed. Its number and parser go to the next new sender,
+	// so the sender limit applies to the connections that are open.
+	//
+	m_FreeSenders.push_back(Socket.nSender);
+	RemoveSocket(nSocket);
+	return false;
+}
+
+#endif
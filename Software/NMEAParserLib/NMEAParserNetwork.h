@@ -0,0 +1,255 @@
+/*
+* MIT License
+*
+*  Copyright (c) 2018 VisualGPS, LLC
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this software and associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright notice and this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*
+*/
+#pragma once
+#include <cstddef>
+#include <stdint.h>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "NMEAParserData.h"
+#include "NMEAParserStream.h"
+
+#if defined(__linux__)
+
+///
+/// \class CNMEAParserNetwork
+/// \brief Receives NMEA sentences over UDP and TCP, with one parser per sender.
+///
+/// UDP sockets are read with recvmmsg(), which takes up to c_nBatch datagrams with a single system call.
+/// Every sender address (IP address and port) gets its own CNMEAParserStream when its first datagram
+/// arrives, so a sentence that a sender splits over two datagrams is put back together and senders do
+/// not mix. TCP connections, accepted with ListenTCP() or made with ConnectTCP(), are a sender each and
+/// their byte stream is framed by their parser in the same way.
+///
+/// The stream ID passed to the sink is the sender number, counting from zero in the order the senders
+/// appeared. At most the number of senders given to the constructor are created; datagrams and
+/// connections from further senders are dropped and counted. When a TCP connection closes, its sender
+/// number is given to the next new sender, with the parser reset. A UDP sender is kept for good.
+///
+/// All sockets are served by one epoll loop, see Poll() and Run(). The sink is called from the thread
+/// that polls. Stop() may be called from any thread, everything else from the polling thread only.
+///
+/// This class is only available on Linux.
+///
+class CNMEAParserNetwork
+{
+public:
+	static const int				c_nBatch = 32;								///< Datagrams received per recvmmsg() call
+	static const size_t				c_nDatagramSize = 2048;						///< Largest datagram, longer ones are truncated
+	static const size_t				c_nReadSize = 65536;						///< Largest single TCP read
+	static const int				c_nMaxEvents = 64;							///< Largest number of events taken from epoll at once
+	static const int				c_nDefaultMaxSenders = 256;					///< Default limit on the number of senders
+
+private:
+	///
+	/// \brief Kinds of sockets
+	///
+	enum SOCKET_E {
+		SOCKET_UDP = 0,															///< UDP socket, read with recvmmsg()
+		SOCKET_LISTEN,															///< TCP socket that accepts connections
+		SOCKET_TCP,																///< TCP connection of one sender
+	};
+
+	///
+	/// \brief An open socket
+	///
+	typedef struct _SOCKET_T {
+		int							nFD;										///< The socket, -1 if the entry is free
+		SOCKET_E					nType;										///< Kind of socket
+		int							nSender;									///< Sender of a SOCKET_TCP socket
+	} SOCKET_T;
+
+	///
+	/// \brief A sender and its parser
+	///
+	typedef struct _SENDER_T {
+		std::string					Address;									///< Address and port of the sender, see MakeKey()
+		CNMEAParserStream			Parser;										///< Parser of the sender
+		uint64_t					u64Bytes;									///< Bytes received from the sender
+
+		_SENDER_T(int nSender, CNMEAParserStreamSink *pSink) : Parser(nSender, pSink), u64Bytes(0) {}
+	} SENDER_T;
+
+	struct BATCH_T;
+
+	CNMEAParserStreamSink *			m_pSink;									///< Receives the sentences of every sender
+	int								m_nMaxSenders;								///< Limit on the number of senders
+	int								m_nEpoll;									///< The epoll instance, -1 if it could not be created
+	int								m_nWakeup;									///< eventfd that wakes epoll_wait() for Stop()
+	std::vector<SOCKET_T>			m_Sockets;									///< Sockets, indexed by the epoll user data
+	int								m_nCount;									///< Number of open sockets
+	std::vector<std::unique_ptr<SENDER_T> >	m_Senders;							///< Senders, indexed by sender number
+	std::unordered_map<std::string, int>	m_SenderMap;						///< UDP sender address to sender number
+	std::vector<int>				m_FreeSenders;								///< Senders of closed TCP connections, reused by AddSender()
+	int								m_nLastSender;								///< UDP sender of the last datagram, checked before m_SenderMap
+	std::unique_ptr<BATCH_T>		m_pBatch;									///< recvmmsg() buffers
+	std::vector<char>				m_Buffer;									///< TCP read buffer
+	uint16_t						m_u16LocalPort;								///< Port of the last socket opened with OpenUDP() or ListenTCP()
+	uint64_t						m_u64Datagrams;								///< Datagrams received
+	uint64_t						m_u64ReceiveCalls;							///< recvmmsg() calls that returned datagrams
+	uint64_t						m_u64Dropped;								///< Datagrams and connections dropped because of the sender limit or epoll
+	std::atomic<bool>				m_bStop;									///< Run() returns when set
+
+public:
+	///
+	/// \param pSink Receives the decoded sentences of every sender. It must outlive this object.
+	/// \param nMaxSenders Limit on the number of senders
+	///
+	explicit CNMEAParserNetwork(CNMEAParserStreamSink *pSink, int nMaxSenders = c_nDefaultMaxSenders);
+	~CNMEAParserNetwork();
+
+	///
+	/// \brief Opens a UDP socket. Broadcast datagrams are received as well.
+	///
+	/// \param u16Port Port to receive on, 0 for any free port (see GetLocalPort())
+	/// \param pszAddress Local IPv4 or IPv6 address to bind to, NULL for every IPv4 address
+	/// \return CNMEAParserData::ERROR_OK if successful, ERROR_FAIL otherwise
+	///
+	CNMEAParserData::ERROR_E OpenUDP(uint16_t u16Port, const char *pszAddress = NULL);
+
+	///
+	/// \brief Opens a TCP socket that accepts connections from senders
+	///
+	/// \param u16Port Port to listen on, 0 for any free port (see GetLocalPort())
+	/// \param pszAddress Local IPv4 or IPv6 address to bind to, NULL for every IPv4 address
+	/// \return CNMEAParserData::ERROR_OK if successful, ERROR_FAIL otherwise
+	///
+	CNMEAParserData::ERROR_E ListenTCP(uint16_t u16Port, const char *pszAddress = NULL);
+
+	///
+	/// \brief Connects to a TCP server that sends NMEA sentences, like an NMEA-over-IP bridge.
+	///
+	/// The connection is one sender. It is not made again when the server closes it.
+	///
+	/// \param pszHost Name or address of the server
+	/// \param u16Port Port of the server
+	/// \return CNMEAParserData::ERROR_OK if successful, ERROR_FAIL otherwise
+	///
+	CNMEAParserData::ERROR_E ConnectTCP(const char *pszHost, uint16_t u16Port);
+
+	///
+	/// \brief Returns the port of the socket opened last with OpenUDP() or ListenTCP()
+	///
+	uint16_t GetLocalPort(void) const { return m_u16LocalPort; }
+
+	///
+	/// \brief Waits for data and reads every socket that has some.
+	///
+	/// A UDP socket is read with up to four recvmmsg() calls, a TCP connection with one read.
+	///
+	/// \param nTimeoutMs Longest time to wait in milliseconds, -1 to wait until there is data
+	/// \return Number of sockets that were read, or -1 if epoll failed
+	///
+	int Poll(int nTimeoutMs);
+
+	///
+	/// \brief Calls Poll() until Stop() is called
+	///
+	void Run(void);
+
+	///
+	/// \brief Makes Run() return. Safe to call from any thread.
+	///
+	void Stop(void);
+
+	///
+	/// \brief Returns the number of sender numbers in use or free for reuse, they count from zero
+	///
+	int GetSenderCount(void) const { return (int)m_Senders.size(); }
+
+	///
+	/// \brief Returns the parser of a sender, or NULL if nSender is not a valid sender number
+	///
+	CNMEAParser *GetParser(int nSender);
+
+	///
+	/// \brief Formats the address of a sender as "address:port"
+	///
+	/// \return true if successful, false if nSender is not a valid sender number
+	///
+	bool GetSenderName(int nSender, char *pszName, size_t nSize) const;
+
+	///
+	/// \brief Returns the number of bytes received from a sender
+	///
+	uint64_t GetBytesReceived(int nSender) const;
+
+	///
+	/// \brief Returns the number of datagrams received
+	///
+	uint64_t GetDatagramCount(void) const { return m_u64Datagrams; }
+
+	///
+	/// \brief Returns the number of recvmmsg() calls that returned datagrams. Compare with GetDatagramCount().
+	///
+	uint64_t GetReceiveCallCount(void) const { return m_u64ReceiveCalls; }
+
+	///
+	/// \brief Returns the number of datagrams and connections dropped because of the sender limit, and of
+	/// connections that could not be added to epoll
+	///
+	uint64_t GetDroppedCount(void) const { return m_u64Dropped; }
+
+private:
+	///
+	/// \brief Adds a socket to the epoll loop
+	///
+	CNMEAParserData::ERROR_E AddSocket(int nFD, SOCKET_E nType, int nSender);
+
+	///
+	/// \brief Closes a socket and removes it from the epoll loop
+	///
+	void RemoveSocket(int nSocket);
+
+	///
+	/// \brief Creates and binds a socket for OpenUDP() and ListenTCP()
+	///
+	int Bind(int nType, uint16_t u16Port, const char *pszAddress);
+
+	///
+	/// \brief Creates a sender or reuses one of a closed TCP connection, returns its number or -1 if the limit is reached
+	///
+	int AddSender(const std::string &Address);
+
+	///
+	/// \brief Reads the datagrams waiting on a UDP socket
+	///
+	bool ReadUDP(int nSocket);
+
+	///
+	/// \brief Accepts the connections waiting on a listening socket
+	///
+	bool Accept(int nSocket);
+
+	///
+	/// \brief Reads a TCP connection once
+	///
+	bool ReadTCP(int nSocket, bool bHangup);
+};
+
+#endif
@@ -0,0 +1,298 @@
+/*
+* MIT License
+*
+*  Copyright (c) 2018 VisualGPS, LLC
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this software and associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright notice and this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*
+*/
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "NMEAParserNumber.h"
+
+///
+/// \brief Powers of ten that are exactly representable as a double.
+///
+static const double c_pdPow10[] = {
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+static const int c_nMaxExactPow10 = 22;
+static const uint64_t c_uMaxExactMantissa = (uint64_t)1 << 53;
+static const int c_nMaxMantissaDigits = 19;
+static const int c_nMaxMinuteDigits = 9;
+
+static inline bool IsDigit(char c)
+{
+	return (c >= '0' && c <= '9');
+}
+
+static inline int TwoDigits(const char *p)
+{
+	return (p[0] - '0') * 10 + (p[1] - '0');
+}
+
+CNMEAParserData::ERROR_E CNMEAParserNumber::ParseDecimal(const CNMEAParserData::FIELD_VIEW_T &Field, double &dValue)
+{
+	const char *p = Field.pField;
+	size_t nLen = Field.nLen;
+	size_t i = 0;
+	bool bNegative = false;
+
+	if (i < nLen && (p[i] == '-' || p[i] == '+')) {
+		bNegative = (p[i] == '-');
+		i++;
+	}
+
+	//
+	// Collect up to 19 significant digits in an integer mantissa. The decimal exponent counts
+	// the fraction digits taken plus any integer digits that did not fit.
+	//
+	uint64_t uMantissa = 0;
+	int nMantissaDigits = 0;
+	int nExponent = 0;
+	int nDigits = 0;
+	bool bTruncated = false;
+	size_t nDigitStart = i;
+
+	for (; i < nLen && IsDigit(p[i]); i++, nDigits++) {
+		if (nMantissaDigits < c_nMaxMantissaDigits) {
+			uMantissa = uMantissa * 10 + (uint64_t)(p[i] - '0');
+			if (uMantissa != 0) {
+				nMantissaDigits++;
+			}
+		}
+		else {
+			nExponent++;
+			bTruncated = true;
+		}
+	}
+	if (i < nLen && p[i] == '.') {
+		i++;
+		for (; i < nLen && IsDigit(p[i]); i++, nDigits++) {
+			if (nMantissaDigits < c_nMaxMantissaDigits) {
+				uMantissa = uMantissa * 10 + (uint64_t)(p[i] - '0');
+				if (uMantissa != 0) {
+					nMantissaDigits++;
+				}
+				nExponent--;
+			}
+			else if (p[i] != '0') {
+				bTruncated = true;
+			}
+		}
+	}
+
+	if (nDigits == 0) {
+		dValue = 0.0;
+		return CNMEAParserData::ERROR_FAIL;
+	}
+
+	double dResult;
+	if (bTruncated == false && uMantissa <= c_uMaxExactMantissa && nExponent <= 0 && nExponent >= -c_nMaxExactPow10) {
+		//
+		// Both the mantissa and the power of ten are exact doubles, so a single division
+		// gives the correctly rounded result.
+		//
+		dResult = (double)uMantissa / c_pdPow10[-nExponent];
+	}
+	else {
+		//
+		// Too many significant digits for the exact path. Rewrite the number as
+		// "<digits>e<exponent>", which strtod() reads the same way in every locale.
+		//
+		char szNumber[CNMEAParserData::c_uMaxDataLen + 16];
+		size_t nOut = 0;
+		int nFracDigits = 0;
+		bool bFraction = false;
+		for (size_t j = nDigitStart; j < i && nOut < CNMEAParserData::c_uMaxDataLen; j++) {
+			if (p[j] == '.') {
+				bFraction = true;
+				continue;
+			}
+			szNumber[nOut++] = p[j];
+			if (bFraction) {
+				nFracDigits++;
+			}
+		}
+		snprintf(&szNumber[nOut], sizeof(szNumber) - nOut, "e%d", -nFracDigits);
+		dResult = strtod(szNumber, NULL);
+	}
+
+	dValue = bNegative ? -dResult : dResult;
+	return (i == nLen) ? CNMEAParserData::ERROR_OK : CNMEAParserData::ERROR_FAIL;
+}
+
+CNMEAParserData::ERROR_E CNMEAParserNumber::ParseInt(const CNMEAParserData::FIELD_VIEW_T &Field, int &nValue)
+{
+	const char *p = Field.pField;
+	size_t nLen = Field.nLen;
+	size_t i = 0;
+	bool bNegative = false;
+
+	if (i < nLen && (p[i] == '-' || p[i] == '+')) {
+		bNegative = (p[i] == '-');
+		i++;
+	}
+
+	size_t nDigitStart = i;
+	long long llValue = 0;
+	for (; i < nLen && IsDigit(p[i]); i++) {
+		if (llValue <= (long long)INT_MAX + 1) {
+			llValue = llValue * 10 + (p[i] - '0');
+		}
+	}
+
+	if (bNegative) {
+		llValue = -llValue;
+	}
+	if (llValue > INT_MAX) {
+		llValue = INT_MAX;
+	}
+	else if (llValue < INT_MIN) {
+		llValue = INT_MIN;
+	}
+	nValue = (int)llValue;
+
+	if (i == nDigitStart) {
+		return CNMEAParserData::ERROR_FAIL;
+	}
+	return (i == nLen) ? CNMEAParserData::ERROR_OK : CNMEAParserData::ERROR_FAIL;
+}
+
+CNMEAParserData::ERROR_E CNMEAParserNumber::ParseCoordinate(const CNMEAParserData::FIELD_VIEW_T &Field, int nDegreeDigits, double &dDegrees)
+{
+	if (nDegreeDigits < 1 || Field.nLen < (size_t)nDegreeDigits) {
+		return CNMEAParserData::ERROR_FAIL;
+	}
+
+	int nDegrees = 0;
+	for (int i = 0; i < nDegreeDigits; i++) {
+		if (IsDigit(Field.pField[i]) == false) {
+			return CNMEAParserData::ERROR_FAIL;
+		}
+		nDegrees = nDegrees * 10 + (Field.pField[i] - '0');
+	}
+
+	double dMinutes = 0.0;
+	CNMEAParserData::FIELD_VIEW_T Minutes;
+	Minutes.pField = Field.pField + nDegreeDigits;
+	Minutes.nLen = Field.nLen - nDegreeDigits;
+	if (Minutes.nLen > 0 && ParseDecimal(Minutes, dMinutes) != CNMEAParserData::ERROR_OK) {
+		return CNMEAParserData::ERROR_FAIL;
+	}
+
+	dDegrees = dMinutes / 60.0;
+	dDegrees += nDegrees;
+	return CNMEAParserData::ERROR_OK;
+}
+
+CNMEAParserData::ERROR_E CNMEAParserNumber::ParseCoordinate(const CNMEAParserData::FIELD_VIEW_T &Field, int nDegreeDigits, int64_t &n64Coordinate)
+{
+	if (nDegreeDigits < 1 || Field.nLen < (size_t)nDegreeDigits) {
+		return CNMEAParserData::ERROR_FAIL;
+	}
+
+	const char *p = Field.pField;
+	size_t nLen = Field.nLen;
+	size_t i = 0;
+
+	int64_t n64Degrees = 0;
+	for (; i < (size_t)nDegreeDigits; i++) {
+		if (IsDigit(p[i]) == false) {
+			return CNMEAParserData::ERROR_FAIL;
+		}
+		n64Degrees = n64Degrees * 10 + (p[i] - '0');
+	}
+
+	// Whole minutes
+	int64_t n64Minutes = 0;
+	for (int nDigits = 0; i < nLen && IsDigit(p[i]); i++, nDigits++) {
+		if (nDigits == c_nMaxMinuteDigits) {
+			return CNMEAParserData::ERROR_FAIL;
+		}
+		n64Minutes = n64Minutes * 10 + (p[i] - '0');
+	}
+
+	// Fraction of a minute, rounded half up to CNMEAParserData::c_n64CoordinateUnitsPerMinute
+	int64_t n64Fraction = 0;
+	int64_t n64Scale = CNMEAParserData::c_n64CoordinateUnitsPerMinute;
+	if (i < nLen && p[i] == '.') {
+		for (i++; i < nLen && IsDigit(p[i]); i++) {
+			if (n64Scale > 1) {
+				n64Scale /= 10;
+				n64Fraction += (p[i] - '0') * n64Scale;
+			}
+			else if (n64Scale == 1) {
+				n64Fraction += (p[i] >= '5') ? 1 : 0;
+				n64Scale = 0;
+			}
+		}
+	}
+	if (i != nLen) {
+		return CNMEAParserData::ERROR_FAIL;
+	}
+
+	n64Coordinate = (n64Degrees * 60 + n64Minutes) * CNMEAParserData::c_n64CoordinateUnitsPerMinute + n64Fraction;
+	return CNMEAParserData::ERROR_OK;
+}
+
+CNMEAParserData::ERROR_E CNMEAParserNumber::ParseTime(const CNMEAParserData::FIELD_VIEW_T &Field, int &nHour, int &nMinute, double &dSecond)
+{
+	if (Field.nLen < 6) {
+		return CNMEAParserData::ERROR_FAIL;
+	}
+	for (int i = 0; i < 6; i++) {
+		if (IsDigit(Field.pField[i]) == false) {
+			return CNMEAParserData::ERROR_FAIL;
+		}
+	}
+
+	double dSec = 0.0;
+	CNMEAParserData::FIELD_VIEW_T Seconds;
+	Seconds.pField = Field.pField + 4;
+	Seconds.nLen = Field.nLen - 4;
+	if (ParseDecimal(Seconds, dSec) != CNMEAParserData::ERROR_OK) {
+		return CNMEAParserData::ERROR_FAIL;
+	}
+
+	nHour = TwoDigits(Field.pField);
+	nMinute = TwoDigits(Field.pField + 2);
+	dSecond = dSec;
+	return CNMEAParserData::ERROR_OK;
+}
+
+CNMEAParserData::ERROR_E CNMEAParserNumber::ParseDate(const CNMEAParserData::FIELD_VIEW_T &Field, int &nDay, int &nMonth, int &nYear)
+{
+	if (Field.nLen != 6) {
+		return CNMEAParserData::ERROR_FAIL;
+	}
+	for (int i = 0; i < 6; i++) {
+		if (IsDigit(Field.pField[i]) == false) {
+			return CNMEAParserData::ERROR_FAIL;
+		}
+	}
+
+	nDay = TwoDigits(Field.pField);
+	nMonth = TwoDigits(Field.pField + 2);
+	nYear = TwoDigits(Field.pField + 4);
+	return CNMEAParserData::ERROR_OK;
+}
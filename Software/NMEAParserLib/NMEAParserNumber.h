@@ -0,0 +1,105 @@
+/*
+* MIT License
+*
+*  Copyright (c) 2018 VisualGPS, LLC
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this software and associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright notice and this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*
+*/
+#pragma once
+#include "NMEAParserData.h"
+
+///
+/// \namespace CNMEAParserNumber
+/// \brief Numeric field parsers used by the sentence decoders.
+///
+/// These parse the number forms found in NMEA fields straight from a field view. The field does
+/// not need to be NUL terminated and the result does not depend on the C locale. Decimal values
+/// are correctly rounded, so they match strtod() in the "C" locale.
+///
+/// Like atof() and atoi(), the value of the longest valid prefix is returned when a field holds
+/// trailing characters; the return code then reports ERROR_FAIL.
+///
+namespace CNMEAParserNumber {
+
+	///
+	/// \brief Parses a fixed point decimal number such as "-32.7", "0.85" or ".5".
+	///
+	/// \param Field Field to parse
+	/// \param dValue Receives the value. 0.0 if the field holds no digits.
+	/// \return ERROR_OK if the whole field is a valid number, ERROR_FAIL otherwise.
+	///
+	CNMEAParserData::ERROR_E ParseDecimal(const CNMEAParserData::FIELD_VIEW_T &Field, double &dValue);
+
+	///
+	/// \brief Parses a signed decimal integer such as "09" or "-12".
+	///
+	/// Values outside the range of an int are clamped.
+	///
+	/// \param Field Field to parse
+	/// \param nValue Receives the value. 0 if the field holds no digits.
+	/// \return ERROR_OK if the whole field is a valid integer, ERROR_FAIL otherwise.
+	///
+	CNMEAParserData::ERROR_E ParseInt(const CNMEAParserData::FIELD_VIEW_T &Field, int &nValue);
+
+	///
+	/// \brief Parses a ddmm.mmmm or dddmm.mmmm coordinate into decimal degrees.
+	///
+	/// \param Field Field to parse
+	/// \param nDegreeDigits Number of degree digits, 2 for latitude and 3 for longitude
+	/// \param dDegrees Receives the unsigned coordinate in decimal degrees. Unchanged on failure.
+	/// \return ERROR_OK if successful
+	///
+	CNMEAParserData::ERROR_E ParseCoordinate(const CNMEAParserData::FIELD_VIEW_T &Field, int nDegreeDigits, double &dDegrees);
+
+	///
+	/// \brief Parses a ddmm.mmmm or dddmm.mmmm coordinate into fixed point units without using floating point.
+	///
+	/// The result is exact for up to 7 decimals of minutes, further decimals are rounded.
+	///
+	/// \param Field Field to parse
+	/// \param nDegreeDigits Number of degree digits, 2 for latitude and 3 for longitude
+	/// \param n64Coordinate Receives the unsigned coordinate in CNMEAParserData::c_n64CoordinateUnitsPerMinute
+	/// units. Unchanged on failure.
+	/// \return ERROR_OK if successful
+	///
+	CNMEAParserData::ERROR_E ParseCoordinate(const CNMEAParserData::FIELD_VIEW_T &Field, int nDegreeDigits, int64_t &n64Coordinate);
+
+	///
+	/// \brief Parses a hhmmss or hhmmss.ss UTC time.
+	///
+	/// \param Field Field to parse
+	/// \param nHour Receives the hour. Unchanged on failure.
+	/// \param nMinute Receives the minute. Unchanged on failure.
+	/// \param dSecond Receives the second including its fraction. Unchanged on failure.
+	/// \return ERROR_OK if successful
+	///
+	CNMEAParserData::ERROR_E ParseTime(const CNMEAParserData::FIELD_VIEW_T &Field, int &nHour, int &nMinute, double &dSecond);
+
+	///
+	/// \brief Parses a ddmmyy date.
+	///
+	/// \param Field Field to parse
+	/// \param nDay Receives the day. Unchanged on failure.
+	/// \param nMonth Receives the month. Unchanged on failure.
+	/// \param nYear Receives the two digit year. Unchanged on failure.
+	/// \return ERROR_OK if successful
+	///
+	CNMEAParserData::ERROR_E ParseDate(const CNMEAParserData::FIELD_VIEW_T &Field, int &nDay, int &nMonth, int &nYear);
+};
@@ -27,6 +27,7 @@
 #include <cstddef>
 #include <stdint.h>
 #include "NMEAParserData.h"
+#include "NMEAParserFramer.h"
 
 ///
 /// \class CNMEAParserPacket
@@ -34,6 +35,13 @@
 ///
 /// Below describes the ProcessNMEABuffer() methods state machine. It's whole goal is to connect data, build a command and call ProcessRxCommand robustly. 
 ///
+/// The start of message, command and data states do not step through the buffer one byte at a time. They
+/// use the CNMEAParserScan block routines to jump to the next '$', ',', '*' or '\\r' and copy/checksum the
+/// run in between. The state transitions are identical to the byte wise machine below.
+///
+/// A sentence starts with '$', or with '!' for encapsulated sentences like AIS !AIVDM. A tag block
+/// (\\s:GP0001*hh\\) in front of it is collected in PARSE_STATE_TAG, see CNMEAParserFramer::GetTagBlock().
+///
 /// \dot Receive Packet State Machine
 ///		digraph example{
 ///  		node[fontname = Helvetica, fontsize = 10];
@@ -44,10 +52,13 @@
 ///			PARSE_STATE_DATA[label = "PARSE_STATE_DATA" URL = "\ref ProcessRxCommand"];
 ///			PARSE_STATE_CHECKSUM_1[label = "PARSE_STATE_CHECKSUM_1" URL = "\ref ProcessRxCommand"];
 ///			PARSE_STATE_CHECKSUM_2[label = "PARSE_STATE_CHECKSUM_2" URL = "\ref ProcessRxCommand"];
+///			PARSE_STATE_TAG[label = "PARSE_STATE_TAG" URL = "\ref ProcessRxCommand"];
 /// 
 ///			ProcessRxCommand[label = "Call Virtual ProcessRxCommand" shape="rectangle" URL = "\ref ProcessRxCommand"];
 ///
 ///			PARSE_STATE_SOM->PARSE_STATE_CMD[arrowhead = "normal", style = "solid"];
+///			PARSE_STATE_SOM->PARSE_STATE_TAG[arrowhead = "normal", style = "solid", label="Tag Block"];
+///			PARSE_STATE_TAG->PARSE_STATE_SOM[arrowhead = "normal", style = "solid"];
 ///			PARSE_STATE_CMD->PARSE_STATE_DATA[arrowhead = "normal", style = "solid"];
 /// 
 ///			PARSE_STATE_DATA->PARSE_STATE_CHECKSUM_1[arrowhead = "normal", style = "solid"];
@@ -62,50 +73,18 @@
 ///		}
 ///  \enddot
 ///  
+/// The state machine lives in CNMEAParserFramer. This class adapts its compile time hooks to the
+/// virtual methods below; derive from CNMEAParserFramer directly to have the hooks inlined.
+///
 
-class CNMEAParserPacket {
-
-private:
-
-	enum PARSE_STATE {
-		PARSE_STATE_SOM = 0,													///< Search for start of message
-		PARSE_STATE_CMD,														///< Get command
-		PARSE_STATE_DATA,														///< Get data
-		PARSE_STATE_CHECKSUM_1,													///< Get first checksum character
-		PARSE_STATE_CHECKSUM_2,													///< get second checksum character
-	};
-
+class CNMEAParserPacket : public CNMEAParserFramer<CNMEAParserPacket> {
 
-private:
-	PARSE_STATE						m_nState;									///< Current NMEA parse state
-	uint8_t							m_u8Checksum;								///< Calculated NMEA sentence checksum
-	uint8_t							m_u8ReceivedChecksum;						///< Received NMEA sentence checksum (if exists)
-	uint16_t						m_nIndex;									///< Index used for command and data
-	char							m_pCommand[CNMEAParserData::c_uMaxCmdLen];	///< NMEA command
-	char							m_pData[CNMEAParserData::c_uMaxDataLen];	///< NMEA data
+	friend class CNMEAParserFramer<CNMEAParserPacket>;
 
 public:
 	CNMEAParserPacket();
 	~CNMEAParserPacket();
 
-	///
-	/// \brief Parses pData for NMEA data.
-	///
-	/// This method will parse pData for NMEA data.
-	/// 
-	/// \param pData Pointer to buffer to parse
-	/// \param nBufferSize Number of bytes in pData to process.
-	/// \return CNMEAParserData::ERROR_E, if successful, ERROR_OK is returned.
-	///
-	CNMEAParserData::ERROR_E ProcessNMEABuffer(char *pData, size_t nBufferSize);
-
-	///
-	/// \brief Reset the parser.
-	///
-	/// A reset will restart the parser to start to look for the start of message.
-	///
-	void Reset(void);
-
 	///
 	/// \brief This method is called whenever there is a parsing error.
 	///
@@ -127,12 +106,24 @@ protected:
 	///
 	virtual CNMEAParserData::ERROR_E ProcessRxCommand(char *pCmd, char *pData) = 0;
 
+	///
+	/// \brief This method is called for valid NMEA sentences when zero-copy mode is enabled.
+	///
+	/// The default implementation copies the sentence into the internal command/data buffers and calls
+	/// ProcessRxCommand(). Redefine this method to work on the sentence in place.
+	///
+	/// \param Sentence View of the NMEA command and its comma separated data. See CNMEAParserData::SENTENCE_VIEW_T.
+	/// \return Returns CNMEAParserData::ERROR_OK If successful
+	///
+	virtual CNMEAParserData::ERROR_E ProcessRxSentence(const CNMEAParserData::SENTENCE_VIEW_T &Sentence);
+
 	///
 	/// \brief This method is called when receiving the start of message of the NMEA packet.
 	///
 	/// If you need to time tag your NMEA sentences, redefine this method to allow 
 	/// you to capture when the SOM was received. You can then use the ProcessRxCommand()
-	/// method to capture the NMEA command that this time-tag belongs to.
+	/// method to capture the NMEA command that this time-tag belongs to. SetTimestamps()
+	/// does this for you with a monotonic clock.
 	///
 	virtual void TimeTag(void) {}
 };
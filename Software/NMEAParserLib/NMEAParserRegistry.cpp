@@ -0,0 +1,292 @@
+/*
+* MIT License
+*
+*  Copyright (c) 2018 VisualGPS, LLC
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this software and associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright notice and this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*
+*/
+#include "NMEAParserRegistry.h"
+
+///
+/// \brief Allocates a decoder of type TSentence
+///
+template <class TSentence>
+static CNMEASentenceBase *CreateSentence(void)
+{
+	return new TSentence();
+}
+
+///
+/// \brief A supported sentence ID and the factory for its decoder
+///
+typedef struct _SENTENCE_TYPE_T {
+	CNMEAParserData::SENTENCE_ID_E	nSentence;									///< Sentence ID
+	CNMEASentenceBase *				(*pfnCreate)(void);							///< Allocates the decoder
+} SENTENCE_TYPE_T;
+
+static const SENTENCE_TYPE_T s_pSentenceTypes[] = {
+#if NMEAPARSER_ENABLE_GGA
+	{ CNMEAParserData::SID_GGA, CreateSentence<CNMEASentenceGGA> },
+#endif
+#if NMEAPARSER_ENABLE_GSA
+	{ CNMEAParserData::SID_GSA, CreateSentence<CNMEASentenceGSA> },
+#endif
+#if NMEAPARSER_ENABLE_GSV
+	{ CNMEAParserData::SID_GSV, CreateSentence<CNMEASentenceGSV> },
+#endif
+#if NMEAPARSER_ENABLE_RMC
+	{ CNMEAParserData::SID_RMC, CreateSentence<CNMEASentenceRMC> },
+#endif
+};
+
+static const int c_nSentenceTypes = (int)(sizeof(s_pSentenceTypes) / sizeof(s_pSentenceTypes[0]));
+
+///
+/// \brief Returns the index of nSentence in s_pSentenceTypes or -1 if it is not supported
+///
+static int FindSentenceType(CNMEAParserData::SENTENCE_ID_E nSentence)
+{
+	for (int i = 0; i < c_nSentenceTypes; i++) {
+		if (s_pSentenceTypes[i].nSentence == nSentence) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+///
+/// \brief Talker IDs that get a slot when auto create is on
+///
+static const CNMEAParserData::TALKER_ID_E s_pTalkers[] = {
+	CNMEAParserData::TID_AB, CNMEAParserData::TID_AD, CNMEAParserData::TID_AG, CNMEAParserData::TID_AP,
+	CNMEAParserData::TID_BD, CNMEAParserData::TID_BN, CNMEAParserData::TID_CC, CNMEAParserData::TID_CD,
+	CNMEAParserData::TID_CM, CNMEAParserData::TID_CS, CNMEAParserData::TID_CT, CNMEAParserData::TID_CV,
+	CNMEAParserData::TID_CX, CNMEAParserData::TID_DE, CNMEAParserData::TID_DF, CNMEAParserData::TID_DU,
+	CNMEAParserData::TID_EC, CNMEAParserData::TID_EP, CNMEAParserData::TID_ER, CNMEAParserData::TID_GA,
+	CNMEAParserData::TID_GB, CNMEAParserData::TID_GI, CNMEAParserData::TID_GL, CNMEAParserData::TID_GN,
+	CNMEAParserData::TID_GP, CNMEAParserData::TID_GQ, CNMEAParserData::TID_HC, CNMEAParserData::TID_HE,
+	CNMEAParserData::TID_HN, CNMEAParserData::TID_II, CNMEAParserData::TID_IN, CNMEAParserData::TID_LA,
+	CNMEAParserData::TID_LC, CNMEAParserData::TID_MP, CNMEAParserData::TID_NL, CNMEAParserData::TID_OM,
+	CNMEAParserData::TID_OS, CNMEAParserData::TID_QZ, CNMEAParserData::TID_RA, CNMEAParserData::TID_SD,
+	CNMEAParserData::TID_SN, CNMEAParserData::TID_SS, CNMEAParserData::TID_TI, CNMEAParserData::TID_TR,
+	CNMEAParserData::TID_U0, CNMEAParserData::TID_U1, CNMEAParserData::TID_U2, CNMEAParserData::TID_U3,
+	CNMEAParserData::TID_U4, CNMEAParserData::TID_U5, CNMEAParserData::TID_U6, CNMEAParserData::TID_U7,
+	CNMEAParserData::TID_U8, CNMEAParserData::TID_U9, CNMEAParserData::TID_UP, CNMEAParserData::TID_VD,
+	CNMEAParserData::TID_DM, CNMEAParserData::TID_VW, CNMEAParserData::TID_WI, CNMEAParserData::TID_YC,
+	CNMEAParserData::TID_YD, CNMEAParserData::TID_YF, CNMEAParserData::TID_YL, CNMEAParserData::TID_YP,
+	CNMEAParserData::TID_YR, CNMEAParserData::TID_YT, CNMEAParserData::TID_YV, CNMEAParserData::TID_YX,
+	CNMEAParserData::TID_ZA, CNMEAParserData::TID_ZC, CNMEAParserData::TID_ZQ, CNMEAParserData::TID_ZV,
+};
+
+static const int c_nTalkers = (int)(sizeof(s_pTalkers) / sizeof(s_pTalkers[0]));
+
+CNMEAParserRegistry::CNMEAParserRegistry() :
+	m_nSlotCount(0),
+	m_uDefaultSubscribed(0xFFFFFFFF),
+	m_bAutoCreate(true),
+	m_bLazyDecode(false)
+{
+	for (int i = 0; i < c_nMaskWords; i++) {
+		m_puSubscribed[i].store(0, std::memory_order_relaxed);
+	}
+}
+
+CNMEAParserRegistry::~CNMEAParserRegistry()
+{
+	int nCount = m_nSlotCount.load(std::memory_order_relaxed);
+	for (int i = 0; i < nCount; i++) {
+		delete m_pSlots[i].pSentence;
+	}
+}
+
+bool CNMEAParserRegistry::IsSupported(CNMEAParserData::SENTENCE_ID_E nSentence)
+{
+	return FindSentenceType(nSentence) >= 0;
+}
+
+bool CNMEAParserRegistry::IsKnownTalker(CNMEAParserData::TALKER_ID_E nTalker)
+{
+	for (int i = 0; i < c_nTalkers; i++) {
+		if (s_pTalkers[i] == nTalker) {
+			return true;
+		}
+	}
+	return false;
+}
+
+int CNMEAParserRegistry::AddSlot(CNMEAParserData::TALKER_ID_E nTalker, CNMEAParserData::SENTENCE_ID_E nSentence)
+{
+	uint32_t uKey = CNMEAParserHash::MakeKey(nTalker, nSentence);
+	if (uKey == 0) {
+		return -1;
+	}
+
+	uint8_t u8Slot = m_Hash.Find(uKey);
+	if (u8Slot != CNMEAParserHash::c_u8NotFound) {
+		return u8Slot;
+	}
+
+	int nType = FindSentenceType(nSentence);
+	int nSlot = m_nSlotCount.load(std::memory_order_relaxed);
+	if (nType < 0 || nSlot >= c_nMaxSlots || m_Hash.Insert(uKey, (uint8_t)nSlot) == false) {
+		return -1;
+	}
+
+	SLOT_T &Slot = m_pSlots[nSlot];
+	Slot.uKey = uKey;
+	Slot.nTalker = nTalker;
+	Slot.nSentence = nSentence;
+	Slot.pSentence = s_pSentenceTypes[nType].pfnCreate();
+	Slot.pSentence->ResetData();
+	Slot.pSentence->SetLazyDecode(m_bLazyDecode);
+	Slot.nGSASlot = -1;
+	Slot.nType = nType;
+	ApplyDefaultSubscription(nSlot);
+
+	//
+	// A GGA starts a new position update for the GSA of the same talker. Link the two
+	// when the second of them is added.
+	//
+	if (nSentence == CNMEAParserData::SID_GGA) {
+		u8Slot = m_Hash.Find(CNMEAParserHash::MakeKey(nTalker, CNMEAParserData::SID_GSA));
+		Slot.nGSASlot = (u8Slot != CNMEAParserHash::c_u8NotFound) ? u8Slot : -1;
+	}
+	else if (nSentence == CNMEAParserData::SID_GSA) {
+		u8Slot = m_Hash.Find(CNMEAParserHash::MakeKey(nTalker, CNMEAParserData::SID_GGA));
+		if (u8Slot != CNMEAParserHash::c_u8NotFound) {
+			m_pSlots[u8Slot].nGSASlot = nSlot;
+		}
+	}
+
+	m_nSlotCount.store(nSlot + 1, std::memory_order_seq_cst);
+
+	//
+	// SetSubscribed(nSentence) may have changed the default after it was applied above
+	// but before this slot was visible to it.
+	//
+	ApplyDefaultSubscription(nSlot);
+	return nSlot;
+}
+
+int CNMEAParserRegistry::AddSlot(const char *pCmd, size_t nCmdLen)
+{
+	//
+	// Proprietary sentences ($Pxxxx) have no talker ID. Any other address must name a known
+	// talker, so that a corrupt one with a valid checksum does not use up a slot for good.
+	//
+	if ((nCmdLen != 5) || (pCmd[0] == 'P')) {
+		return -1;
+	}
+	CNMEAParserData::TALKER_ID_E nTalker = (CNMEAParserData::TALKER_ID_E)((uint16_t)(uint8_t)pCmd[0] << 8 | (uint16_t)(uint8_t)pCmd[1]);
+	CNMEAParserData::SENTENCE_ID_E nSentence = (CNMEAParserData::SENTENCE_ID_E)((uint32_t)(uint8_t)pCmd[2] << 16 | (uint32_t)(uint8_t)pCmd[3] << 8 | (uint32_t)(uint8_t)pCmd[4]);
+	if ((FindSentenceType(nSentence) < 0) || !IsKnownTalker(nTalker)) {
+		return -1;
+	}
+	return AddSlot(nTalker, nSentence);
+}
+
+const CNMEAParserRegistry::SLOT_T * CNMEAParserRegistry::FindSlot(CNMEAParserData::TALKER_ID_E nTalker, CNMEAParserData::SENTENCE_ID_E nSentence) const
+{
+	//
+	// Readers on other threads cannot use the hash because the parsing thread may be
+	// rebuilding it. The slot table only grows, so a scan of the published slots is safe.
+	//
+	uint32_t uKey = CNMEAParserHash::MakeKey(nTalker, nSentence);
+	int nCount = m_nSlotCount.load(std::memory_order_acquire);
+	for (int i = 0; i < nCount; i++) {
+		if (m_pSlots[i].uKey == uKey) {
+			return &m_pSlots[i];
+		}
+	}
+	return NULL;
+}
+
+void CNMEAParserRegistry::ResetData(void)
+{
+	int nCount = m_nSlotCount.load(std::memory_order_acquire);
+	for (int i = 0; i < nCount; i++) {
+		m_pSlots[i].pSentence->ResetData();
+	}
+}
+
+void CNMEAParserRegistry::SetLazyDecode(bool bLazy)
+{
+	m_bLazyDecode = bLazy;
+	int nCount = m_nSlotCount.load(std::memory_order_acquire);
+	for (int i = 0; i < nCount; i++) {
+		m_pSlots[i].pSentence->SetLazyDecode(bLazy);
+	}
+}
+
+bool CNMEAParserRegistry::IsSubscribed(CNMEAParserData::TALKER_ID_E nTalker, CNMEAParserData::SENTENCE_ID_E nSentence) const
+{
+	const SLOT_T *pSlot = FindSlot(nTalker, nSentence);
+	return (pSlot != NULL) && IsSubscribed((int)(pSlot - m_pSlots));
+}
+
+bool CNMEAParserRegistry::SetSubscribed(CNMEAParserData::TALKER_ID_E nTalker, CNMEAParserData::SENTENCE_ID_E nSentence, bool bSubscribed)
+{
+	const SLOT_T *pSlot = FindSlot(nTalker, nSentence);
+	if (pSlot == NULL) {
+		return false;
+	}
+	SetSlotSubscribed((int)(pSlot - m_pSlots), bSubscribed);
+	return true;
+}
+
+bool CNMEAParserRegistry::SetSubscribed(CNMEAParserData::SENTENCE_ID_E nSentence, bool bSubscribed)
+{
+	int nType = FindSentenceType(nSentence);
+	if (nType < 0) {
+		return false;
+	}
+
+	if (bSubscribed) {
+		m_uDefaultSubscribed.fetch_or((uint32_t)1 << nType);
+	}
+	else {
+		m_uDefaultSubscribed.fetch_and(~((uint32_t)1 << nType));
+	}
+
+	int nCount = m_nSlotCount.load(std::memory_order_seq_cst);
+	for (int i = 0; i < nCount; i++) {
+		if (m_pSlots[i].nType == nType) {
+			SetSlotSubscribed(i, bSubscribed);
+		}
+	}
+	return true;
+}
+
+void CNMEAParserRegistry::SetSlotSubscribed(int nSlot, bool bSubscribed)
+{
+	uint32_t uBit = (uint32_t)1 << (nSlot & 31);
+	if (bSubscribed) {
+		m_puSubscribed[nSlot >> 5].fetch_or(uBit, std::memory_order_relaxed);
+	}
+	else {
+		m_puSubscribed[nSlot >> 5].fetch_and(~uBit, std::memory_order_relaxed);
+	}
+}
+
+void CNMEAParserRegistry::ApplyDefaultSubscription(int nSlot)
+{
+	uint32_t uDefault = m_uDefaultSubscribed.load(std::memory_order_seq_cst);
+	SetSlotSubscribed(nSlot, (uDefault & ((uint32_t)1 << m_pSlots[nSlot].nType)) != 0);
+}
@@ -0,0 +1,250 @@
+/*
+* MIT License
+*
+*  Copyright (c) 2018 VisualGPS, LLC
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this software and associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright notice and this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*
+*/
+#pragma once
+#include <cstddef>
+#include <stdint.h>
+#include <atomic>
+
+#include "NMEAParserData.h"
+#include "NMEAParserHash.h"
+#include "NMEASentenceGGA.h"
+#include "NMEASentenceGSV.h"
+#include "NMEASentenceGSA.h"
+#include "NMEASentenceRMC.h"
+
+///
+/// \brief Maps a sentence ID to its decoder class and data structure.
+///
+/// CNMEASentenceTraits<SID_GGA>::SENTENCE_T is CNMEASentenceGGA and ::DATA_T is GGA_DATA_T.
+/// LEASE_T is the data a lease points to. It differs from DATA_T only for GSV when
+/// NMEAPARSER_COMPACT_SATELLITES is set.
+///
+template <CNMEAParserData::SENTENCE_ID_E nSentence> struct CNMEASentenceTraits;
+
+template <> struct CNMEASentenceTraits<CNMEAParserData::SID_GGA> {
+	typedef CNMEASentenceGGA				SENTENCE_T;							///< Decoder class
+	typedef CNMEAParserData::GGA_DATA_T		DATA_T;								///< Decoded data
+	typedef CNMEAParserData::GGA_DATA_T		LEASE_T;							///< Leased data
+};
+
+template <> struct CNMEASentenceTraits<CNMEAParserData::SID_GSA> {
+	typedef CNMEASentenceGSA				SENTENCE_T;							///< Decoder class
+	typedef CNMEAParserData::GSA_DATA_T		DATA_T;								///< Decoded data
+	typedef CNMEAParserData::GSA_DATA_T		LEASE_T;							///< Leased data
+};
+
+template <> struct CNMEASentenceTraits<CNMEAParserData::SID_GSV> {
+	typedef CNMEASentenceGSV				SENTENCE_T;							///< Decoder class
+	typedef CNMEAParserData::GSV_DATA_T		DATA_T;								///< Decoded data
+	typedef CNMEASentenceGSV::STORE_T		LEASE_T;							///< Leased data
+};
+
+template <> struct CNMEASentenceTraits<CNMEAParserData::SID_RMC> {
+	typedef CNMEASentenceRMC				SENTENCE_T;							///< Decoder class
+	typedef CNMEAParserData::RMC_DATA_T		DATA_T;								///< Decoded data
+	typedef CNMEAParserData::RMC_DATA_T		LEASE_T;							///< Leased data
+};
+
+///
+/// \class CNMEAParserRegistry
+/// \brief Table of sentence decoders indexed by talker ID and sentence ID.
+///
+/// Every talker/sentence pair that is decoded has a slot. The slots live in one contiguous
+/// array and are found from the packed NMEA address with a perfect hash (CNMEAParserHash).
+/// Slots are added up front with AddSlot() or, when auto create is on, the first time a
+/// sentence with a supported sentence ID arrives from a new known talker (see IsKnownTalker()).
+/// Proprietary sentences ($Pxxxx) never get a slot on their own. The decoder object of a
+/// slot is allocated when the slot is added, so memory grows with the talkers actually seen.
+///
+/// Each slot has a subscription bit. The sentences of unsubscribed slots are framed and
+/// checksummed as usual but not decoded. New slots take the subscription of their sentence ID,
+/// which defaults to subscribed.
+///
+/// Slots are never removed while the registry exists, so slot indexes and decoder addresses
+/// stay valid. Only the parsing thread may add slots. Any thread may look slots up with
+/// FindSlot(CNMEAParserData::TALKER_ID_E, CNMEAParserData::SENTENCE_ID_E).
+///
+class CNMEAParserRegistry
+{
+public:
+	static const int				c_nMaxSlots = CNMEAParserHash::c_nMaxKeys;	///< Maximum number of talker/sentence slots
+
+	///
+	/// \brief A talker/sentence slot
+	///
+	typedef struct _SLOT_T {
+		uint32_t						uKey;									///< Packed address, see CNMEAParserHash::MakeKey()
+		CNMEAParserData::TALKER_ID_E	nTalker;								///< Talker ID
+		CNMEAParserData::SENTENCE_ID_E	nSentence;								///< Sentence ID
+		CNMEASentenceBase *				pSentence;								///< Decoder for this talker/sentence
+		int								nGSASlot;								///< GGA slots only: GSA slot of the same talker, -1 if none
+		int								nType;									///< Index of the sentence ID in the supported sentence table
+	} SLOT_T;
+
+private:
+	static const int				c_nMaskWords = (c_nMaxSlots + 31) / 32;	///< Number of words in the subscription bitmap
+
+	SLOT_T							m_pSlots[c_nMaxSlots];						///< Slot table
+	std::atomic<int>				m_nSlotCount;								///< Number of slots in use
+	std::atomic<uint32_t>			m_puSubscribed[c_nMaskWords];				///< Subscription bitmap, one bit per slot
+	std::atomic<uint32_t>			m_uDefaultSubscribed;						///< Subscription of new slots, one bit per supported sentence ID
+	CNMEAParserHash					m_Hash;										///< Packed address to slot index
+	bool							m_bAutoCreate;								///< Add slots for new talkers while parsing
+	bool							m_bLazyDecode;								///< Lazy decoding for slots that support it
+
+public:
+	CNMEAParserRegistry();
+	~CNMEAParserRegistry();
+
+	///
+	/// \brief Returns true if sentences with ID nSentence can be decoded
+	///
+	static bool IsSupported(CNMEAParserData::SENTENCE_ID_E nSentence);
+
+	///
+	/// \brief Returns true if nTalker is one of CNMEAParserData::TALKER_ID_E. Auto create only adds
+	/// slots for these talkers.
+	///
+	static bool IsKnownTalker(CNMEAParserData::TALKER_ID_E nTalker);
+
+	///
+	/// \brief Adds a slot for a talker/sentence pair. Call from the parsing thread only.
+	///
+	/// A new slot rebuilds the lookup hash (see CNMEAParserHash::Insert()). The rebuild tries up
+	/// to 2 * CNMEAParserHash::c_nMaxAttempts multipliers over all keys, a few tens of microseconds
+	/// with a full table. Add the expected slots up front to keep this off the data path.
+	///
+	/// \param nTalker Talker ID
+	/// \param nSentence Sentence ID, must be supported (see IsSupported())
+	/// \return Index of the new or existing slot, -1 if the sentence is not supported, the table is full or the hash could not be rebuilt.
+	///
+	int AddSlot(CNMEAParserData::TALKER_ID_E nTalker, CNMEAParserData::SENTENCE_ID_E nSentence);
+
+	///
+	/// \brief Finds the slot for an NMEA address, adding it if auto create is on. Call from the parsing thread only.
+	///
+	/// \param pCmd NMEA command (address), does not need to be NUL terminated
+	/// \param nCmdLen Number of characters in pCmd
+	/// \return Slot index or -1 if the address is not decoded.
+	///
+	int FindSlot(const char *pCmd, size_t nCmdLen) {
+		uint8_t u8Slot = m_Hash.Find(CNMEAParserHash::MakeKey(pCmd, nCmdLen));
+		if (u8Slot != CNMEAParserHash::c_u8NotFound) {
+			return u8Slot;
+		}
+		return m_bAutoCreate ? AddSlot(pCmd, nCmdLen) : -1;
+	}
+
+	///
+	/// \brief Finds the slot of a talker/sentence pair. Safe to call from any thread.
+	///
+	/// \return The slot or NULL if there is none.
+	///
+	const SLOT_T *FindSlot(CNMEAParserData::TALKER_ID_E nTalker, CNMEAParserData::SENTENCE_ID_E nSentence) const;
+
+	///
+	/// \brief Returns the number of slots. Safe to call from any thread.
+	///
+	int GetSlotCount(void) const { return m_nSlotCount.load(std::memory_order_acquire); }
+
+	///
+	/// \brief Returns a slot. nSlot must be less than GetSlotCount().
+	///
+	const SLOT_T &GetSlot(int nSlot) const { return m_pSlots[nSlot]; }
+
+	///
+	/// \brief Enables or disables adding slots for new talkers while parsing. Enabled by default.
+	///
+	/// Set this before parsing starts.
+	///
+	void SetAutoCreate(bool bAutoCreate) { m_bAutoCreate = bAutoCreate; }
+
+	///
+	/// \brief Returns true if slots are added for new talkers while parsing
+	///
+	bool GetAutoCreate(void) const { return m_bAutoCreate; }
+
+	///
+	/// \brief Turns lazy decoding on or off for every slot that supports it, including slots added later.
+	///
+	/// Call from the parsing thread or before parsing starts. See CNMEASentenceBase::SetLazyDecode().
+	///
+	void SetLazyDecode(bool bLazy);
+
+	///
+	/// \brief Returns true if lazy decoding is on
+	///
+	bool GetLazyDecode(void) const { return m_bLazyDecode; }
+
+	///
+	/// \brief Returns true if the sentences of a slot should be decoded. Safe to call from any thread.
+	///
+	bool IsSubscribed(int nSlot) const {
+		return (m_puSubscribed[nSlot >> 5].load(std::memory_order_relaxed) & ((uint32_t)1 << (nSlot & 31))) != 0;
+	}
+
+	///
+	/// \brief Returns true if the slot of a talker/sentence pair exists and is subscribed. Safe to call from any thread.
+	///
+	bool IsSubscribed(CNMEAParserData::TALKER_ID_E nTalker, CNMEAParserData::SENTENCE_ID_E nSentence) const;
+
+	///
+	/// \brief Subscribes or unsubscribes the slot of a talker/sentence pair. Safe to call from any thread.
+	///
+	/// \return true if successful, false if there is no slot for the pair.
+	///
+	bool SetSubscribed(CNMEAParserData::TALKER_ID_E nTalker, CNMEAParserData::SENTENCE_ID_E nSentence, bool bSubscribed);
+
+	///
+	/// \brief Subscribes or unsubscribes a sentence ID for every talker, including talkers added later. Safe to call from any thread.
+	///
+	/// \return true if successful, false if the sentence is not supported.
+	///
+	bool SetSubscribed(CNMEAParserData::SENTENCE_ID_E nSentence, bool bSubscribed);
+
+	///
+	/// \brief Resets the data of every slot. The slots themselves are kept.
+	///
+	void ResetData(void);
+
+private:
+	///
+	/// \brief Adds the slot for a packed NMEA address if its sentence ID is supported
+	///
+	int AddSlot(const char *pCmd, size_t nCmdLen);
+
+	///
+	/// \brief Sets or clears the subscription bit of a slot
+	///
+	void SetSlotSubscribed(int nSlot, bool bSubscribed);
+
+	///
+	/// \brief Gives a slot the default subscription of its sentence ID
+	///
+	void ApplyDefaultSubscription(int nSlot);
+
+	CNMEAParserRegistry(const CNMEAParserRegistry &);
+	CNMEAParserRegistry &operator=(const CNMEAParserRegistry &);
+};
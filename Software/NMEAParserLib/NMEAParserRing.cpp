@@ -0,0 +1,142 @@
+/*
+* MIT License
+*
+*  Copyright (c) 2018 VisualGPS, LLC
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this software and associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright notice and this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*
+*/
+#include <string.h>
+#include <chrono>
+#include "NMEAParserRing.h"
+
+CNMEAParserRing::CNMEAParserRing(uint32_t uCapacity) :
+	m_uMask(0),
+	m_uHead(0),
+	m_uTailCache(0),
+	m_uHighWater(0),
+	m_u64Overrun(0),
+	m_uTail(0),
+	m_uHeadCache(0),
+	m_bWaiting(false)
+{
+	uint32_t uSize = 1;
+	while (uSize < uCapacity && uSize < 0x80000000) {
+		uSize <<= 1;
+	}
+	m_Buffer.resize(uSize);
+	m_uMask = uSize - 1;
+}
+
+size_t CNMEAParserRing::Push(const char *pData, size_t nLen)
+{
+	uint32_t uHead = m_uHead.load(std::memory_order_relaxed);
+	uint32_t uCapacity = m_uMask + 1;
+
+	//
+	// Only read the consumer position when the cached one says there is not enough room
+	//
+	if ((size_t)(uCapacity - (uHead - m_uTailCache)) < nLen) {
+		m_uTailCache = m_uTail.load(std::memory_order_acquire);
+	}
+	size_t nFree = (size_t)(uCapacity - (uHead - m_uTailCache));
+
+	size_t nWrite = nLen;
+	if (nWrite > nFree) {
+		m_u64Overrun.fetch_add(nWrite - nFree, std::memory_order_relaxed);
+		nWrite = nFree;
+	}
+
+	if (nWrite > 0) {
+		uint32_t uOffset = uHead & m_uMask;
+		size_t nFirst = (size_t)(uCapacity - uOffset);
+		if (nFirst > nWrite) {
+			nFirst = nWrite;
+		}
+		memcpy(&m_Buffer[uOffset], pData, nFirst);
+		memcpy(&m_Buffer[0], pData + nFirst, nWrite - nFirst);
+
+		uHead += (uint32_t)nWrite;
+		m_uHead.store(uHead, std::memory_order_seq_cst);
+
+		//
+		// The cached consumer position may be old, check a new mark against the current one
+		//
+		uint32_t uUsed = uHead - m_uTailCache;
+		if (uUsed > m_uHighWater.load(std::memory_order_relaxed)) {
+			m_uTailCache = m_uTail.load(std::memory_order_acquire);
+			uUsed = uHead - m_uTailCache;
+			if (uUsed > m_uHighWater.load(std::memory_order_relaxed)) {
+				m_uHighWater.store(uUsed, std::memory_order_relaxed);
+			}
+		}
+
+		//
+		// The consumer sets m_bWaiting before it checks m_uHead, so either it sees the new bytes or
+		// it is woken up here
+		//
+		if (m_bWaiting.load(std::memory_order_seq_cst)) {
+			{
+				std::lock_guard<std::mutex> Lock(m_Mutex);
+			}
+			m_DataCondition.notify_one();
+		}
+	}
+	return nWrite;
+}
+
+size_t CNMEAParserRing::Peek(const char **ppData)
+{
+	uint32_t uTail = m_uTail.load(std::memory_order_relaxed);
+	if (m_uHeadCache == uTail) {
+		m_uHeadCache = m_uHead.load(std::memory_order_acquire);
+		if (m_uHeadCache == uTail) {
+			return 0;
+		}
+	}
+
+	uint32_t uOffset = uTail & m_uMask;
+	size_t nLen = (size_t)(m_uHeadCache - uTail);
+	if (nLen > (size_t)(m_uMask + 1 - uOffset)) {
+		nLen = (size_t)(m_uMask + 1 - uOffset);
+	}
+	*ppData = &m_Buffer[uOffset];
+	return nLen;
+}
+
+void CNMEAParserRing::Release(size_t nLen)
+{
+	m_uTail.store(m_uTail.load(std::memory_order_relaxed) + (uint32_t)nLen, std::memory_order_release);
+}
+
+bool CNMEAParserRing::Wait(uint32_t uTimeoutMs)
+{
+	uint32_t uTail = m_uTail.load(std::memory_order_relaxed);
+	if (m_uHead.load(std::memory_order_acquire) != uTail) {
+		return true;
+	}
+
+	std::unique_lock<std::mutex> Lock(m_Mutex);
+	m_bWaiting.store(true, std::memory_order_seq_cst);
+	bool bData = m_DataCondition.wait_for(Lock, std::chrono::milliseconds(uTimeoutMs), [this, uTail]() {
+		return m_uHead.load(std::memory_order_seq_cst) != uTail;
+	});
+	m_bWaiting.store(false, std::memory_order_relaxed);
+	return bData;
+}
@@ -0,0 +1,150 @@
+/*
+* MIT License
+*
+*  Copyright (c) 2018 VisualGPS, LLC
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this software and associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright notice and this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*
+*/
+#pragma once
+#include <cstddef>
+#include <stdint.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+#include "NMEAParserData.h"
+
+///
+/// \class CNMEAParserRing
+/// \brief Lock-free byte ring that hands received data from an I/O thread to a parser thread.
+///
+/// The I/O thread writes what it reads with Push() and goes back to reading at once. The parser thread
+/// takes the data in batches with Drain(), which passes every contiguous run of waiting bytes to
+/// ProcessNMEABuffer(), or with Peek() and Release(). The ring is bounded: when the parser falls behind
+/// and the ring is full, Push() drops the bytes that do not fit and counts them (see GetOverrunCount()).
+/// GetHighWater() shows how close the ring came to that.
+///
+/// There must be one producer thread and one consumer thread. The producer and consumer positions are
+/// on separate cache lines, and each side keeps a private copy of the other side's position so that it
+/// only reads the shared one when the ring looks full or empty.
+///
+class CNMEAParserRing
+{
+public:
+	static const uint32_t			c_uDefaultCapacity = 65536;					///< Default number of bytes in the ring
+
+private:
+	std::vector<char>				m_Buffer;									///< The ring
+	uint32_t						m_uMask;									///< Capacity - 1
+	alignas(64) std::atomic<uint32_t>	m_uHead;								///< Next byte to write (producer)
+	uint32_t						m_uTailCache;								///< Last m_uTail seen by the producer
+	std::atomic<uint32_t>			m_uHighWater;								///< Most bytes waiting after a Push() (producer)
+	std::atomic<uint64_t>			m_u64Overrun;								///< Bytes dropped because the ring was full (producer)
+	alignas(64) std::atomic<uint32_t>	m_uTail;								///< Next byte to read (consumer)
+	uint32_t						m_uHeadCache;								///< Last m_uHead seen by the consumer
+	std::atomic<bool>				m_bWaiting;									///< The consumer sleeps in Wait()
+	alignas(64) std::mutex			m_Mutex;									///< Protects the sleep in Wait()
+	std::condition_variable			m_DataCondition;							///< Signalled by Push() while the consumer waits
+
+public:
+	///
+	/// \param uCapacity Number of bytes in the ring. Rounded up to a power of two.
+	///
+	explicit CNMEAParserRing(uint32_t uCapacity = c_uDefaultCapacity);
+
+	///
+	/// \brief Writes bytes into the ring. Call from the producer thread only.
+	///
+	/// \param pData Bytes to write
+	/// \param nLen Number of bytes in pData
+	/// \return Number of bytes written. The rest did not fit and was dropped.
+	///
+	size_t Push(const char *pData, size_t nLen);
+
+	///
+	/// \brief Returns the oldest contiguous run of waiting bytes. Call from the consumer thread only.
+	///
+	/// The run ends at the end of the ring, call Peek() again after Release() for the bytes that
+	/// wrapped around.
+	///
+	/// \param ppData Receives the first byte of the run
+	/// \return Number of bytes in the run, 0 if the ring is empty
+	///
+	size_t Peek(const char **ppData);
+
+	///
+	/// \brief Frees bytes returned by Peek(). Call from the consumer thread only.
+	///
+	/// \param nLen Number of bytes to free, at most the number returned by Peek()
+	///
+	void Release(size_t nLen);
+
+	///
+	/// \brief Passes every waiting byte to a parser and frees it. Call from the consumer thread only.
+	///
+	/// \param Parser Any parser with a ProcessNMEABuffer(const char *, size_t) method, ie: CNMEAParser
+	/// \return Number of bytes parsed
+	///
+	template <class TParser>
+	size_t Drain(TParser &Parser) {
+		size_t nTotal = 0;
+		const char *pData;
+		size_t nLen;
+		while ((nLen = Peek(&pData)) > 0) {
+			Parser.ProcessNMEABuffer(pData, nLen);
+			Release(nLen);
+			nTotal += nLen;
+		}
+		return nTotal;
+	}
+
+	///
+	/// \brief Waits until bytes are waiting. Call from the consumer thread only.
+	///
+	/// \param uTimeoutMs Longest time to wait in milliseconds
+	/// \return true if bytes are waiting
+	///
+	bool Wait(uint32_t uTimeoutMs);
+
+	///
+	/// \brief Returns the number of bytes waiting. Safe to call from any thread.
+	///
+	size_t GetSize(void) const { return (size_t)(m_uHead.load(std::memory_order_acquire) - m_uTail.load(std::memory_order_acquire)); }
+
+	///
+	/// \brief Returns the number of bytes the ring holds
+	///
+	size_t GetCapacity(void) const { return (size_t)m_uMask + 1; }
+
+	///
+	/// \brief Returns the number of bytes dropped because the ring was full. Safe to call from any thread.
+	///
+	uint64_t GetOverrunCount(void) const { return m_u64Overrun.load(std::memory_order_relaxed); }
+
+	///
+	/// \brief Returns the most bytes that were waiting after a Push(). Safe to call from any thread.
+	///
+	size_t GetHighWater(void) const { return (size_t)m_uHighWater.load(std::memory_order_relaxed); }
+
+	///
+	/// \brief Starts a new high water mark measurement. A Push() at the same time may be missed.
+	///
+	void ResetHighWater(void) { m_uHighWater.store(0, std::memory_order_relaxed); }
+};
@@ -0,0 +1,167 @@
+/*
+* MIT License
+*
+*  Copyright (c) 2018 VisualGPS, LLC
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this software and associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright notice and this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*
+*/
+#include "NMEAParserSatellites.h"
+
+namespace {
+
+	///
+	/// \brief Rounds to the nearest integer and clamps the result to nMin - nMax
+	///
+	int RoundClamp(double dValue, int nMin, int nMax)
+	{
+		if (!(dValue > nMin)) {											// Also catches NaN
+			return nMin;
+		}
+		if (dValue >= nMax) {
+			return nMax;
+		}
+		return (int)(dValue + 0.5);
+	}
+
+	///
+	/// \brief Clamps nValue to nMin - nMax
+	///
+	int Clamp(int nValue, int nMin, int nMax)
+	{
+		return (nValue < nMin) ? nMin : ((nValue > nMax) ? nMax : nValue);
+	}
+
+	///
+	/// \brief Appends a compact satellite record to a view
+	///
+	void AddToView(const CNMEAParserData::SAT_INFO_COMPACT_T &Compact, CNMEAParserData::SAT_VIEW_T &View)
+	{
+		int n = View.nCount++;
+		View.pu16PRN[n] = Compact.u16PRN;
+		View.pu16Azimuth[n] = Compact.u16Azimuth;
+		View.ps8Elevation[n] = Compact.s8Elevation;
+		View.pu8SNR[n] = Compact.u8SNR;
+	}
+}
+
+void CNMEAParserSatellites::ToCompact(const CNMEAParserData::SAT_INFO_T &Sat, CNMEAParserData::SAT_INFO_COMPACT_T &Compact)
+{
+	Compact.u16PRN = (uint16_t)Clamp(Sat.nPRN, 0, 0xFFFF);
+	Compact.u16Azimuth = (uint16_t)RoundClamp(Sat.dAzimuth, 0, 0xFFFF);
+	Compact.s8Elevation = (int8_t)RoundClamp(Sat.dElevation, -90, 90);
+	Compact.u8SNR = (uint8_t)Clamp(Sat.nSNR, 0, 0xFF);
+}
+
+void CNMEAParserSatellites::FromCompact(const CNMEAParserData::SAT_INFO_COMPACT_T &Compact, CNMEAParserData::SAT_INFO_T &Sat)
+{
+	Sat.nPRN = Compact.u16PRN;
+	Sat.dAzimuth = Compact.u16Azimuth;
+	Sat.dElevation = Compact.s8Elevation;
+	Sat.nSNR = Compact.u8SNR;
+}
+
+void CNMEAParserSatellites::ToCompact(const CNMEAParserData::GSV_DATA_T &Data, CNMEAParserData::GSV_COMPACT_T &Compact)
+{
+	Compact.u8TotalNumberOfSentences = (uint8_t)Clamp(Data.nTotalNumberOfSentences, 0, 0xFF);
+	Compact.u8SentenceNumber = (uint8_t)Clamp(Data.nSentenceNumber, 0, 0xFF);
+	Compact.u16SatsInView = (uint16_t)Clamp(Data.nSatsInView, 0, 0xFFFF);
+	for (int i = 0; i < CNMEAParserData::c_nMaxConstellation; i++) {
+		ToCompact(Data.SatInfo[i], Compact.SatInfo[i]);
+	}
+}
+
+void CNMEAParserSatellites::FromCompact(const CNMEAParserData::GSV_COMPACT_T &Compact, CNMEAParserData::GSV_DATA_T &Data)
+{
+	Data.nTotalNumberOfSentences = Compact.u8TotalNumberOfSentences;
+	Data.nSentenceNumber = Compact.u8SentenceNumber;
+	Data.nSatsInView = Compact.u16SatsInView;
+	for (int i = 0; i < CNMEAParserData::c_nMaxConstellation; i++) {
+		FromCompact(Compact.SatInfo[i], Data.SatInfo[i]);
+	}
+}
+
+int CNMEAParserSatellites::BuildView(const CNMEAParserData::GSV_COMPACT_T &Compact, CNMEAParserData::SAT_VIEW_T &View)
+{
+	int nSats = ((Compact.u16SatsInView > 0) && (Compact.u16SatsInView < CNMEAParserData::c_nMaxConstellation)) ? Compact.u16SatsInView : CNMEAParserData::c_nMaxConstellation;
+
+	View.nCount = 0;
+	for (int i = 0; i < nSats; i++) {
+		if (Compact.SatInfo[i].u16PRN != CNMEAParserData::c_nInvlidPRN) {
+			AddToView(Compact.SatInfo[i], View);
+		}
+	}
+	return View.nCount;
+}
+
+int CNMEAParserSatellites::BuildView(const CNMEAParserData::GSV_DATA_T &Data, CNMEAParserData::SAT_VIEW_T &View)
+{
+	CNMEAParserData::SAT_INFO_COMPACT_T Compact;
+
+	int nSats = ((Data.nSatsInView > 0) && (Data.nSatsInView < CNMEAParserData::c_nMaxConstellation)) ? Data.nSatsInView : CNMEAParserData::c_nMaxConstellation;
+
+	View.nCount = 0;
+	for (int i = 0; i < nSats; i++) {
+		if (Data.SatInfo[i].nPRN != CNMEAParserData::c_nInvlidPRN) {
+			ToCompact(Data.SatInfo[i], Compact);
+			AddToView(Compact, View);
+		}
+	}
+	return View.nCount;
+}
+
+CNMEAParserData::CONSTELLATION_E CNMEAParserSatellites::GetConstellation(CNMEAParserData::TALKER_ID_E nTalker)
+{
+	switch (nTalker) {
+	case CNMEAParserData::TID_GP: return CNMEAParserData::CONSTELLATION_GPS;
+	case CNMEAParserData::TID_GL: return CNMEAParserData::CONSTELLATION_GLONASS;
+	case CNMEAParserData::TID_GA: return CNMEAParserData::CONSTELLATION_GALILEO;
+	case CNMEAParserData::TID_BD: return CNMEAParserData::CONSTELLATION_BEIDOU;
+	case CNMEAParserData::TID_GB: return CNMEAParserData::CONSTELLATION_BEIDOU;
+	case CNMEAParserData::TID_QZ: return CNMEAParserData::CONSTELLATION_QZSS;
+	case CNMEAParserData::TID_GQ: return CNMEAParserData::CONSTELLATION_QZSS;
+	case CNMEAParserData::TID_GI: return CNMEAParserData::CONSTELLATION_NAVIC;
+	default: return CNMEAParserData::CONSTELLATION_UNKNOWN;
+	}
+}
+
+CNMEAParserData::CONSTELLATION_E CNMEAParserSatellites::GetPRNConstellation(int nPRN)
+{
+	if (nPRN >= 1 && nPRN <= 64) {
+		return CNMEAParserData::CONSTELLATION_GPS;
+	}
+	if (nPRN >= 65 && nPRN <= 96) {
+		return CNMEAParserData::CONSTELLATION_GLONASS;
+	}
+	if (nPRN >= 193 && nPRN <= 200) {
+		return CNMEAParserData::CONSTELLATION_QZSS;
+	}
+	if ((nPRN >= 201 && nPRN <= 264) || (nPRN >= 401 && nPRN <= 437)) {
+		return CNMEAParserData::CONSTELLATION_BEIDOU;
+	}
+	if (nPRN >= 301 && nPRN <= 336) {
+		return CNMEAParserData::CONSTELLATION_GALILEO;
+	}
+	return CNMEAParserData::CONSTELLATION_UNKNOWN;
+}
+
+CNMEAParserData::CONSTELLATION_E CNMEAParserSatellites::GetSystemConstellation(int nSystemID)
+{
+	return (nSystemID >= 1 && nSystemID < CNMEAParserData::c_nConstellations) ? (CNMEAParserData::CONSTELLATION_E)nSystemID : CNMEAParserData::CONSTELLATION_UNKNOWN;
+}
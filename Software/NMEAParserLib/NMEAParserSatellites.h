@@ -0,0 +1,108 @@
+/*
+* MIT License
+*
+*  Copyright (c) 2018 VisualGPS, LLC
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this software and associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright notice and this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*
+*/
+#pragma once
+#include "NMEAParserData.h"
+
+///
+/// \namespace CNMEAParserSatellites
+/// \brief Conversions between the satellite structures and the compact ones, and constellation lookups.
+///
+/// Going to the compact form rounds to whole degrees and dB-Hz and clamps values that do not fit
+/// the field (elevation to -90 - 90, azimuth to 0 - 65535, SNR to 0 - 255). Going back is exact.
+///
+namespace CNMEAParserSatellites {
+
+	///
+	/// \brief Converts a satellite record to the compact form.
+	/// \param Sat Satellite to convert
+	/// \param Compact Receives the compact record
+	///
+	void ToCompact(const CNMEAParserData::SAT_INFO_T &Sat, CNMEAParserData::SAT_INFO_COMPACT_T &Compact);
+
+	///
+	/// \brief Converts a compact satellite record to SAT_INFO_T.
+	/// \param Compact Compact record to convert
+	/// \param Sat Receives the satellite record
+	///
+	void FromCompact(const CNMEAParserData::SAT_INFO_COMPACT_T &Compact, CNMEAParserData::SAT_INFO_T &Sat);
+
+	///
+	/// \brief Converts GSV data to the compact form.
+	/// \param Data GSV data to convert
+	/// \param Compact Receives the compact data
+	///
+	void ToCompact(const CNMEAParserData::GSV_DATA_T &Data, CNMEAParserData::GSV_COMPACT_T &Compact);
+
+	///
+	/// \brief Converts compact GSV data to GSV_DATA_T.
+	/// \param Compact Compact data to convert
+	/// \param Data Receives the GSV data
+	///
+	void FromCompact(const CNMEAParserData::GSV_COMPACT_T &Compact, CNMEAParserData::GSV_DATA_T &Data);
+
+	///
+	/// \brief Fills a structure of arrays view with the satellites in view (PRN not c_nInvlidPRN),
+	/// at most the satellites in view count when it is not zero.
+	/// \param Compact Compact GSV data
+	/// \param View Receives the view
+	/// \return The number of satellites placed in the view
+	///
+	int BuildView(const CNMEAParserData::GSV_COMPACT_T &Compact, CNMEAParserData::SAT_VIEW_T &View);
+
+	///
+	/// \brief Fills a structure of arrays view with the satellites in view (PRN not c_nInvlidPRN),
+	/// at most the satellites in view count when it is not zero.
+	/// \param Data GSV data
+	/// \param View Receives the view
+	/// \return The number of satellites placed in the view
+	///
+	int BuildView(const CNMEAParserData::GSV_DATA_T &Data, CNMEAParserData::SAT_VIEW_T &View);
+
+	///
+	/// \brief Returns the constellation of a talker ID, ie: CONSTELLATION_GLONASS for TID_GL.
+	/// \param nTalker Talker ID
+	/// \return The constellation, CONSTELLATION_UNKNOWN for mixed (TID_GN) and non GNSS talkers.
+	///
+	CNMEAParserData::CONSTELLATION_E GetConstellation(CNMEAParserData::TALKER_ID_E nTalker);
+
+	///
+	/// \brief Returns the constellation of a PRN from the NMEA 4.0 numbering (GPS 1-32, SBAS 33-64,
+	/// GLONASS 65-96, QZSS 193-200, BeiDou 201-264 and 401-437, Galileo 301-336).
+	///
+	/// NMEA 4.10 and later number the satellites of each constellation from 1, so only use this when
+	/// the talker or system ID does not tell the constellation.
+	///
+	/// \param nPRN Satellite Psudo Random Number
+	/// \return The constellation, CONSTELLATION_UNKNOWN if the PRN is outside of these ranges.
+	///
+	CNMEAParserData::CONSTELLATION_E GetPRNConstellation(int nPRN);
+
+	///
+	/// \brief Returns the constellation of an NMEA 4.10 system ID (last field of GSA and GSV).
+	/// \param nSystemID System ID, 1 GPS, 2 GLONASS, 3 Galileo, 4 BeiDou, 5 QZSS, 6 NavIC
+	/// \return The constellation, CONSTELLATION_UNKNOWN for other values.
+	///
+	CNMEAParserData::CONSTELLATION_E GetSystemConstellation(int nSystemID);
+}
@@ -0,0 +1,290 @@
+/*
+* MIT License
+*
+*  Copyright (c) 2018 VisualGPS, LLC
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this software and associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright notice and this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*
+*/
+#include "NMEAParserScan.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define NMEAPARSER_SCAN_AVX2
+#define NMEAPARSER_SCAN_SSE2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define NMEAPARSER_SCAN_SSE2
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+///
+/// \brief Returns the index of the lowest set bit. uMask must not be zero.
+///
+static inline unsigned int LowestBit(uint32_t uMask)
+{
+#if defined(_MSC_VER)
+	unsigned long ulIndex;
+	_BitScanForward(&ulIndex, uMask);
+	return (unsigned int)ulIndex;
+#else
+	return (unsigned int)__builtin_ctz(uMask);
+#endif
+}
+
+size_t CNMEAParserScan::FindChar(const char *pData, size_t nLen, char cFind)
+{
+	size_t i = 0;
+
+#ifdef NMEAPARSER_SCAN_AVX2
+	const __m256i vFind32 = _mm256_set1_epi8(cFind);
+	for (; i + 32 <= nLen; i += 32) {
+		__m256i vData = _mm256_loadu_si256((const __m256i *)&pData[i]);
+		uint32_t uMask = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(vData, vFind32));
+		if (uMask != 0) {
+			return i + LowestBit(uMask);
+		}
+	}
+#endif
+
+#ifdef NMEAPARSER_SCAN_SSE2
+	const __m128i vFind16 = _mm_set1_epi8(cFind);
+	for (; i + 16 <= nLen; i += 16) {
+		__m128i vData = _mm_loadu_si128((const __m128i *)&pData[i]);
+		uint32_t uMask = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(vData, vFind16));
+		if (uMask != 0) {
+			return i + LowestBit(uMask);
+		}
+	}
+#endif
+
+	for (; i < nLen; i++) {
+		if (pData[i] == cFind) {
+			return i;
+		}
+	}
+	return nLen;
+}
+
+size_t CNMEAParserScan::FindChar2(const char *pData, size_t nLen, char cFind1, char cFind2)
+{
+	size_t i = 0;
+
+#ifdef NMEAPARSER_SCAN_AVX2
+	const __m256i vFind1_32 = _mm256_set1_epi8(cFind1);
+	const __m256i vFind2_32 = _mm256_set1_epi8(cFind2);
+	for (; i + 32 <= nLen; i += 32) {
+		__m256i vData = _mm256_loadu_si256((const __m256i *)&pData[i]);
+		__m256i vHit = _mm256_or_si256(_mm256_cmpeq_epi8(vData, vFind1_32), _mm256_cmpeq_epi8(vData, vFind2_32));
+		uint32_t uMask = (uint32_t)_mm256_movemask_epi8(vHit);
+		if (uMask != 0) {
+			return i + LowestBit(uMask);
+		}
+	}
+#endif
+
+#ifdef NMEAPARSER_SCAN_SSE2
+	const __m128i vFind1_16 = _mm_set1_epi8(cFind1);
+	const __m128i vFind2_16 = _mm_set1_epi8(cFind2);
+	for (; i + 16 <= nLen; i += 16) {
+		__m128i vData = _mm_loadu_si128((const __m128i *)&pData[i]);
+		__m128i vHit = _mm_or_si128(_mm_cmpeq_epi8(vData, vFind1_16), _mm_cmpeq_epi8(vData, vFind2_16));
+		uint32_t uMask = (uint32_t)_mm_movemask_epi8(vHit);
+		if (uMask != 0) {
+			return i + LowestBit(uMask);
+		}
+	}
+#endif
+
+	for (; i < nLen; i++) {
+		if (pData[i] == cFind1 || pData[i] == cFind2) {
+			return i;
+		}
+	}
+	return nLen;
+}
+
+size_t CNMEAParserScan::FindChar3(const char *pData, size_t nLen, char cFind1, char cFind2, char cFind3)
+{
+	size_t i = 0;
+
+#ifdef NMEAPARSER_SCAN_AVX2
+	const __m256i vFind1_32 = _mm256_set1_epi8(cFind1);
+	const __m256i vFind2_32 = _mm256_set1_epi8(cFind2);
+	const __m256i vFind3_32 = _mm256_set1_epi8(cFind3);
+	for (; i + 32 <= nLen; i += 32) {
+		__m256i vData = _mm256_loadu_si256((const __m256i *)&pData[i]);
+		__m256i vHit = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(vData, vFind1_32), _mm256_cmpeq_epi8(vData, vFind2_32)),
+			_mm256_cmpeq_epi8(vData, vFind3_32));
+		uint32_t uMask = (uint32_t)_mm256_movemask_epi8(vHit);
+		if (uMask != 0) {
+			return i + LowestBit(uMask);
+		}
+	}
+#endif
+
+#ifdef NMEAPARSER_SCAN_SSE2
+	const __m128i vFind1_16 = _mm_set1_epi8(cFind1);
+	const __m128i vFind2_16 = _mm_set1_epi8(cFind2);
+	const __m128i vFind3_16 = _mm_set1_epi8(cFind3);
+	for (; i + 16 <= nLen; i += 16) {
+		__m128i vData = _mm_loadu_si128((const __m128i *)&pData[i]);
+		__m128i vHit = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(vData, vFind1_16), _mm_cmpeq_epi8(vData, vFind2_16)),
+			_mm_cmpeq_epi8(vData, vFind3_16));
+		uint32_t uMask = (uint32_t)_mm_movemask_epi8(vHit);
+		if (uMask != 0) {
+			return i + LowestBit(uMask);
+		}
+	}
+#endif
+
+	for (; i < nLen; i++) {
+		if (pData[i] == cFind1 || pData[i] == cFind2 || pData[i] == cFind3) {
+			return i;
+		}
+	}
+	return nLen;
+}
+
+int CNMEAParserScan::FindAll(const char *pData, size_t nLen, char cFind, uint16_t *pu16Offsets, int nMaxOffsets)
+{
+	size_t i = 0;
+	int nCount = 0;
+
+	if (nMaxOffsets <= 0) {
+		return 0;
+	}
+
+#ifdef NMEAPARSER_SCAN_AVX2
+	const __m256i vFind32 = _mm256_set1_epi8(cFind);
+	for (; i + 32 <= nLen; i += 32) {
+		__m256i vData = _mm256_loadu_si256((const __m256i *)&pData[i]);
+		uint32_t uMask = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(vData, vFind32));
+		while (uMask != 0) {
+			pu16Offsets[nCount++] = (uint16_t)(i + LowestBit(uMask));
+			if (nCount >= nMaxOffsets) {
+				return nCount;
+			}
+			uMask &= uMask - 1;
+		}
+	}
+#endif
+
+#ifdef NMEAPARSER_SCAN_SSE2
+	const __m128i vFind16 = _mm_set1_epi8(cFind);
+	for (; i + 16 <= nLen; i += 16) {
+		__m128i vData = _mm_loadu_si128((const __m128i *)&pData[i]);
+		uint32_t uMask = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(vData, vFind16));
+		while (uMask != 0) {
+			pu16Offsets[nCount++] = (uint16_t)(i + LowestBit(uMask));
+			if (nCount >= nMaxOffsets) {
+				return nCount;
+			}
+			uMask &= uMask - 1;
+		}
+	}
+#endif
+
+	for (; i < nLen; i++) {
+		if (pData[i] == cFind) {
+			pu16Offsets[nCount++] = (uint16_t)i;
+			if (nCount >= nMaxOffsets) {
+				return nCount;
+			}
+		}
+	}
+	return nCount;
+}
+
+uint8_t CNMEAParserScan::CopyChecksum(char *pDest, const char *pSrc, size_t nLen)
+{
+	size_t i = 0;
+	uint8_t u8Checksum = 0;
+
+#ifdef NMEAPARSER_SCAN_SSE2
+	__m128i vSum16 = _mm_setzero_si128();
+
+#ifdef NMEAPARSER_SCAN_AVX2
+	__m256i vSum32 = _mm256_setzero_si256();
+	for (; i + 32 <= nLen; i += 32) {
+		__m256i vData = _mm256_loadu_si256((const __m256i *)&pSrc[i]);
+		_mm256_storeu_si256((__m256i *)&pDest[i], vData);
+		vSum32 = _mm256_xor_si256(vSum32, vData);
+	}
+	vSum16 = _mm_xor_si128(_mm256_castsi256_si128(vSum32), _mm256_extracti128_si256(vSum32, 1));
+#endif
+
+	for (; i + 16 <= nLen; i += 16) {
+		__m128i vData = _mm_loadu_si128((const __m128i *)&pSrc[i]);
+		_mm_storeu_si128((__m128i *)&pDest[i], vData);
+		vSum16 = _mm_xor_si128(vSum16, vData);
+	}
+
+	//
+	// Fold the 16 lanes down to a single byte
+	//
+	vSum16 = _mm_xor_si128(vSum16, _mm_srli_si128(vSum16, 8));
+	vSum16 = _mm_xor_si128(vSum16, _mm_srli_si128(vSum16, 4));
+	vSum16 = _mm_xor_si128(vSum16, _mm_srli_si128(vSum16, 2));
+	vSum16 = _mm_xor_si128(vSum16, _mm_srli_si128(vSum16, 1));
+	u8Checksum = (uint8_t)_mm_cvtsi128_si32(vSum16);
+#endif
+
+	for (; i < nLen; i++) {
+		pDest[i] = pSrc[i];
+		u8Checksum ^= (uint8_t)pSrc[i];
+	}
+	return u8Checksum;
+}
+
+uint8_t CNMEAParserScan::Checksum(const char *pData, size_t nLen)
+{
+	size_t i = 0;
+	uint8_t u8Checksum = 0;
+
+#ifdef NMEAPARSER_SCAN_SSE2
+	__m128i vSum16 = _mm_setzero_si128();
+
+#ifdef NMEAPARSER_SCAN_AVX2
+	__m256i vSum32 = _mm256_setzero_si256();
+	for (; i + 32 <= nLen; i += 32) {
+		vSum32 = _mm256_xor_si256(vSum32, _mm256_loadu_si256((const __m256i *)&pData[i]));
+	}
+	vSum16 = _mm_xor_si128(_mm256_castsi256_si128(vSum32), _mm256_extracti128_si256(vSum32, 1));
+#endif
+
+	for (; i + 16 <= nLen; i += 16) {
+		vSum16 = _mm_xor_si128(vSum16, _mm_loadu_si128((const __m128i *)&pData[i]));
+	}
+
+	vSum16 = _mm_xor_si128(vSum16, _mm_srli_si128(vSum16, 8));
+	vSum16 = _mm_xor_si128(vSum16, _mm_srli_si128(vSum16, 4));
+	vSum16 = _mm_xor_si128(vSum16, _mm_srli_si128(vSum16, 2));
+	vSum16 = _mm_xor_si128(vSum16, _mm_srli_si128(vSum16, 1));
+	u8Checksum = (uint8_t)_mm_cvtsi128_si32(vSum16);
+#endif
+
+	for (; i < nLen; i++) {
+		u8Checksum ^= (uint8_t)pData[i];
+	}
+	return u8Checksum;
+}
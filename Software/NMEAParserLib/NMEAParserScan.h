@@ -0,0 +1,107 @@
+/*
+* MIT License
+*
+*  Copyright (c) 2018 VisualGPS, LLC
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this software and associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright notice and this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*
+*/
+
+#pragma once
+#include <cstddef>
+#include <stdint.h>
+
+///
+/// \namespace CNMEAParserScan
+/// \brief Block scanning helpers used by the packet framer.
+///
+/// These routines let CNMEAParserPacket::ProcessNMEABuffer() consume whole runs of sentence
+/// bytes at once instead of visiting every byte through the state machine. Each routine has
+/// an AVX2 (32 byte), SSE2 (16 byte) and scalar implementation. The widest instruction set
+/// enabled by the compiler is selected at build time; the scalar code handles the tail of
+/// every buffer and any target without SIMD support.
+///
+namespace CNMEAParserScan {
+
+	///
+	/// \brief Finds the first occurrence of cFind in pData.
+	///
+	/// \param pData Pointer to buffer to scan
+	/// \param nLen Number of bytes in pData to scan
+	/// \param cFind Character to look for
+	/// \return Offset of the first match or nLen if there is no match.
+	///
+	size_t FindChar(const char *pData, size_t nLen, char cFind);
+
+	///
+	/// \brief Finds the first occurrence of either cFind1 or cFind2 in pData.
+	///
+	/// \param pData Pointer to buffer to scan
+	/// \param nLen Number of bytes in pData to scan
+	/// \param cFind1 First character to look for
+	/// \param cFind2 Second character to look for
+	/// \return Offset of the first match or nLen if there is no match.
+	///
+	size_t FindChar2(const char *pData, size_t nLen, char cFind1, char cFind2);
+
+	///
+	/// \brief Finds the first occurrence of cFind1, cFind2 or cFind3 in pData.
+	///
+	/// \param pData Pointer to buffer to scan
+	/// \param nLen Number of bytes in pData to scan
+	/// \param cFind1 First character to look for
+	/// \param cFind2 Second character to look for
+	/// \param cFind3 Third character to look for
+	/// \return Offset of the first match or nLen if there is no match.
+	///
+	size_t FindChar3(const char *pData, size_t nLen, char cFind1, char cFind2, char cFind3);
+
+	///
+	/// \brief Finds every occurrence of cFind in pData.
+	///
+	/// \param pData Pointer to buffer to scan
+	/// \param nLen Number of bytes in pData to scan, must be less than 65536
+	/// \param cFind Character to look for
+	/// \param pu16Offsets Receives the offset of each match in order
+	/// \param nMaxOffsets Maximum number of offsets to store. Scanning stops once this many matches are found.
+	/// \return Number of offsets stored in pu16Offsets
+	///
+	int FindAll(const char *pData, size_t nLen, char cFind, uint16_t *pu16Offsets, int nMaxOffsets);
+
+	///
+	/// \brief Copies nLen bytes from pSrc to pDest and returns the XOR of the copied bytes.
+	///
+	/// The XOR is the NMEA checksum of the copied run. The buffers must not overlap.
+	///
+	/// \param pDest Destination buffer
+	/// \param pSrc Source buffer
+	/// \param nLen Number of bytes to copy
+	/// \return XOR of all copied bytes
+	///
+	uint8_t CopyChecksum(char *pDest, const char *pSrc, size_t nLen);
+
+	///
+	/// \brief Returns the XOR of nLen bytes in pData (NMEA checksum of the run).
+	///
+	/// \param pData Pointer to buffer
+	/// \param nLen Number of bytes in pData
+	/// \return XOR of all bytes
+	///
+	uint8_t Checksum(const char *pData, size_t nLen);
+};
@@ -0,0 +1,267 @@
+/*
+* MIT License
+*
+*  Copyright (c) 2018 VisualGPS, LLC
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this software and associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright notice and this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*
+*/
+#include <string.h>
+#include "NMEAParserSkyView.h"
+#include "NMEAParserNumber.h"
+#include "NMEAParserSatellites.h"
+
+CNMEAParserSkyView::CNMEAParserSkyView()
+{
+	ResetData();
+}
+
+CNMEAParserSkyView::~CNMEAParserSkyView()
+{
+}
+
+void CNMEAParserSkyView::ProcessSentence(const CNMEAParserRegistry::SLOT_T &Slot, const CNMEAParserData::SENTENCE_VIEW_T &Sentence)
+{
+	switch (Slot.nSentence) {
+	case CNMEAParserData::SID_GGA:
+	case CNMEAParserData::SID_RMC:
+		m_uFix++;
+		break;
+	case CNMEAParserData::SID_GSV: {
+		CNMEAParserFields Fields(Sentence);
+		ProcessGSV(Slot.nTalker, Fields);
+		break;
+	}
+	case CNMEAParserData::SID_GSA: {
+		CNMEAParserFields Fields(Sentence);
+		ProcessGSA(Slot.nTalker, Fields);
+		break;
+	}
+	default:
+		break;
+	}
+}
+
+void CNMEAParserSkyView::ResetData(void)
+{
+	memset(&m_View, 0, sizeof(m_View));
+	memset(m_pu16Signals, 0, sizeof(m_pu16Signals));
+	memset(m_pu16Seen, 0, sizeof(m_pu16Seen));
+	memset(m_ppu64Used, 0, sizeof(m_ppu64Used));
+	memset(m_puUsedFix, 0, sizeof(m_puUsedFix));
+	m_uFix = 0;
+
+	m_Snapshot.Publish(m_View);
+}
+
+void CNMEAParserSkyView::ProcessGSV(CNMEAParserData::TALKER_ID_E nTalker, const CNMEAParserFields &Fields)
+{
+	CNMEAParserData::FIELD_VIEW_T Field;
+	int nTotalNumberOfSentences = 0;
+	int nSentenceNumber = 0;
+
+	if (Fields.GetField(0, Field) == CNMEAParserData::ERROR_OK) {
+		CNMEAParserNumber::ParseInt(Field, nTotalNumberOfSentences);
+	}
+	if (Fields.GetField(1, Field) == CNMEAParserData::ERROR_OK) {
+		CNMEAParserNumber::ParseInt(Field, nSentenceNumber);
+	}
+
+	//
+	// Satellites come in groups of 4 fields after the 3 header fields. One more field is the
+	// NMEA 4.10 signal ID, a single hex digit.
+	//
+	int nCount = Fields.GetCount();
+	int nSignal = 0;
+	if (nCount > 3 && ((nCount - 3) % 4) == 1) {
+		nCount--;
+		if (Fields.GetField(nCount, Field) == CNMEAParserData::ERROR_OK) {
+			char c = Field.pField[0];
+			nSignal = (c >= '0' && c <= '9') ? (c - '0') : ((c >= 'A' && c <= 'F') ? (c - 'A' + 10) : 0);
+		}
+	}
+	uint16_t u16Signal = (uint16_t)(1 << nSignal);
+
+	// The first sentence of a group starts a new list for its signal
+	if (nSentenceNumber == 1) {
+		for (int i = 0; i < m_View.nCount; i++) {
+			if (m_View.pSats[i].u16Talker == (uint16_t)nTalker) {
+				m_pu16Seen[i] &= (uint16_t)~u16Signal;
+			}
+		}
+	}
+
+	CNMEAParserData::CONSTELLATION_E nTalkerConstellation = CNMEAParserSatellites::GetConstellation(nTalker);
+	for (int nField = 3; nField < nCount; nField += 4) {
+		CNMEAParserData::SAT_INFO_T Sat;
+
+		Sat.nPRN = CNMEAParserData::c_nInvlidPRN;
+		if (Fields.GetField(nField, Field) == CNMEAParserData::ERROR_OK) {
+			CNMEAParserNumber::ParseInt(Field, Sat.nPRN);
+		}
+		if (Sat.nPRN <= CNMEAParserData::c_nInvlidPRN) {
+			continue;
+		}
+		Sat.dElevation = 0.0;
+		if (Fields.GetField(nField + 1, Field) == CNMEAParserData::ERROR_OK) {
+			CNMEAParserNumber::ParseDecimal(Field, Sat.dElevation);
+		}
+		Sat.dAzimuth = 0.0;
+		if (Fields.GetField(nField + 2, Field) == CNMEAParserData::ERROR_OK) {
+			CNMEAParserNumber::ParseDecimal(Field, Sat.dAzimuth);
+		}
+		Sat.nSNR = 0;
+		if (Fields.GetField(nField + 3, Field) == CNMEAParserData::ERROR_OK) {
+			CNMEAParserNumber::ParseInt(Field, Sat.nSNR);
+		}
+
+		CNMEAParserData::CONSTELLATION_E nConstellation = nTalkerConstellation;
+		if (nConstellation == CNMEAParserData::CONSTELLATION_UNKNOWN) {
+			nConstellation = CNMEAParserSatellites::GetPRNConstellation(Sat.nPRN);
+		}
+
+		int nIndex = Find(nConstellation, Sat.nPRN);
+		if (nIndex < 0) {
+			if (m_View.nCount >= CNMEAParserData::c_nMaxEpochSatellites) {
+				continue;
+			}
+			nIndex = m_View.nCount++;
+			m_View.pSats[nIndex].u8Constellation = (uint8_t)nConstellation;
+			m_View.pSats[nIndex].u8Flags = 0;
+			m_pu16Signals[nIndex] = 0;
+			m_pu16Seen[nIndex] = 0;
+		}
+		m_View.pSats[nIndex].u16Talker = (uint16_t)nTalker;
+		CNMEAParserSatellites::ToCompact(Sat, m_View.pSats[nIndex].Sat);
+		m_pu16Signals[nIndex] |= u16Signal;
+		m_pu16Seen[nIndex] |= u16Signal;
+	}
+
+	//
+	// The last sentence of a group drops the satellites that the group no longer lists
+	//
+	if (nSentenceNumber == nTotalNumberOfSentences) {
+		for (int i = m_View.nCount - 1; i >= 0; i--) {
+			if (m_View.pSats[i].u16Talker == (uint16_t)nTalker && (m_pu16Seen[i] & u16Signal) == 0) {
+				m_pu16Signals[i] &= (uint16_t)~u16Signal;
+				if (m_pu16Signals[i] == 0) {
+					Remove(i);
+				}
+			}
+		}
+
+		UpdateInUse();
+		m_Snapshot.Publish(m_View);
+	}
+}
+
+void CNMEAParserSkyView::ProcessGSA(CNMEAParserData::TALKER_ID_E nTalker, const CNMEAParserFields &Fields)
+{
+	CNMEAParserData::FIELD_VIEW_T Field;
+
+	//
+	// The constellation comes from the talker, or from the NMEA 4.10 system ID of GN sentences
+	//
+	CNMEAParserData::CONSTELLATION_E nConstellation = CNMEAParserSatellites::GetConstellation(nTalker);
+	int nSystemID = 0;
+	if (nConstellation == CNMEAParserData::CONSTELLATION_UNKNOWN && Fields.GetField(17, Field) == CNMEAParserData::ERROR_OK &&
+		CNMEAParserNumber::ParseInt(Field, nSystemID) == CNMEAParserData::ERROR_OK) {
+		nConstellation = CNMEAParserSatellites::GetSystemConstellation(nSystemID);
+	}
+
+	// A GSA of a known constellation without satellites still clears its list
+	if (nConstellation != CNMEAParserData::CONSTELLATION_UNKNOWN) {
+		StartUsed(nConstellation);
+	}
+
+	// The PRNs are in fields 2 to 13
+	for (int nField = 2; nField < 2 + CNMEAParserData::c_nMaxGSASats; nField++) {
+		int nPRN = CNMEAParserData::c_nInvlidPRN;
+		if (Fields.GetField(nField, Field) != CNMEAParserData::ERROR_OK ||
+			CNMEAParserNumber::ParseInt(Field, nPRN) != CNMEAParserData::ERROR_OK ||
+			nPRN <= CNMEAParserData::c_nInvlidPRN || nPRN > c_nMaxPRN) {
+			continue;
+		}
+
+		CNMEAParserData::CONSTELLATION_E nSatConstellation = nConstellation;
+		if (nSatConstellation == CNMEAParserData::CONSTELLATION_UNKNOWN) {
+			nSatConstellation = CNMEAParserSatellites::GetPRNConstellation(nPRN);
+			if (nSatConstellation == CNMEAParserData::CONSTELLATION_UNKNOWN) {
+				continue;
+			}
+			StartUsed(nSatConstellation);
+		}
+		m_ppu64Used[nSatConstellation][nPRN / 64] |= (uint64_t)1 << (nPRN % 64);
+	}
+
+	UpdateInUse();
+	m_Snapshot.Publish(m_View);
+}
+
+void CNMEAParserSkyView::StartUsed(CNMEAParserData::CONSTELLATION_E nConstellation)
+{
+	// The first GSA of a constellation after a GGA or RMC starts a new list
+	if (m_puUsedFix[nConstellation] != m_uFix) {
+		m_puUsedFix[nConstellation] = m_uFix;
+		memset(m_ppu64Used[nConstellation], 0, sizeof(m_ppu64Used[nConstellation]));
+	}
+}
+
+int CNMEAParserSkyView::Find(CNMEAParserData::CONSTELLATION_E nConstellation, int nPRN) const
+{
+	for (int i = 0; i < m_View.nCount; i++) {
+		if (m_View.pSats[i].Sat.u16PRN == (uint16_t)nPRN && m_View.pSats[i].u8Constellation == (uint8_t)nConstellation) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+void CNMEAParserSkyView::Remove(int nIndex)
+{
+	int nLast = --m_View.nCount;
+	if (nIndex != nLast) {
+		m_View.pSats[nIndex] = m_View.pSats[nLast];
+		m_pu16Signals[nIndex] = m_pu16Signals[nLast];
+		m_pu16Seen[nIndex] = m_pu16Seen[nLast];
+	}
+}
+
+bool CNMEAParserSkyView::IsUsed(int nConstellation, int nPRN) const
+{
+	if (nPRN <= CNMEAParserData::c_nInvlidPRN || nPRN > c_nMaxPRN) {
+		return false;
+	}
+	return (m_ppu64Used[nConstellation][nPRN / 64] & ((uint64_t)1 << (nPRN % 64))) != 0;
+}
+
+void CNMEAParserSkyView::UpdateInUse(void)
+{
+	int nInUse = 0;
+	for (int i = 0; i < m_View.nCount; i++) {
+		if (IsUsed(m_View.pSats[i].u8Constellation, m_View.pSats[i].Sat.u16PRN)) {
+			m_View.pSats[i].u8Flags |= CNMEAParserData::SKY_SAT_IN_USE;
+			nInUse++;
+		}
+		else {
+			m_View.pSats[i].u8Flags &= (uint8_t)~CNMEAParserData::SKY_SAT_IN_USE;
+		}
+	}
+	m_View.nInUse = nInUse;
+}
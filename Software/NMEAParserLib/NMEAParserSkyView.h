@@ -0,0 +1,133 @@
+/*
+* MIT License
+*
+*  Copyright (c) 2018 VisualGPS, LLC
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this software and associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright notice and this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*
+*/
+#pragma once
+#include <cstddef>
+#include <stdint.h>
+
+#include "NMEAParserData.h"
+#include "NMEAParserFields.h"
+#include "NMEAParserRegistry.h"
+#include "NMEAParserSnapshot.h"
+
+///
+/// \class CNMEAParserSkyView
+/// \brief One table of the satellites of every constellation, kept up to date as GSV and GSA sentences arrive.
+///
+/// Each GSV sentence updates the satellites it lists in place. A satellite is keyed by its
+/// constellation and PRN. When the last sentence of a GSV group arrives, the satellites that
+/// the group no longer lists are removed. GSV sentences with an NMEA 4.10 signal ID form one
+/// group per signal, and a satellite stays in the table while any signal group lists it. Its SNR
+/// is the one of the last group that listed it.
+///
+/// GSA sentences set the SKY_SAT_IN_USE flag. The used satellites of a constellation build up
+/// over the GSA sentences of a fix and start over with the first GSA after a GGA or RMC. A GN
+/// talker GSA is matched by its NMEA 4.10 system ID or, without one, by PRN range (see
+/// CNMEAParserSatellites::GetPRNConstellation()).
+///
+/// The table is published after each complete GSV group and each GSA sentence. CNMEAParserDispatcher
+/// feeds this with every decoded sentence, see SetSkyView().
+///
+class CNMEAParserSkyView
+{
+private:
+	static const int				c_nMaxPRN = 511;							///< Highest PRN tracked for the in use flag
+	static const int				c_nUsedWords = (c_nMaxPRN + 64) / 64;		///< Words in a used PRN bitmap
+
+	CNMEAParserData::SKY_VIEW_T		m_View;										///< Table being updated
+	CNMEAParserSnapshot<CNMEAParserData::SKY_VIEW_T>	m_Snapshot;		///< Published copy of m_View for readers
+	uint16_t						m_pu16Signals[CNMEAParserData::c_nMaxEpochSatellites];	///< Signal groups that list each satellite, one bit per signal ID
+	uint16_t						m_pu16Seen[CNMEAParserData::c_nMaxEpochSatellites];		///< Signal groups that listed each satellite since their first sentence
+	uint64_t						m_ppu64Used[CNMEAParserData::c_nConstellations][c_nUsedWords];	///< Used PRNs of each constellation
+	uint32_t						m_puUsedFix[CNMEAParserData::c_nConstellations];	///< Value of m_uFix when the used PRNs of each constellation were started
+	uint32_t						m_uFix;										///< Number of GGA and RMC sentences received
+
+public:
+	CNMEAParserSkyView();
+	~CNMEAParserSkyView();
+
+	///
+	/// \brief Updates the table from a sentence. Call it from the parsing thread.
+	///
+	/// \param Slot Slot of the sentence, see CNMEAParserRegistry
+	/// \param Sentence The sentence
+	///
+	void ProcessSentence(const CNMEAParserRegistry::SLOT_T &Slot, const CNMEAParserData::SENTENCE_VIEW_T &Sentence);
+
+	///
+	/// \brief Empties the table
+	///
+	void ResetData(void);
+
+	///
+	/// \brief Returns a copy of the table. Safe to call from any thread.
+	///
+	CNMEAParserData::SKY_VIEW_T GetSkyViewData(void) const { return m_Snapshot.Read(); }
+
+	///
+	/// \brief Returns a lease on the table, see CNMEAParserLease. Safe to call from any thread.
+	///
+	CNMEAParserLease<CNMEAParserData::SKY_VIEW_T> LeaseSkyViewData(void) const { return m_Snapshot.Lease(); }
+
+	///
+	/// \brief Returns the update sequence number. It increases every time the table is published and is never reset.
+	///
+	uint32_t GetUpdateSequence(void) const { return m_Snapshot.GetUpdateSequence(); }
+
+private:
+	///
+	/// \brief Updates the satellites listed by a GSV sentence
+	///
+	void ProcessGSV(CNMEAParserData::TALKER_ID_E nTalker, const CNMEAParserFields &Fields);
+
+	///
+	/// \brief Updates the used PRNs and in use flags from a GSA sentence
+	///
+	void ProcessGSA(CNMEAParserData::TALKER_ID_E nTalker, const CNMEAParserFields &Fields);
+
+	///
+	/// \brief Clears the used PRNs of a constellation if they are from an earlier fix
+	///
+	void StartUsed(CNMEAParserData::CONSTELLATION_E nConstellation);
+
+	///
+	/// \brief Returns the index of a satellite, or -1 if it is not in the table
+	///
+	int Find(CNMEAParserData::CONSTELLATION_E nConstellation, int nPRN) const;
+
+	///
+	/// \brief Removes the satellite at nIndex by moving the last one into its place
+	///
+	void Remove(int nIndex);
+
+	///
+	/// \brief Returns true if a GSA lists the satellite as used
+	///
+	bool IsUsed(int nConstellation, int nPRN) const;
+
+	///
+	/// \brief Sets the in use flags from the used PRNs and counts the satellites in use
+	///
+	void UpdateInUse(void);
+};
@@ -0,0 +1,329 @@
+/*
+* MIT License
+*
+*  Copyright (c) 2018 VisualGPS, LLC
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this software and associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright notice and this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*
+*/
+#pragma once
+#include <cstddef>
+#include <stdint.h>
+#include <string.h>
+#include <atomic>
+#include "NMEAParserData.h"
+
+template <class T> class CNMEAParserLease;
+
+///
+/// \class CNMEAParserSnapshot
+/// \brief Lock-free published copy of a sentence data structure.
+///
+/// The parsing thread decodes into its own working copy of the data and calls Publish() when a
+/// sentence is complete. Publish() writes into one of c_nBuffers buffers that no reader is using
+/// and then makes it the current buffer. Readers take a lease on the current buffer (Lease()) and
+/// read it in place, or copy it out (Read()). Neither side takes a lock and the parsing thread
+/// never waits for a reader.
+///
+/// A lease pins its buffer until it is destroyed, so keep leases short. If readers pin every
+/// spare buffer, Publish() skips the update (see GetSkipCount()); the next Publish() carries the
+/// complete, newer data.
+///
+/// Every successful Publish() increments the update sequence number (GetUpdateSequence()). It
+/// starts at 0 and is never reset, so a reader can compare it with the last value it saw to tell
+/// whether anything changed.
+///
+/// For lazy decoding, the parsing thread calls PublishRaw() with the raw sentence data instead.
+/// The first lease taken on that buffer decodes it with the decode function given to the
+/// constructor; later leases on the same buffer read the cached result. A reader that finds
+/// another reader decoding the buffer waits for it, the parsing thread never does.
+///
+/// Only one thread may call Publish() or PublishRaw() at a time.
+///
+template <class T>
+class CNMEAParserSnapshot
+{
+	friend class CNMEAParserLease<T>;
+
+public:
+	static const uint32_t			c_uBuffers = NMEAPARSER_SNAPSHOT_BUFFERS;	///< Number of buffers, at most c_uBuffers - 2 leases can be held without skipping updates
+
+	///
+	/// \brief Decodes raw sentence data into Data. Data holds the copy given to PublishRaw() on entry.
+	///
+	typedef void (*DECODE_FN)(const CNMEAParserData::RAW_SENTENCE_T &Raw, T &Data);
+
+private:
+	static const uint32_t			c_uDecoded = 0;								///< Buffer state, the data is ready
+	static const uint32_t			c_uRaw = 1;									///< Buffer state, the raw data has not been decoded
+	static const uint32_t			c_uDecoding = 2;							///< Buffer state, a reader is decoding the raw data
+
+	mutable T						m_pData[c_uBuffers];						///< Published buffers, lazily decoded buffers are written by readers
+	CNMEAParserData::RAW_SENTENCE_T *m_pRaw;									///< Raw data of each buffer, allocated by the first PublishRaw()
+	DECODE_FN						m_pfnDecode;								///< Decodes the raw data, NULL if PublishRaw() is not used
+	mutable std::atomic<uint32_t>	m_puState[c_uBuffers];						///< Decode state of each buffer
+	uint32_t						m_puSequence[c_uBuffers];					///< Update sequence of each buffer
+	mutable std::atomic<uint32_t>	m_puReaders[c_uBuffers];					///< Number of leases on each buffer
+	std::atomic<uint32_t>			m_uCurrent;									///< Index of the current buffer
+	std::atomic<uint32_t>			m_uSequence;								///< Update sequence of the current buffer
+	std::atomic<uint32_t>			m_uSkipCount;								///< Updates skipped because every spare buffer was leased
+
+public:
+	explicit CNMEAParserSnapshot(DECODE_FN pfnDecode = NULL) :
+		m_pRaw(NULL),
+		m_pfnDecode(pfnDecode),
+		m_uCurrent(0),
+		m_uSequence(0),
+		m_uSkipCount(0)
+	{
+		for (uint32_t i = 0; i < c_uBuffers; i++) {
+			m_pData[i] = T();
+			m_puSequence[i] = 0;
+			m_puState[i].store(c_uDecoded, std::memory_order_relaxed);
+			m_puReaders[i].store(0, std::memory_order_relaxed);
+		}
+	}
+
+	~CNMEAParserSnapshot() { delete[] m_pRaw; }
+
+	///
+	/// \brief Publishes a new copy of Data. Call from the writing (parsing) thread only.
+	///
+	/// \return true if published, false if every spare buffer was leased and the update was skipped.
+	///
+	bool Publish(const T &Data)
+	{
+		uint32_t uIndex = FindFree();
+		if (uIndex == c_uBuffers) {
+			return false;
+		}
+		m_pData[uIndex] = Data;
+		m_puState[uIndex].store(c_uDecoded, std::memory_order_relaxed);
+		MakeCurrent(uIndex);
+		return true;
+	}
+
+	///
+	/// \brief Publishes raw sentence data to be decoded by the first reader. Call from the writing (parsing) thread only.
+	///
+	/// The snapshot must have been constructed with a decode function. The decode function
+	/// starts from a copy of Data, so fields the writer has already decoded can be passed in.
+	///
+	/// \param Data Initial value of the decoded data
+	/// \param pRaw Comma separated sentence data, does not need to be NUL terminated
+	/// \param nRawLen Number of characters in pRaw, truncated to c_uMaxDataLen
+	/// \return true if published, false if every spare buffer was leased and the update was skipped.
+	///
+	bool PublishRaw(const T &Data, const char *pRaw, size_t nRawLen)
+	{
+		uint32_t uIndex = FindFree();
+		if (uIndex == c_uBuffers) {
+			return false;
+		}
+		if (m_pRaw == NULL) {
+			m_pRaw = new CNMEAParserData::RAW_SENTENCE_T[c_uBuffers];
+		}
+		if (nRawLen > CNMEAParserData::c_uMaxDataLen) {
+			nRawLen = CNMEAParserData::c_uMaxDataLen;
+		}
+		memcpy(m_pRaw[uIndex].pData, pRaw, nRawLen);
+		m_pRaw[uIndex].nDataLen = nRawLen;
+		m_pData[uIndex] = Data;
+		m_puState[uIndex].store(c_uRaw, std::memory_order_relaxed);
+		MakeCurrent(uIndex);
+		return true;
+	}
+
+	///
+	/// \brief Takes a lease on the current data. Safe to call from any thread.
+	///
+	CNMEAParserLease<T> Lease(void) const { return CNMEAParserLease<T>(this); }
+
+	///
+	/// \brief Copies the current data into Data. Safe to call from any thread.
+	///
+	void Read(T &Data) const
+	{
+		CNMEAParserLease<T> DataLease(this);
+		Data = *DataLease;
+	}
+
+	///
+	/// \brief Returns a copy of the current data. Safe to call from any thread.
+	///
+	T Read(void) const
+	{
+		CNMEAParserLease<T> DataLease(this);
+		return *DataLease;
+	}
+
+	///
+	/// \brief Returns the update sequence number of the current data
+	///
+	uint32_t GetUpdateSequence(void) const { return m_uSequence.load(std::memory_order_acquire); }
+
+	///
+	/// \brief Returns the number of updates skipped because every spare buffer was leased
+	///
+	uint32_t GetSkipCount(void) const { return m_uSkipCount.load(std::memory_order_relaxed); }
+
+private:
+	///
+	/// \brief Returns the index of a buffer that is neither current nor leased, or c_uBuffers and counts a skip if there is none
+	///
+	uint32_t FindFree(void)
+	{
+		uint32_t uCurrent = m_uCurrent.load(std::memory_order_relaxed);
+		for (uint32_t i = 1; i < c_uBuffers; i++) {
+			uint32_t uIndex = (uCurrent + i) % c_uBuffers;
+			if (m_puReaders[uIndex].load() == 0) {
+				return uIndex;
+			}
+		}
+		m_uSkipCount.fetch_add(1, std::memory_order_relaxed);
+		return c_uBuffers;
+	}
+
+	///
+	/// \brief Makes a filled buffer the current one
+	///
+	void MakeCurrent(uint32_t uIndex)
+	{
+		uint32_t uSequence = m_uSequence.load(std::memory_order_relaxed) + 1;
+		m_puSequence[uIndex] = uSequence;
+		m_uCurrent.store(uIndex);
+		m_uSequence.store(uSequence, std::memory_order_release);
+	}
+
+	///
+	/// \brief Decodes the raw data of a pinned buffer if no reader has done so yet
+	///
+	void Decode(uint32_t uIndex) const
+	{
+		uint32_t uState = m_puState[uIndex].load(std::memory_order_acquire);
+		while (uState != c_uDecoded) {
+			if (uState == c_uRaw &&
+				m_puState[uIndex].compare_exchange_weak(uState, c_uDecoding, std::memory_order_acquire)) {
+				m_pfnDecode(m_pRaw[uIndex], m_pData[uIndex]);
+				m_puState[uIndex].store(c_uDecoded, std::memory_order_release);
+				return;
+			}
+			// Another reader is decoding this buffer; it takes about as long as an eager decode
+			uState = m_puState[uIndex].load(std::memory_order_acquire);
+		}
+	}
+
+	///
+	/// \brief Pins the current buffer, decodes it if needed and returns its index
+	///
+	uint32_t Acquire(void) const
+	{
+		for (;;) {
+			uint32_t uIndex = m_uCurrent.load();
+			m_puReaders[uIndex].fetch_add(1);
+			if (m_uCurrent.load() == uIndex) {
+				Decode(uIndex);
+				return uIndex;
+			}
+			// Publish() moved on before the pin was seen; try the new buffer
+			m_puReaders[uIndex].fetch_sub(1, std::memory_order_release);
+		}
+	}
+
+	///
+	/// \brief Releases a buffer pinned by Acquire()
+	///
+	void Release(uint32_t uIndex) const { m_puReaders[uIndex].fetch_sub(1, std::memory_order_release); }
+};
+
+///
+/// \class CNMEAParserLease
+/// \brief Scoped read access to published sentence data without copying it.
+///
+/// The data stays valid and unchanged for the lifetime of the lease, even while the parsing
+/// thread publishes newer data. A lease can be moved but not copied. A default constructed
+/// lease is not valid (see IsValid()).
+///
+template <class T>
+class CNMEAParserLease
+{
+	friend class CNMEAParserSnapshot<T>;
+
+private:
+	const CNMEAParserSnapshot<T> *	m_pSnapshot;								///< Leased snapshot, NULL if not valid
+	uint32_t						m_uIndex;									///< Pinned buffer
+
+	explicit CNMEAParserLease(const CNMEAParserSnapshot<T> *pSnapshot) :
+		m_pSnapshot(pSnapshot),
+		m_uIndex(pSnapshot->Acquire())
+	{
+	}
+
+	CNMEAParserLease(const CNMEAParserLease &);
+	CNMEAParserLease &operator=(const CNMEAParserLease &);
+
+public:
+	CNMEAParserLease() : m_pSnapshot(NULL), m_uIndex(0) {}
+
+	CNMEAParserLease(CNMEAParserLease &&Other) : m_pSnapshot(Other.m_pSnapshot), m_uIndex(Other.m_uIndex)
+	{
+		Other.m_pSnapshot = NULL;
+	}
+
+	CNMEAParserLease &operator=(CNMEAParserLease &&Other)
+	{
+		if (this != &Other) {
+			Reset();
+			m_pSnapshot = Other.m_pSnapshot;
+			m_uIndex = Other.m_uIndex;
+			Other.m_pSnapshot = NULL;
+		}
+		return *this;
+	}
+
+	~CNMEAParserLease() { Reset(); }
+
+	///
+	/// \brief Ends the lease early. The lease is not valid afterwards.
+	///
+	void Reset(void)
+	{
+		if (m_pSnapshot != NULL) {
+			m_pSnapshot->Release(m_uIndex);
+			m_pSnapshot = NULL;
+		}
+	}
+
+	///
+	/// \brief Returns true if the lease holds data
+	///
+	bool IsValid(void) const { return m_pSnapshot != NULL; }
+
+	///
+	/// \brief Returns the update sequence number of the leased data
+	///
+	uint32_t GetUpdateSequence(void) const { return m_pSnapshot->m_puSequence[m_uIndex]; }
+
+	///
+	/// \brief Returns the leased data. The lease must be valid.
+	///
+	const T &Get(void) const { return m_pSnapshot->m_pData[m_uIndex]; }
+	const T &operator*(void) const { return Get(); }
+	const T *operator->(void) const { return &Get(); }
+};
@@ -0,0 +1,119 @@
+/*
+* MIT License
+*
+*  Copyright (c) 2018 VisualGPS, LLC
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this software and associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright notice and this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*
+*/
+
+#pragma once
+#include <cstddef>
+#include <stdint.h>
+#include <string.h>
+
+#include "NMEAParserData.h"
+#include "NMEAParserFramer.h"
+#include "NMEAParserDispatcher.h"
+
+///
+/// \class CNMEAParserStatic
+/// \brief CNMEAParser with its hooks resolved at compile time.
+///
+/// Derive a class from CNMEAParserStatic<TDerived>, passing the class itself as TDerived. It parses
+/// and stores data exactly like CNMEAParser, but the framer and dispatcher call the hooks of TDerived
+/// without virtual calls, so the empty defaults are inlined away. To use a hook, redefine it in
+/// TDerived with the same signature:
+///
+/// - void TimeTag(void)
+/// - void OnError(CNMEAParserData::ERROR_E nError, char *pCmd)
+/// - void DataAccessSemaphoreLock(void)
+/// - void DataAccessSemaphoreUnlock(void)
+/// - void OnEpoch(const CNMEAParserData::EPOCH_DATA_T &Epoch)
+/// - void OnAISMessage(const CNMEAParserData::AIS_MESSAGE_T &Message)
+///
+/// Redefined hooks must be public, or TDerived must make CNMEAParserFramer<TDerived> (TimeTag and
+/// OnError) and CNMEAParserDispatcher (the lock, epoch and AIS hooks) friends.
+///
+/// \code
+/// class CMyParser : public CNMEAParserStatic<CMyParser> {
+/// public:
+/// 	void OnError(CNMEAParserData::ERROR_E nError, char *pCmd) { ... }
+/// };
+/// \endcode
+///
+template <class TDerived>
+class CNMEAParserStatic : public CNMEAParserFramer<TDerived>, public CNMEAParserDispatcher {
+
+	friend class CNMEAParserFramer<TDerived>;
+
+public:
+	CNMEAParserStatic() {}
+
+	///
+	/// \brief Resets or clears all NMEA data to a known default value
+	///
+	void ResetData(void) {
+		Derived().DataAccessSemaphoreLock();
+		ResetDecoders();
+		Derived().DataAccessSemaphoreUnlock();
+	}
+
+	///
+	/// \brief Default lock hook, does nothing. See CNMEAParser::DataAccessSemaphoreLock().
+	///
+	void DataAccessSemaphoreLock(void) {}
+
+	///
+	/// \brief Default unlock hook, does nothing. See CNMEAParser::DataAccessSemaphoreUnlock().
+	///
+	void DataAccessSemaphoreUnlock(void) {}
+
+	///
+	/// \brief Default epoch hook, does nothing. See CNMEAParser::OnEpoch().
+	///
+	void OnEpoch(const CNMEAParserData::EPOCH_DATA_T &Epoch) { UNUSED_PARAM(Epoch); }
+
+	///
+	/// \brief Default AIS hook, does nothing. See CNMEAParser::OnAISMessage().
+	///
+	void OnAISMessage(const CNMEAParserData::AIS_MESSAGE_T &Message) { UNUSED_PARAM(Message); }
+
+protected:
+	///
+	/// \brief Decodes a sentence framed into the internal buffers
+	///
+	CNMEAParserData::ERROR_E ProcessRxCommand(char *pCmd, char *pData) {
+		CNMEAParserData::SENTENCE_VIEW_T Sentence = { pCmd, strlen(pCmd), pData, strlen(pData), this->GetTimestamp(), this->GetTagBlock() };
+		return Dispatch(Sentence, this->m_pTrace, Derived());
+	}
+
+	///
+	/// \brief Decodes a sentence in place. Called in zero-copy mode.
+	///
+	CNMEAParserData::ERROR_E ProcessRxSentence(const CNMEAParserData::SENTENCE_VIEW_T &Sentence) {
+		return Dispatch(Sentence, this->m_pTrace, Derived());
+	}
+
+private:
+	///
+	/// \brief Returns this object as the derived class
+	///
+	TDerived &Derived(void) { return *static_cast<TDerived *>(this); }
+};
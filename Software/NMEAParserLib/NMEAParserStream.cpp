@@ -0,0 +1,71 @@
+/*
+* MIT License
+*
+*  Copyright (c) 2018 VisualGPS, LLC
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this software and associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright notice and this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*
+*/
+#include <string.h>
+#include "NMEAParserStream.h"
+
+CNMEAParserStream::CNMEAParserStream(int nStream, CNMEAParserStreamSink *pSink) :
+	m_nStream(nStream),
+	m_pSink(pSink)
+{
+	SetZeroCopy(true);
+}
+
+CNMEAParserStream::~CNMEAParserStream()
+{
+}
+
+CNMEAParserData::ERROR_E CNMEAParserStream::ProcessRxCommand(char *pCmd, char *pData)
+{
+	CNMEAParserData::SENTENCE_VIEW_T Sentence = { pCmd, strlen(pCmd), pData, strlen(pData), GetTimestamp(), GetTagBlock() };
+	return ProcessRxSentence(Sentence);
+}
+
+CNMEAParserData::ERROR_E CNMEAParserStream::ProcessRxSentence(const CNMEAParserData::SENTENCE_VIEW_T &Sentence)
+{
+	CNMEAParserData::ERROR_E nError = CNMEAParser::ProcessRxSentence(Sentence);
+	if (nError == CNMEAParserData::ERROR_OK) {
+		m_pSink->OnSentence(m_nStream, *this, Sentence);
+	}
+	else {
+		m_pSink->OnError(m_nStream, nError);
+	}
+	return nError;
+}
+
+void CNMEAParserStream::OnError(CNMEAParserData::ERROR_E nError, char *pCmd)
+{
+	UNUSED_PARAM(pCmd);
+	m_pSink->OnError(m_nStream, nError);
+}
+
+void CNMEAParserStream::OnEpoch(const CNMEAParserData::EPOCH_DATA_T &Epoch)
+{
+	m_pSink->OnEpoch(m_nStream, Epoch);
+}
+
+void CNMEAParserStream::OnAISMessage(const CNMEAParserData::AIS_MESSAGE_T &Message)
+{
+	m_pSink->OnAISMessage(m_nStream, Message);
+}
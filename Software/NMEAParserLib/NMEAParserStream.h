@@ -0,0 +1,112 @@
+/*
+* MIT License
+*
+*  Copyright (c) 2018 VisualGPS, LLC
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this software and associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright notice and this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*
+*/
+#pragma once
+#include <cstddef>
+#include <stdint.h>
+
+#include "NMEAParserData.h"
+#include "NMEAParser.h"
+
+///
+/// \class CNMEAParserStreamSink
+/// \brief Receives the decoded sentences of the streams of CNMEAParserEngine, CNMEAParserNetwork or CNMEAParserTagRouter.
+///
+/// The calls for one stream never overlap and arrive in stream order. CNMEAParserEngine makes the
+/// calls for different streams concurrently from its workers, so a sink that is attached to several
+/// of its streams must be thread safe.
+///
+class CNMEAParserStreamSink
+{
+public:
+	virtual ~CNMEAParserStreamSink() {}
+
+	///
+	/// \brief Called for every sentence of the stream after it is decoded.
+	///
+	/// \param nStream Stream ID, see CNMEAParserEngine::AddStream(), CNMEAParserNetwork::GetSenderCount() and CNMEAParserTagRouter::GetSourceCount()
+	/// \param Parser Parser of the stream. Its GetXXX() methods return the data of this sentence.
+	/// \param Sentence The sentence. Only valid during the call.
+	///
+	virtual void OnSentence(int nStream, CNMEAParser &Parser, const CNMEAParserData::SENTENCE_VIEW_T &Sentence) = 0;
+
+	///
+	/// \brief Called for every epoch of the stream that closes, see CNMEAParserDispatcher::SetEpochAssembly().
+	///
+	/// \param nStream Stream ID
+	/// \param Epoch The data of the epoch. Only valid during the call.
+	///
+	virtual void OnEpoch(int nStream, const CNMEAParserData::EPOCH_DATA_T &Epoch) { UNUSED_PARAM(nStream); UNUSED_PARAM(Epoch); }
+
+	///
+	/// \brief Called for every complete AIS message of the stream, see CNMEAParserDispatcher::SetAIS().
+	///
+	/// \param nStream Stream ID
+	/// \param Message The message. Only valid during the call.
+	///
+	virtual void OnAISMessage(int nStream, const CNMEAParserData::AIS_MESSAGE_T &Message) { UNUSED_PARAM(nStream); UNUSED_PARAM(Message); }
+
+	///
+	/// \brief Called when the stream has a framing error or a sentence fails to decode.
+	///
+	/// \param nStream Stream ID
+	/// \param nError The error
+	///
+	virtual void OnError(int nStream, CNMEAParserData::ERROR_E nError) { UNUSED_PARAM(nStream); UNUSED_PARAM(nError); }
+};
+
+///
+/// \class CNMEAParserStream
+/// \brief Parser of one stream. It decodes like CNMEAParser and forwards its hooks to a CNMEAParserStreamSink.
+///
+/// Zero-copy mode is enabled, see SetZeroCopy().
+///
+class CNMEAParserStream : public CNMEAParser
+{
+	friend class CNMEAParserTagRouter;
+
+private:
+	int								m_nStream;									///< Stream ID
+	CNMEAParserStreamSink *			m_pSink;									///< Sink of the stream
+
+public:
+	///
+	/// \param nStream Stream ID passed to the sink
+	/// \param pSink Receives the decoded sentences, must not be NULL
+	///
+	CNMEAParserStream(int nStream, CNMEAParserStreamSink *pSink);
+	virtual ~CNMEAParserStream();
+
+	///
+	/// \brief Returns the stream ID
+	///
+	int GetStream(void) const { return m_nStream; }
+
+protected:
+	virtual CNMEAParserData::ERROR_E ProcessRxCommand(char *pCmd, char *pData);
+	virtual CNMEAParserData::ERROR_E ProcessRxSentence(const CNMEAParserData::SENTENCE_VIEW_T &Sentence);
+	virtual void OnError(CNMEAParserData::ERROR_E nError, char *pCmd);
+	virtual void OnEpoch(const CNMEAParserData::EPOCH_DATA_T &Epoch);
+	virtual void OnAISMessage(const CNMEAParserData::AIS_MESSAGE_T &Message);
+};
@@ -0,0 +1,224 @@
+/*
+* MIT License
+*
+*  Copyright (c) 2018 VisualGPS, LLC
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this software and associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright notice and this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*
+*/
+#include <string.h>
+#include "NMEAParserTag.h"
+
+///
+/// \brief Returns the value of a hexadecimal digit, or -1 if c is not one
+///
+static int HexValue(char c)
+{
+	if ((c >= '0') && (c <= '9')) {
+		return c - '0';
+	}
+	if ((c >= 'A') && (c <= 'F')) {
+		return c - 'A' + 10;
+	}
+	if ((c >= 'a') && (c <= 'f')) {
+		return c - 'a' + 10;
+	}
+	return -1;
+}
+
+///
+/// \brief Parses an optionally signed decimal integer that fills the whole of pValue
+///
+static bool ParseInt64(const char *pValue, size_t nLen, int64_t &n64Value)
+{
+	size_t i = 0;
+	bool bNegative = false;
+	if ((nLen > 0) && ((pValue[0] == '-') || (pValue[0] == '+'))) {
+		bNegative = (pValue[0] == '-');
+		i++;
+	}
+	if ((i == nLen) || (nLen - i > 18)) {
+		return false;
+	}
+
+	int64_t n64 = 0;
+	for (; i < nLen; i++) {
+		if ((pValue[i] < '0') || (pValue[i] > '9')) {
+			return false;
+		}
+		n64 = n64 * 10 + (pValue[i] - '0');
+	}
+	n64Value = bNegative ? -n64 : n64;
+	return true;
+}
+
+///
+/// \brief Copies an identification into a NUL terminated field, truncating it to fit
+///
+static void CopyID(char *pszID, const char *pValue, size_t nLen)
+{
+	if (nLen >= CNMEAParserData::c_uMaxTagSourceLen) {
+		nLen = CNMEAParserData::c_uMaxTagSourceLen - 1;
+	}
+	memcpy(pszID, pValue, nLen);
+	pszID[nLen] = '\0';
+}
+
+CNMEAParserData::ERROR_E CNMEAParserTag::Parse(const char *pBlock, size_t nLen, CNMEAParserData::TAG_BLOCK_T &Tag)
+{
+	//
+	// The block ends with *hh, the checksum of everything in front of the '*'
+	//
+	if ((nLen < 3) || (nLen > CNMEAParserData::c_uMaxTagLen) || (pBlock[nLen - 3] != '*')) {
+		return CNMEAParserData::ERROR_TAG_BLOCK;
+	}
+	int nHigh = HexValue(pBlock[nLen - 2]);
+	int nLow = HexValue(pBlock[nLen - 1]);
+	if ((nHigh < 0) || (nLow < 0)) {
+		return CNMEAParserData::ERROR_TAG_BLOCK;
+	}
+
+	size_t nParamLen = nLen - 3;
+	uint8_t u8Checksum = 0;
+	for (size_t i = 0; i < nParamLen; i++) {
+		u8Checksum ^= (uint8_t)pBlock[i];
+	}
+	if (u8Checksum != (uint8_t)((nHigh << 4) | nLow)) {
+		return CNMEAParserData::ERROR_TAG_BLOCK;
+	}
+
+	Tag.uFields = 0;
+	Tag.pszSource[0] = '\0';
+	Tag.pszDestination[0] = '\0';
+	Tag.n64Time = 0;
+	Tag.n64RelativeTime = 0;
+	Tag.uLine = 0;
+	Tag.u16GroupSentence = 0;
+	Tag.u16GroupCount = 0;
+	Tag.uGroupID = 0;
+	if (Tag.pBlock != pBlock) {
+		memcpy(Tag.pBlock, pBlock, nParamLen);
+	}
+	Tag.nBlockLen = (uint16_t)nParamLen;
+
+	//
+	// Decode the parameters, each is a one letter code, a colon and a value
+	//
+	size_t nStart = 0;
+	while (nStart < nParamLen) {
+		const char *pParam = &pBlock[nStart];
+		const char *pEnd = (const char *)memchr(pParam, ',', nParamLen - nStart);
+		size_t nLength = (pEnd != NULL) ? (size_t)(pEnd - pParam) : nParamLen - nStart;
+		nStart += nLength + 1;
+
+		if ((nLength < 2) || (pParam[1] != ':')) {
+			return CNMEAParserData::ERROR_TAG_BLOCK;
+		}
+		const char *pValue = pParam + 2;
+		size_t nValueLen = nLength - 2;
+		int64_t n64Value;
+
+		switch (pParam[0]) {
+		case 's':
+			CopyID(Tag.pszSource, pValue, nValueLen);
+			Tag.uFields |= CNMEAParserData::TAG_SOURCE;
+			break;
+
+		case 'd':
+			CopyID(Tag.pszDestination, pValue, nValueLen);
+			Tag.uFields |= CNMEAParserData::TAG_DESTINATION;
+			break;
+
+		case 'c':
+			if (!ParseInt64(pValue, nValueLen, Tag.n64Time)) {
+				return CNMEAParserData::ERROR_TAG_BLOCK;
+			}
+			Tag.uFields |= CNMEAParserData::TAG_TIME;
+			break;
+
+		case 'r':
+			if (!ParseInt64(pValue, nValueLen, Tag.n64RelativeTime)) {
+				return CNMEAParserData::ERROR_TAG_BLOCK;
+			}
+			Tag.uFields |= CNMEAParserData::TAG_RELATIVE_TIME;
+			break;
+
+		case 'n':
+			if (!ParseInt64(pValue, nValueLen, n64Value) || (n64Value < 0) || (n64Value > 0xFFFFFFFF)) {
+				return CNMEAParserData::ERROR_TAG_BLOCK;
+			}
+			Tag.uLine = (uint32_t)n64Value;
+			Tag.uFields |= CNMEAParserData::TAG_LINE;
+			break;
+
+		case 'g':
+			{
+				//
+				// Sentence number, number of sentences and group ID, ie: 1-2-3456
+				//
+				const char *pDash1 = (const char *)memchr(pValue, '-', nValueLen);
+				const char *pDash2 = (pDash1 != NULL) ? (const char *)memchr(pDash1 + 1, '-', nValueLen - (pDash1 + 1 - pValue)) : NULL;
+				int64_t n64Sentence, n64Count, n64ID;
+				if ((pDash2 == NULL) ||
+					!ParseInt64(pValue, pDash1 - pValue, n64Sentence) ||
+					!ParseInt64(pDash1 + 1, pDash2 - pDash1 - 1, n64Count) ||
+					!ParseInt64(pDash2 + 1, nValueLen - (pDash2 + 1 - pValue), n64ID) ||
+					(n64Sentence < 0) || (n64Sentence > 0xFFFF) || (n64Count < 0) || (n64Count > 0xFFFF) ||
+					(n64ID < 0) || (n64ID > 0xFFFFFFFF)) {
+					return CNMEAParserData::ERROR_TAG_BLOCK;
+				}
+				Tag.u16GroupSentence = (uint16_t)n64Sentence;
+				Tag.u16GroupCount = (uint16_t)n64Count;
+				Tag.uGroupID = (uint32_t)n64ID;
+				Tag.uFields |= CNMEAParserData::TAG_GROUP;
+			}
+			break;
+
+		case 't':
+			Tag.uFields |= CNMEAParserData::TAG_TEXT;
+			break;
+
+		default:
+			break;
+		}
+	}
+	return CNMEAParserData::ERROR_OK;
+}
+
+size_t CNMEAParserTag::Format(const char *pszParameters, char *pszOut, size_t nSize)
+{
+	static const char szHex[] = "0123456789ABCDEF";
+	size_t nLen = strlen(pszParameters);
+	if ((nSize < nLen + 6) || (nLen + 3 > CNMEAParserData::c_uMaxTagLen)) {
+		return 0;
+	}
+
+	uint8_t u8Checksum = 0;
+	pszOut[0] = '\\';
+	for (size_t i = 0; i < nLen; i++) {
+		pszOut[i + 1] = pszParameters[i];
+		u8Checksum ^= (uint8_t)pszParameters[i];
+	}
+	pszOut[nLen + 1] = '*';
+	pszOut[nLen + 2] = szHex[u8Checksum >> 4];
+	pszOut[nLen + 3] = szHex[u8Checksum & 0x0F];
+	pszOut[nLen + 4] = '\\';
+	pszOut[nLen + 5] = '\0';
+	return nLen + 5;
+}
@@ -0,0 +1,64 @@
+/*
+* MIT License
+*
+*  Copyright (c) 2018 VisualGPS, LLC
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this software and associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright notice and this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*
+*/
+#pragma once
+#include <cstddef>
+#include <stdint.h>
+#include "NMEAParserData.h"
+
+///
+/// \namespace CNMEAParserTag
+/// \brief IEC 61162-450 tag blocks.
+///
+/// A tag block is a list of parameters in front of a sentence, framed by backslashes and closed by
+/// a checksum over the characters between the backslash and the '*':
+///
+///     \s:GP0001,c:1577836800*2B\$GPGGA,...
+///
+/// The packet framer recognizes them while it searches for the start of a sentence and passes the
+/// decoded block with the sentence, see CNMEAParserData::SENTENCE_VIEW_T::pTag.
+///
+namespace CNMEAParserTag {
+
+	///
+	/// \brief Checks the checksum of a tag block and decodes its parameters.
+	///
+	/// \param pBlock Characters between the backslashes, ie: s:GP0001,c:1577836800*2B
+	/// \param nLen Number of characters in pBlock, at most CNMEAParserData::c_uMaxTagLen
+	/// \param Tag Receives the decoded tag block
+	/// \return CNMEAParserData::ERROR_OK if successful, ERROR_TAG_BLOCK if the checksum is missing or
+	/// does not match, or a parameter is malformed
+	///
+	CNMEAParserData::ERROR_E Parse(const char *pBlock, size_t nLen, CNMEAParserData::TAG_BLOCK_T &Tag);
+
+	///
+	/// \brief Formats a tag block, backslashes and checksum included, for the given parameters.
+	///
+	/// \param pszParameters Comma separated parameters, ie: s:GP0001,c:1577836800
+	/// \param pszOut Receives the NUL terminated tag block
+	/// \param nSize Size of pszOut
+	/// \return Length of the tag block, or 0 if it does not fit into pszOut
+	///
+	size_t Format(const char *pszParameters, char *pszOut, size_t nSize);
+}
@@ -0,0 +1,102 @@
+/*
+* MIT License
+*
+*  Copyright (c) 2018 VisualGPS, LLC
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this software and associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright notice and this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*
+*/
+#include <string.h>
+#include "NMEAParserTagRouter.h"
+
+CNMEAParserTagRouter::CNMEAParserTagRouter(CNMEAParserStreamSink *pSink, int nMaxSources) :
+	m_pSink(pSink),
+	m_nMaxSources(nMaxSources),
+	m_nLastSource(-1),
+	m_u64Dropped(0)
+{
+	SetZeroCopy(true);
+}
+
+CNMEAParserTagRouter::~CNMEAParserTagRouter()
+{
+}
+
+int CNMEAParserTagRouter::FindSource(const char *pszSource) const
+{
+	std::unordered_map<std::string, int>::const_iterator It = m_SourceMap.find(pszSource);
+	return (It != m_SourceMap.end()) ? It->second : -1;
+}
+
+const char *CNMEAParserTagRouter::GetSourceName(int nSource) const
+{
+	if ((nSource < 0) || (nSource >= (int)m_Sources.size())) {
+		return NULL;
+	}
+	return m_Sources[nSource]->Name.c_str();
+}
+
+CNMEAParser *CNMEAParserTagRouter::GetParser(int nSource)
+{
+	if ((nSource < 0) || (nSource >= (int)m_Sources.size())) {
+		return NULL;
+	}
+	return &m_Sources[nSource]->Parser;
+}
+
+CNMEAParserData::ERROR_E CNMEAParserTagRouter::ProcessRxCommand(char *pCmd, char *pData)
+{
+	CNMEAParserData::SENTENCE_VIEW_T Sentence = { pCmd, strlen(pCmd), pData, strlen(pData), GetTimestamp(), GetTagBlock() };
+	return ProcessRxSentence(Sentence);
+}
+
+CNMEAParserData::ERROR_E CNMEAParserTagRouter::ProcessRxSentence(const CNMEAParserData::SENTENCE_VIEW_T &Sentence)
+{
+	const char *pszSource = "";
+	if ((Sentence.pTag != NULL) && ((Sentence.pTag->uFields & CNMEAParserData::TAG_SOURCE) != 0)) {
+		pszSource = Sentence.pTag->pszSource;
+	}
+
+	//
+	// Talkers usually send several sentences in a row, try the last source before the map
+	//
+	int nSource = m_nLastSource;
+	if ((nSource < 0) || (strcmp(m_Sources[nSource]->Name.c_str(), pszSource) != 0)) {
+		nSource = FindSource(pszSource);
+		if (nSource < 0) {
+			if ((int)m_Sources.size() >= m_nMaxSources) {
+				m_u64Dropped++;
+				return CNMEAParserData::ERROR_FAIL;
+			}
+			nSource = (int)m_Sources.size();
+			m_Sources.push_back(std::unique_ptr<SOURCE_T>(new SOURCE_T(nSource, m_pSink)));
+			m_Sources[nSource]->Name = pszSource;
+			m_SourceMap[m_Sources[nSource]->Name] = nSource;
+		}
+		m_nLastSource = nSource;
+	}
+
+	return m_Sources[nSource]->Parser.ProcessRxSentence(Sentence);
+}
+
+void CNMEAParserTagRouter::OnError(CNMEAParserData::ERROR_E nError, char *pCmd)
+{
+	UNUSED_PARAM(pCmd);
+	m_pSink->OnError(-1, nError);
+}
@@ -0,0 +1,113 @@
+/*
+* MIT License
+*
+*  Copyright (c) 2018 VisualGPS, LLC
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this software and associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright notice and this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*
+*/
+#pragma once
+#include <cstddef>
+#include <stdint.h>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "NMEAParserData.h"
+#include "NMEAParserPacket.h"
+#include "NMEAParserStream.h"
+
+///
+/// \class CNMEAParserTagRouter
+/// \brief Splits a stream that multiplexes many talkers with tag blocks into one parser per source.
+///
+/// Each sentence goes to the parser of the s: (source) parameter of its tag block. Sentences without
+/// a source go to a source with an empty name. The parsers are created when their source is first
+/// seen, up to the number given to the constructor; sentences of further sources are dropped and
+/// counted. The sentences are framed once, by the router, and handed to the parser of their source
+/// without being copied or framed again.
+///
+/// The stream ID passed to the sink is the source number, counting from zero in the order the sources
+/// appeared. Framing errors, whose source is not known, are passed to the sink with stream ID -1.
+///
+/// The router is a CNMEAParserPacket, so it can be fed by ProcessNMEABuffer() or attached to
+/// CNMEAParserIngest like any parser.
+///
+class CNMEAParserTagRouter : public CNMEAParserPacket
+{
+public:
+	static const int				c_nDefaultMaxSources = 64;					///< Default limit on the number of sources
+
+private:
+	///
+	/// \brief A source and its parser
+	///
+	typedef struct _SOURCE_T {
+		std::string					Name;										///< Source identification, empty for sentences without one
+		CNMEAParserStream			Parser;										///< Parser of the source
+
+		_SOURCE_T(int nSource, CNMEAParserStreamSink *pSink) : Parser(nSource, pSink) {}
+	} SOURCE_T;
+
+	CNMEAParserStreamSink *			m_pSink;									///< Receives the sentences of every source
+	int								m_nMaxSources;								///< Limit on the number of sources
+	std::vector<std::unique_ptr<SOURCE_T> >	m_Sources;							///< Sources, indexed by source number
+	std::unordered_map<std::string, int>	m_SourceMap;						///< Source identification to source number
+	int								m_nLastSource;								///< Source of the last sentence, checked before m_SourceMap
+	uint64_t						m_u64Dropped;								///< Sentences dropped because of the source limit
+
+public:
+	///
+	/// \param pSink Receives the decoded sentences of every source. It must outlive this object.
+	/// \param nMaxSources Limit on the number of sources
+	///
+	explicit CNMEAParserTagRouter(CNMEAParserStreamSink *pSink, int nMaxSources = c_nDefaultMaxSources);
+	virtual ~CNMEAParserTagRouter();
+
+	///
+	/// \brief Returns the number of sources, which are numbered from zero
+	///
+	int GetSourceCount(void) const { return (int)m_Sources.size(); }
+
+	///
+	/// \brief Returns the source number of a source identification, or -1 if it was not seen yet
+	///
+	int FindSource(const char *pszSource) const;
+
+	///
+	/// \brief Returns the source identification of a source, or NULL if nSource is not a valid source number
+	///
+	const char *GetSourceName(int nSource) const;
+
+	///
+	/// \brief Returns the parser of a source, or NULL if nSource is not a valid source number
+	///
+	CNMEAParser *GetParser(int nSource);
+
+	///
+	/// \brief Returns the number of sentences dropped because of the source limit
+	///
+	uint64_t GetDroppedCount(void) const { return m_u64Dropped; }
+
+protected:
+	virtual CNMEAParserData::ERROR_E ProcessRxCommand(char *pCmd, char *pData);
+	virtual CNMEAParserData::ERROR_E ProcessRxSentence(const CNMEAParserData::SENTENCE_VIEW_T &Sentence);
+	virtual void OnError(CNMEAParserData::ERROR_E nError, char *pCmd);
+};
@@ -0,0 +1,88 @@
+/*
+* MIT License
+*
+*  Copyright (c) 2018 VisualGPS, LLC
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this software and associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright notice and this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*
+*/
+#include <string.h>
+#include "NMEAParserTrace.h"
+
+CNMEAParserTrace::CNMEAParserTrace(uint32_t uCapacity) :
+	m_uMask(0),
+	m_uSequence(0),
+	m_bEnabled(true),
+	m_uHead(0),
+	m_uTail(0),
+	m_uDropCount(0)
+{
+	uint32_t uSize = 1;
+	while (uSize < uCapacity && uSize < 0x80000000) {
+		uSize <<= 1;
+	}
+	m_Events.resize(uSize);
+	m_uMask = uSize - 1;
+}
+
+void CNMEAParserTrace::Record(TRACE_EVENT_E nEvent, const char *pCmd, size_t nCmdLen, CNMEAParserData::ERROR_E nError)
+{
+	if (!m_bEnabled.load(std::memory_order_relaxed)) {
+		return;
+	}
+
+	uint32_t uSequence = m_uSequence++;
+	uint32_t uHead = m_uHead.load(std::memory_order_relaxed);
+	if (uHead - m_uTail.load(std::memory_order_acquire) > m_uMask) {
+		m_uDropCount.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+
+	TRACE_EVENT_T &Event = m_Events[uHead & m_uMask];
+	Event.uSequence = uSequence;
+	Event.nEvent = nEvent;
+	Event.nError = nError;
+	if (pCmd == NULL) {
+		nCmdLen = 0;
+	}
+	if (nCmdLen >= sizeof(Event.szCmd)) {
+		nCmdLen = sizeof(Event.szCmd) - 1;
+	}
+	if (nCmdLen > 0) {
+		memcpy(Event.szCmd, pCmd, nCmdLen);
+	}
+	Event.szCmd[nCmdLen] = '\0';
+
+	m_uHead.store(uHead + 1, std::memory_order_release);
+}
+
+size_t CNMEAParserTrace::Drain(TRACE_EVENT_T *pEvents, size_t nMaxEvents)
+{
+	uint32_t uTail = m_uTail.load(std::memory_order_relaxed);
+	uint32_t uHead = m_uHead.load(std::memory_order_acquire);
+
+	size_t nCount = 0;
+	while (uTail != uHead && nCount < nMaxEvents) {
+		pEvents[nCount++] = m_Events[uTail & m_uMask];
+		uTail++;
+	}
+
+	m_uTail.store(uTail, std::memory_order_release);
+	return nCount;
+}
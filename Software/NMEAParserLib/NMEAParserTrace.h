@@ -0,0 +1,133 @@
+/*
+* MIT License
+*
+*  Copyright (c) 2018 VisualGPS, LLC
+*
+*  Permission is hereby granted, free of charge, to any person obtaining a copy
+*  of this software and associated documentation files (the "Software"), to deal
+*  in the Software without restriction, including without limitation the rights
+*  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*  copies of the Software, and to permit persons to whom the Software is
+*  furnished to do so, subject to the following conditions:
+*
+*  The above copyright notice and this permission notice shall be included in all
+*  copies or substantial portions of the Software.
+*
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*  SOFTWARE.
+*
+*/
+
+#pragma once
+#include <cstddef>
+#include <stdint.h>
+#include <atomic>
+#include <vector>
+#include "NMEAParserData.h"
+
+///
+/// Trace support is compiled in when NMEAPARSER_TRACE is non-zero (cmake -DNMEAPARSER_ENABLE_TRACE=ON).
+/// When it is zero, NMEAPARSER_TRACE_EVENT() expands to nothing and the parser never touches its trace object.
+///
+#ifndef NMEAPARSER_TRACE
+#define NMEAPARSER_TRACE 0
+#endif
+
+#if NMEAPARSER_TRACE
+#define NMEAPARSER_TRACE_EVENT(pTrace, nEvent, pCmd, nCmdLen, nError) \
+	do { if ((pTrace) != NULL) { (pTrace)->Record((nEvent), (pCmd), (nCmdLen), (nError)); } } while (0)
+#else
+#define NMEAPARSER_TRACE_EVENT(pTrace, nEvent, pCmd, nCmdLen, nError) do { } while (0)
+#endif
+
+///
+/// \class CNMEAParserTrace
+/// \brief Lock-free in-memory trace of parser events.
+///
+/// The parsing thread records events with Record() and any other thread drains them with Drain().
+/// The buffer is a single producer/single consumer ring. Nothing is formatted on the parsing
+/// thread. When the ring is full, new events are dropped and counted (see GetDropCount()).
+///
+/// Attach a trace object to a parser with CNMEAParserPacket::SetTrace().
+///
+class CNMEAParserTrace
+{
+public:
+	static const uint32_t			c_uDefaultCapacity = 1024;					///< Default number of events in the ring
+
+	///
+	/// Trace event types
+	///
+	enum TRACE_EVENT_E {
+		TE_SENTENCE = 0,														///< Sentence was decoded
+		TE_UNKNOWN_SENTENCE,													///< Valid sentence that is not decoded by this parser
+		TE_ERROR,																///< Packet error, see TRACE_EVENT_T::nError
+		TE_SKIPPED_SENTENCE,													///< Valid sentence that is not subscribed, see CNMEAParser::SetSubscription()
+	};
+
+	///
+	/// \brief A single trace event
+	///
+	typedef struct _TRACE_EVENT_T {
+		uint32_t						uSequence;								///< Event sequence number, gaps mean dropped events
+		TRACE_EVENT_E					nEvent;									///< Event type
+		CNMEAParserData::ERROR_E		nError;									///< Error for TE_ERROR events, ERROR_OK otherwise
+		char							szCmd[8];								///< NMEA command (address), truncated and NUL terminated
+	} TRACE_EVENT_T;
+
+private:
+	std::vector<TRACE_EVENT_T>		m_Events;									///< Event ring
+	uint32_t						m_uMask;									///< Capacity - 1
+	uint32_t						m_uSequence;								///< Next event sequence number (producer only)
+	std::atomic<bool>				m_bEnabled;									///< Run time enable
+	alignas(64) std::atomic<uint32_t>	m_uHead;								///< Next event to write (producer)
+	alignas(64) std::atomic<uint32_t>	m_uTail;								///< Next event to read (consumer)
+	alignas(64) std::atomic<uint32_t>	m_uDropCount;							///< Events dropped because the ring was full
+
+public:
+	///
+	/// \param uCapacity Number of events in the ring. Rounded up to a power of two.
+	///
+	explicit CNMEAParserTrace(uint32_t uCapacity = c_uDefaultCapacity);
+
+	///
+	/// \brief Enables or disables recording at run time. Recording is enabled by default.
+	///
+	void SetEnabled(bool bEnable) { m_bEnabled.store(bEnable, std::memory_order_relaxed); }
+
+	///
+	/// \brief Returns true if recording is enabled
+	///
+	bool IsEnabled(void) const { return m_bEnabled.load(std::memory_order_relaxed); }
+
+	///
+	/// \brief Records an event. Call from the parsing thread only.
+	///
+	/// \param nEvent Event type
+	/// \param pCmd NMEA command, does not need to be NUL terminated. May be NULL.
+	/// \param nCmdLen Number of characters in pCmd
+	/// \param nError Error code for TE_ERROR events
+	///
+	void Record(TRACE_EVENT_E nEvent, const char *pCmd, size_t nCmdLen, CNMEAParserData::ERROR_E nError);
+
+	///
+	/// \brief Copies up to nMaxEvents of the oldest events into pEvents and removes them from the ring.
+	///
+	/// Call from a single consumer thread.
+	///
+	/// \param pEvents Destination for the events
+	/// \param nMaxEvents Maximum number of events to drain
+	/// \return Number of events placed into pEvents
+	///
+	size_t Drain(TRACE_EVENT_T *pEvents, size_t nMaxEvents);
+
+	///
+	/// \brief Returns the number of events dropped because the ring was full
+	///
+	uint32_t GetDropCount(void) const { return m_uDropCount.load(std::memory_order_relaxed); }
+};
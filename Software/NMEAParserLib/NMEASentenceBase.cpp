@@ -22,6 +22,7 @@
 *  SOFTWARE.
 *
 */
+#include <string.h>
 #include "NMEASentenceBase.h"
 
 
@@ -36,8 +37,41 @@ CNMEASentenceBase::~CNMEASentenceBase()
 {
 }
 
+CNMEAParserData::ERROR_E CNMEASentenceBase::ProcessSentence(const CNMEAParserData::SENTENCE_VIEW_T &Sentence)
+{
+	char pCmd[CNMEAParserData::c_uMaxCmdLen + 1];
+	char pData[CNMEAParserData::c_uMaxDataLen + 1];
+
+	//
+	// The view need not be NUL terminated, so copy it for the older interface
+	//
+	size_t nCmdLen = (Sentence.nCmdLen < CNMEAParserData::c_uMaxCmdLen) ? Sentence.nCmdLen : CNMEAParserData::c_uMaxCmdLen;
+	size_t nDataLen = (Sentence.nDataLen < CNMEAParserData::c_uMaxDataLen) ? Sentence.nDataLen : CNMEAParserData::c_uMaxDataLen;
+	if (nCmdLen > 0)
+	{
+		memcpy(pCmd, Sentence.pCmd, nCmdLen);
+	}
+	if (nDataLen > 0)
+	{
+		memcpy(pData, Sentence.pData, nDataLen);
+	}
+	pCmd[nCmdLen] = '\0';
+	pData[nDataLen] = '\0';
+
+	return ProcessSentence(pCmd, pData);
+}
+
 CNMEAParserData::ERROR_E CNMEASentenceBase::GetField(char * pData, char * pField, int nFieldNum, int nMaxFieldLen)
 {
+	CNMEAParserData::SENTENCE_VIEW_T Sentence = { NULL, 0, pData, (pData != NULL) ? strlen(pData) : 0, 0, NULL };
+	return GetField(Sentence, pField, nFieldNum, nMaxFieldLen);
+}
+
+CNMEAParserData::ERROR_E CNMEASentenceBase::GetField(const CNMEAParserData::SENTENCE_VIEW_T &Sentence, char * pField, int nFieldNum, int nMaxFieldLen)
+{
+	const char *pData = Sentence.pData;
+	size_t nDataLen = Sentence.nDataLen;
+
 	//
 	// Validate parameters
 	//
@@ -49,9 +83,9 @@ CNMEAParserData::ERROR_E CNMEASentenceBase::GetField(char * pData, char * pField
 	//
 	// Go to the beginning of the selected field
 	//
-	int i = 0;
+	size_t i = 0;
 	int nField = 0;
-	while (nField != nFieldNum && pData[i])
+	while (nField != nFieldNum && i < nDataLen && pData[i])
 	{
 		if (pData[i] == ',')
 		{
@@ -60,14 +94,14 @@ CNMEAParserData::ERROR_E CNMEASentenceBase::GetField(char * pData, char * pField
 
 		i++;
 
-		if (pData[i] == 0)
+		if (i >= nDataLen || pData[i] == 0)
 		{
 			pField[0] = '\0';
 			return CNMEAParserData::ERROR_FAIL;
 		}
 	}
 
-	if (pData[i] == ',' || pData[i] == '*')
+	if (i < nDataLen && (pData[i] == ',' || pData[i] == '*'))
 	{
 		pField[0] = '\0';
 		return CNMEAParserData::ERROR_FAIL;
@@ -77,7 +111,7 @@ CNMEAParserData::ERROR_E CNMEASentenceBase::GetField(char * pData, char * pField
 	// copy field from pData to Field
 	//
 	int i2 = 0;
-	while (pData[i] != ',' && pData[i] != '*' && pData[i])
+	while (i < nDataLen && pData[i] != ',' && pData[i] != '*' && pData[i])
 	{
 		pField[i2] = pData[i];
 		i2++; i++;
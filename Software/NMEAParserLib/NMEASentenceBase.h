@@ -45,21 +45,33 @@ protected:
 
 public:
 	CNMEASentenceBase();
-	~CNMEASentenceBase();
+	virtual ~CNMEASentenceBase();
 
 	///
 	/// \brief Process the data from the specific NMEA sentence. 
 	///
-	/// This method was made into a pure virtual to force the child class to define 
-	/// the sentence processor. You must redefine this method to process the
+	/// Redefine this method, or the older ProcessSentence(char *, char *), to process the
 	/// specific data. See CNMEASentenceGGA::ProcessSentence() child class method
-	/// for an example.
+	/// for an example. The default copies the sentence into NUL terminated buffers and calls
+	/// ProcessSentence(char *, char *).
+	///
+	/// \param Sentence View of the talker command and its comma separated data string.
+	/// \return ERROR_OK if successful
+	///
+	virtual CNMEAParserData::ERROR_E ProcessSentence(const CNMEAParserData::SENTENCE_VIEW_T &Sentence);
+
+	///
+	/// \brief Process the data from the specific NMEA sentence, NUL terminated.
+	///
+	/// This is the interface of sentence classes written before the sentence view. It is only
+	/// called by the default ProcessSentence(const CNMEAParserData::SENTENCE_VIEW_T &), so new
+	/// sentence classes redefine that instead.
 	///
 	/// \param pCmd Talker command
 	/// \param pData Comma separated talker data string.
-	/// \return ERROR_OK if successful
+	/// \return ERROR_OK if successful, ERROR_FAIL if neither method is redefined
 	///
-	virtual CNMEAParserData::ERROR_E ProcessSentence(char *pCmd, char *pData) = 0;
+	virtual CNMEAParserData::ERROR_E ProcessSentence(char *pCmd, char *pData) { UNUSED_PARAM(pCmd); UNUSED_PARAM(pData); return CNMEAParserData::ERROR_FAIL; }
 
 	///
 	/// \brief Clears the sentence specific data to a default value
@@ -76,12 +88,47 @@ public:
 	/// \return unsigned int - receive count
 	///
 	unsigned int GetRxCount(void) {	return m_uRxCount;	}
+
+	///
+	/// \brief Returns the update sequence number of the published sentence data
+	///
+	/// It increases every time new data is published and, unlike the receive count, is never reset.
+	/// Sentence classes that do not publish their data return 0.
+	///
+	virtual uint32_t GetUpdateSequence(void) const { return 0; }
+
+	///
+	/// \brief Turns lazy decoding on or off. Call from the parsing thread or before parsing starts.
+	///
+	/// With lazy decoding the parsing thread only keeps a copy of each sentence; its fields are
+	/// decoded by the first reader after the update. Only sentence classes whose data does not
+	/// build up over several sentences support it. Changing the mode resets the data.
+	///
+	/// \param bLazy true for lazy decoding, false to decode every sentence as it is received
+	/// \return true if the mode is supported, false if the sentence class always decodes on receipt.
+	///
+	virtual bool SetLazyDecode(bool bLazy) { return bLazy == false; }
 protected:
 	///
 	/// \brief
 	/// This function will get the specified field in a NMEA string.
 	///
-	/// \param	pData -		Pointer to NMEA string
+	/// Every call rescans the sentence from the start and copies the field. The library decoders
+	/// use CNMEAParserFields instead; this is kept for derived sentence classes.
+	///
+	/// \param	Sentence -		NMEA sentence view. Only the data part is used.
+	///	\param	pField -		pointer to returned field
+	///	\param	nFieldNum -		Field offset to get
+	///	\param	nMaxFieldLen -	Maximum of bytes pFiled can handle
+	///
+	CNMEAParserData::ERROR_E GetField(const CNMEAParserData::SENTENCE_VIEW_T &Sentence, char * pField, int nFieldNum, int nMaxFieldLen);
+
+	///
+	/// \brief
+	/// This function will get the specified field in a NUL terminated NMEA string, see
+	/// GetField(const CNMEAParserData::SENTENCE_VIEW_T &, char *, int, int).
+	///
+	/// \param	pData -			Pointer to NMEA string
 	///	\param	pField -		pointer to returned field
 	///	\param	nFieldNum -		Field offset to get
 	///	\param	nMaxFieldLen -	Maximum of bytes pFiled can handle
@@ -22,10 +22,13 @@
 *  SOFTWARE.
 *
 */
-#include <stdlib.h>
 #include "NMEASentenceGGA.h"
+#include "NMEAParserFields.h"
+#include "NMEAParserNumber.h"
 
 CNMEASentenceGGA::CNMEASentenceGGA() :
+	m_Snapshot(DecodeRaw),
+	m_bLazyDecode(false),
 	m_nOldVSpeedSeconds(0),
 	m_dOldVSpeedAlt(0.0)
 {
@@ -35,110 +38,145 @@ CNMEASentenceGGA::CNMEASentenceGGA() :
 CNMEASentenceGGA::~CNMEASentenceGGA() {
 }
 
-CNMEAParserData::ERROR_E CNMEASentenceGGA::ProcessSentence(char * pCmd, char * pData)
+void CNMEASentenceGGA::DecodeFields(const CNMEAParserFields &Fields, CNMEAParserData::GGA_DATA_T &Data)
 {
-    UNUSED_PARAM(pCmd);
-    char szField[c_nMaxField];
-	char szTemp[c_nMaxField];
+	CNMEAParserData::FIELD_VIEW_T Field;
 
-	if (GetField(pData, szField, 0, c_nMaxField) == CNMEAParserData::ERROR_OK) {
-		m_SentenceData.m_nHour = (szField[0] - '0') * 10 + (szField[1] - '0');
-		m_SentenceData.m_nMinute = (szField[2] - '0') * 10 + (szField[3] - '0');
-		m_SentenceData.m_nSecond = (szField[4] - '0') * 10 + (szField[5] - '0');
+	double dSecond;
+	if (Fields.GetField(0, Field) == CNMEAParserData::ERROR_OK &&
+		CNMEAParserNumber::ParseTime(Field, Data.m_nHour, Data.m_nMinute, dSecond) == CNMEAParserData::ERROR_OK) {
+		Data.m_nSecond = (int)dSecond;
 	}
 
 	//
 	// Latitude
 	//
-	if (GetField(pData, szField, 1, c_nMaxField) == CNMEAParserData::ERROR_OK)
+	if (Fields.GetField(1, Field) == CNMEAParserData::ERROR_OK)
 	{
-		m_SentenceData.m_dLatitude = atof((char *)szField + 2) / 60.0;
-		szField[2] = '\0';
-		m_SentenceData.m_dLatitude += atof((char *)szField);
-
+		CNMEAParserNumber::ParseCoordinate(Field, 2, Data.m_n64Latitude);
+#if !NMEAPARSER_FIXED_POINT_COORDINATES
+		CNMEAParserNumber::ParseCoordinate(Field, 2, Data.m_dLatitude);
+#endif
 	}
-	if (GetField(pData, szField, 2, c_nMaxField) == CNMEAParserData::ERROR_OK)
+	if (Fields.GetField(2, Field) == CNMEAParserData::ERROR_OK)
 	{
-		if (szField[0] == 'S')
+		if (Field.pField[0] == 'S')
 		{
-			m_SentenceData.m_dLatitude = -m_SentenceData.m_dLatitude;
+			Data.m_n64Latitude = -Data.m_n64Latitude;
+#if !NMEAPARSER_FIXED_POINT_COORDINATES
+			Data.m_dLatitude = -Data.m_dLatitude;
+#endif
 		}
 	}
 
 	//
 	// Longitude
 	//
-	if (GetField(pData, szField, 3, c_nMaxField) == CNMEAParserData::ERROR_OK)
+	if (Fields.GetField(3, Field) == CNMEAParserData::ERROR_OK)
 	{
-		m_SentenceData.m_dLongitude = atof((char *)szField + 3) / 60.0;
-		szField[3] = '\0';
-		m_SentenceData.m_dLongitude += atof((char *)szField);
+		CNMEAParserNumber::ParseCoordinate(Field, 3, Data.m_n64Longitude);
+#if !NMEAPARSER_FIXED_POINT_COORDINATES
+		CNMEAParserNumber::ParseCoordinate(Field, 3, Data.m_dLongitude);
+#endif
 	}
-	if (GetField(pData, szField, 4, c_nMaxField) == CNMEAParserData::ERROR_OK)
+	if (Fields.GetField(4, Field) == CNMEAParserData::ERROR_OK)
 	{
-		if (szField[0] == 'W')
+		if (Field.pField[0] == 'W')
 		{
-			m_SentenceData.m_dLongitude = -m_SentenceData.m_dLongitude;
+			Data.m_n64Longitude = -Data.m_n64Longitude;
+#if !NMEAPARSER_FIXED_POINT_COORDINATES
+			Data.m_dLongitude = -Data.m_dLongitude;
+#endif
 		}
 	}
 
 	//
 	// GPS quality
 	//
-	if (GetField(pData, szField, 5, c_nMaxField) == CNMEAParserData::ERROR_OK)
+	if (Fields.GetField(5, Field) == CNMEAParserData::ERROR_OK)
 	{
-		m_SentenceData.m_nGPSQuality = (CNMEAParserData::GPS_QUALITY_E) ( (char)szField[0] - '0');
+		Data.m_nGPSQuality = (CNMEAParserData::GPS_QUALITY_E) ( (char)Field.pField[0] - '0');
 	}
 
 	//
 	// Satellites in use
 	//
-	if (GetField(pData, szField, 6, c_nMaxField) == CNMEAParserData::ERROR_OK)
+	if (Fields.GetField(6, Field) == CNMEAParserData::ERROR_OK)
 	{
-		szTemp[0] = szField[0];
-		szTemp[1] = szField[1];
-		szTemp[2] = '\0';
-		m_SentenceData.m_nSatsInView = atoi(szTemp);
+		CNMEAParserNumber::ParseInt(Field, Data.m_nSatsInView);
 	}
 
 	//
 	// HDOP
 	//
-	if (GetField(pData, szField, 7, c_nMaxField) == CNMEAParserData::ERROR_OK)
+	if (Fields.GetField(7, Field) == CNMEAParserData::ERROR_OK)
 	{
-		m_SentenceData.m_dHDOP = atof((char *)szField);
+		CNMEAParserNumber::ParseDecimal(Field, Data.m_dHDOP);
 	}
 
 	//
 	// Altitude, Meters, above mean sea level
 	//
-	if (GetField(pData, szField, 8, c_nMaxField) == CNMEAParserData::ERROR_OK)
+	if (Fields.GetField(8, Field) == CNMEAParserData::ERROR_OK)
 	{
-		m_SentenceData.m_dAltitudeMSL = atof((char *)szField);
+		CNMEAParserNumber::ParseDecimal(Field, Data.m_dAltitudeMSL);
 	}
 
 	//
 	// Geoidal separation, meters
 	//
-	if (GetField(pData, szField, 9, c_nMaxField) == CNMEAParserData::ERROR_OK)
+	if (Fields.GetField(9, Field) == CNMEAParserData::ERROR_OK)
 	{
-		m_SentenceData.m_dGeoidalSep = atof((char *)szField);
+		CNMEAParserNumber::ParseDecimal(Field, Data.m_dGeoidalSep);
 	}
 
 	//
 	// Differential age
 	//
-	if (GetField(pData, szField, 11, c_nMaxField) == CNMEAParserData::ERROR_OK)
+	if (Fields.GetField(11, Field) == CNMEAParserData::ERROR_OK)
 	{
-		m_SentenceData.m_dDifferentialAge = atof((char *)szField);
+		CNMEAParserNumber::ParseDecimal(Field, Data.m_dDifferentialAge);
 	}
 
 	//
 	// Differential ID
 	//
-	if (GetField(pData, szField, 13, c_nMaxField) == CNMEAParserData::ERROR_OK)
+	if (Fields.GetField(13, Field) == CNMEAParserData::ERROR_OK)
 	{
-		m_SentenceData.m_nDifferentialID = atoi((char *)szField);
+		CNMEAParserNumber::ParseInt(Field, Data.m_nDifferentialID);
+	}
+}
+
+void CNMEASentenceGGA::DecodeRaw(const CNMEAParserData::RAW_SENTENCE_T &Raw, CNMEAParserData::GGA_DATA_T &Data)
+{
+	CNMEAParserFields Fields;
+	Fields.Tokenize(Raw.pData, Raw.nDataLen);
+	DecodeFields(Fields, Data);
+}
+
+CNMEAParserData::ERROR_E CNMEASentenceGGA::ProcessSentence(const CNMEAParserData::SENTENCE_VIEW_T &Sentence)
+{
+	CNMEAParserFields Fields(Sentence);
+
+	if (m_bLazyDecode == true)
+	{
+		//
+		// The vertical speed needs the time and altitude of every sentence, readers decode the rest
+		//
+		CNMEAParserData::FIELD_VIEW_T Field;
+		double dSecond;
+		if (Fields.GetField(0, Field) == CNMEAParserData::ERROR_OK &&
+			CNMEAParserNumber::ParseTime(Field, m_SentenceData.m_nHour, m_SentenceData.m_nMinute, dSecond) == CNMEAParserData::ERROR_OK) {
+			m_SentenceData.m_nSecond = (int)dSecond;
+		}
+		if (Fields.GetField(8, Field) == CNMEAParserData::ERROR_OK)
+		{
+			CNMEAParserNumber::ParseDecimal(Field, m_SentenceData.m_dAltitudeMSL);
+		}
+	}
+	else
+	{
+		DecodeFields(Fields, m_SentenceData);
 	}
 
 	//
@@ -158,6 +196,14 @@ CNMEAParserData::ERROR_E CNMEASentenceGGA::ProcessSentence(char * pCmd, char * p
 	m_nOldVSpeedSeconds = nSeconds;
 
 	m_uRxCount++;
+	if (m_bLazyDecode == true)
+	{
+		m_Snapshot.PublishRaw(m_SentenceData, Sentence.pData, Sentence.nDataLen);
+	}
+	else
+	{
+		m_Snapshot.Publish(m_SentenceData);
+	}
 
 	return CNMEAParserData::ERROR_OK;
 }
@@ -171,6 +217,8 @@ void CNMEASentenceGGA::ResetData(void)
 	m_SentenceData.m_dHDOP = 0.0;
 	m_SentenceData.m_dLatitude = 0.0;
 	m_SentenceData.m_dLongitude = 0.0;
+	m_SentenceData.m_n64Latitude = 0;
+	m_SentenceData.m_n64Longitude = 0;
 	m_SentenceData.m_dVertSpeed = 0.0;
 	m_SentenceData.m_nDifferentialID = 0;
 	m_SentenceData.m_nGPSQuality = CNMEAParserData::GQ_FIX_NOT_AVAILABLE;
@@ -178,4 +226,16 @@ void CNMEASentenceGGA::ResetData(void)
 	m_SentenceData.m_nMinute = 0;
 	m_SentenceData.m_nSatsInView = 0;
 	m_SentenceData.m_nSecond = 0;
+
+	m_Snapshot.Publish(m_SentenceData);
+}
+
+bool CNMEASentenceGGA::SetLazyDecode(bool bLazy)
+{
+	if (bLazy != m_bLazyDecode)
+	{
+		m_bLazyDecode = bLazy;
+		ResetData();
+	}
+	return true;
 }
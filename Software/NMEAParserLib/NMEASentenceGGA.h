@@ -27,6 +27,8 @@
 #include <string>
 #include "NMEAParserData.h"
 #include "NMEASentenceBase.h"
+#include "NMEAParserSnapshot.h"
+#include "NMEAParserFields.h"
 #include "NMEAParserData.h"
 
 ///
@@ -37,9 +39,21 @@ class CNMEASentenceGGA : public CNMEASentenceBase
 {
 private:
 	CNMEAParserData::GGA_DATA_T		m_SentenceData;								///< Sentence specific data
+	CNMEAParserSnapshot<CNMEAParserData::GGA_DATA_T>	m_Snapshot;		///< Published copy of m_SentenceData for readers
+	bool							m_bLazyDecode;								///< Keep a copy of each sentence and decode it when read
 	int								m_nOldVSpeedSeconds;						///< Used to calculate vertical speed
 	double							m_dOldVSpeedAlt;							///< Used to calculate vertical speed
 
+	///
+	/// \brief Decodes every field of a tokenized --GGA sentence into Data. Empty fields are left as they are.
+	///
+	static void DecodeFields(const CNMEAParserFields &Fields, CNMEAParserData::GGA_DATA_T &Data);
+
+	///
+	/// \brief Decodes a lazily published sentence, see CNMEAParserSnapshot::PublishRaw()
+	///
+	static void DecodeRaw(const CNMEAParserData::RAW_SENTENCE_T &Raw, CNMEAParserData::GGA_DATA_T &Data);
+
 public:
 	CNMEASentenceGGA();
 	virtual ~CNMEASentenceGGA();
@@ -47,11 +61,11 @@ public:
 	///
 	/// \brief Process the --GGA command and stores the result in the specific data structure
 	///
-	/// \param pCmd Talker command
-	/// \param pData Comma separated talker data string.
+	/// \param Sentence View of the talker command and its comma separated data string.
 	/// \return ERROR_OK if successful
 	///
-	virtual CNMEAParserData::ERROR_E ProcessSentence(char *pCmd, char *pData);
+	virtual CNMEAParserData::ERROR_E ProcessSentence(const CNMEAParserData::SENTENCE_VIEW_T &Sentence);
+	using CNMEASentenceBase::ProcessSentence;
 
 	///
 	/// \brief Clears the sentence specific data to a default value
@@ -63,7 +77,27 @@ public:
 	///
 	/// \brief Returns the NMEA sentence data structure
 	///
-	CNMEAParserData::GGA_DATA_T GetSentenceData(void) { return m_SentenceData; }
+	/// Returns a copy of the data published after the last complete sentence. It is safe to call
+	/// from any thread while another thread is parsing, and never blocks the parsing thread.
+	///
+	CNMEAParserData::GGA_DATA_T GetSentenceData(void) const { return m_Snapshot.Read(); }
+
+	///
+	/// \brief Returns a lease on the NMEA sentence data structure, see CNMEAParserLease.
+	///
+	/// The data is read in place without copying it. Safe to call from any thread.
+	///
+	CNMEAParserLease<CNMEAParserData::GGA_DATA_T> LeaseSentenceData(void) const { return m_Snapshot.Lease(); }
+
+	///
+	/// \brief Returns the update sequence number. It increases every time new data is published and is never reset.
+	///
+	virtual uint32_t GetUpdateSequence(void) const { return m_Snapshot.GetUpdateSequence(); }
+
+	///
+	/// \brief Turns lazy decoding on or off. See CNMEASentenceBase::SetLazyDecode().
+	///
+	virtual bool SetLazyDecode(bool bLazy);
 
 };
 
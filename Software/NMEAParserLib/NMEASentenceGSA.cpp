@@ -22,9 +22,10 @@
 *  SOFTWARE.
 *
 */
-#include <stdlib.h>
 #include <string.h>
 #include "NMEASentenceGSA.h"
+#include "NMEAParserFields.h"
+#include "NMEAParserNumber.h"
 
 CNMEASentenceGSA::CNMEASentenceGSA() 
 {
@@ -34,22 +35,23 @@ CNMEASentenceGSA::CNMEASentenceGSA()
 CNMEASentenceGSA::~CNMEASentenceGSA() {
 }
 
-CNMEAParserData::ERROR_E CNMEASentenceGSA::ProcessSentence(char * pCmd, char * pData)
+CNMEAParserData::ERROR_E CNMEASentenceGSA::ProcessSentence(const CNMEAParserData::SENTENCE_VIEW_T &Sentence)
 {
-    UNUSED_PARAM(pCmd);
-
-	char szField[c_nMaxField];
+	CNMEAParserFields Fields(Sentence);
+	CNMEAParserData::FIELD_VIEW_T Field;
 
 	// Auto mode
-	if (GetField(pData, szField, 0, c_nMaxField) == CNMEAParserData::ERROR_OK) {
-		m_SentenceData.nAutoMode = (szField[0] == 'A') ? CNMEAParserData::ASAM_AUTO : CNMEAParserData::ASAM_MANUAL;
+	if (Fields.GetField(0, Field) == CNMEAParserData::ERROR_OK) {
+		m_SentenceData.nAutoMode = (Field.pField[0] == 'A') ? CNMEAParserData::ASAM_AUTO : CNMEAParserData::ASAM_MANUAL;
 	}
 	else {
 		m_SentenceData.nAutoMode = CNMEAParserData::ASAM_MANUAL;
 	}
 	// Fix mode
-	if (GetField(pData, szField, 1, c_nMaxField) == CNMEAParserData::ERROR_OK) {
-		m_SentenceData.nMode = (CNMEAParserData::ACTIVE_SAT_MODE_E)atoi(szField);
+	if (Fields.GetField(1, Field) == CNMEAParserData::ERROR_OK) {
+		int nMode;
+		CNMEAParserNumber::ParseInt(Field, nMode);
+		m_SentenceData.nMode = (CNMEAParserData::ACTIVE_SAT_MODE_E)nMode;
 	}
 	else {
 		m_SentenceData.nMode = CNMEAParserData::ASM_FIX_NOT_AVAILABLE;
@@ -57,9 +59,9 @@ CNMEAParserData::ERROR_E CNMEASentenceGSA::ProcessSentence(char * pCmd, char * p
 
 	// Grab the satellite data
 	int nIndexCount = 0;
-	for (int i = 0; i < CNMEAParserData::c_nMaxGSASats; i++) {
-		if (GetField(pData, szField, 2 + i, c_nMaxField) == CNMEAParserData::ERROR_OK) {
-			m_SentenceData.pnPRN[i + m_nIndexCount] = atoi(szField);
+	for (int i = 0; i < CNMEAParserData::c_nMaxGSASats && i + m_nIndexCount < CNMEAParserData::c_nMaxConstellation; i++) {
+		if (Fields.GetField(2 + i, Field) == CNMEAParserData::ERROR_OK) {
+			CNMEAParserNumber::ParseInt(Field, m_SentenceData.pnPRN[i + m_nIndexCount]);
 			nIndexCount++;
 		}
 		else {
@@ -69,30 +71,31 @@ CNMEAParserData::ERROR_E CNMEASentenceGSA::ProcessSentence(char * pCmd, char * p
 	m_nIndexCount = nIndexCount;
 
 	// PDOP
-	if (GetField(pData, szField, 14, c_nMaxField) == CNMEAParserData::ERROR_OK) {
-		m_SentenceData.dPDOP = atof(szField);
+	if (Fields.GetField(14, Field) == CNMEAParserData::ERROR_OK) {
+		CNMEAParserNumber::ParseDecimal(Field, m_SentenceData.dPDOP);
 	}
 	else {
 		m_SentenceData.dPDOP = 0.0;
 	}
 
 	// HDOP
-	if (GetField(pData, szField, 15, c_nMaxField) == CNMEAParserData::ERROR_OK) {
-		m_SentenceData.dHDOP = atof(szField);
+	if (Fields.GetField(15, Field) == CNMEAParserData::ERROR_OK) {
+		CNMEAParserNumber::ParseDecimal(Field, m_SentenceData.dHDOP);
 	}
 	else {
 		m_SentenceData.dHDOP = 0.0;
 	}
 
 	// VDOP
-	if (GetField(pData, szField, 16, c_nMaxField) == CNMEAParserData::ERROR_OK) {
-		m_SentenceData.dVDOP = atof(szField);
+	if (Fields.GetField(16, Field) == CNMEAParserData::ERROR_OK) {
+		CNMEAParserNumber::ParseDecimal(Field, m_SentenceData.dVDOP);
 	}
 	else {
 		m_SentenceData.dVDOP = 0.0;
 	}
 
 	m_uRxCount++;
+	m_Snapshot.Publish(m_SentenceData);
 
 	return CNMEAParserData::ERROR_OK;
 }
@@ -109,4 +112,6 @@ void CNMEASentenceGSA::ResetData(void)
 
 	m_nOldGGACount = 0;
 	m_nIndexCount = 0;
+
+	m_Snapshot.Publish(m_SentenceData);
 }
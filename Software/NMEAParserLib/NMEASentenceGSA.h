@@ -27,6 +27,7 @@
 #include <string>
 #include "NMEAParserData.h"
 #include "NMEASentenceBase.h"
+#include "NMEAParserSnapshot.h"
 #include "NMEAParserData.h"
 
 ///
@@ -37,6 +38,7 @@ class CNMEASentenceGSA : public CNMEASentenceBase
 {
 private:
 	CNMEAParserData::GSA_DATA_T		m_SentenceData;								///< Sentence specific data
+	CNMEAParserSnapshot<CNMEAParserData::GSA_DATA_T>	m_Snapshot;		///< Published copy of m_SentenceData for readers
 	unsigned int					m_nOldGGACount;								///< Used to determine if we are getting more than one GSA sentence per position
 	int								m_nIndexCount;								///< Index into the satellite database
 
@@ -47,11 +49,11 @@ public:
 	///
 	/// \brief Process the --GGA command and stores the result in the specific data structure
 	///
-	/// \param pCmd Talker command
-	/// \param pData Comma separated talker data string.
+	/// \param Sentence View of the talker command and its comma separated data string.
 	/// \return ERROR_OK if successful
 	///
-	virtual CNMEAParserData::ERROR_E ProcessSentence(char *pCmd, char *pData);
+	virtual CNMEAParserData::ERROR_E ProcessSentence(const CNMEAParserData::SENTENCE_VIEW_T &Sentence);
+	using CNMEASentenceBase::ProcessSentence;
 
 	///
 	/// \brief Clears the sentence specific data to a default value
@@ -63,7 +65,22 @@ public:
 	///
 	/// \brief Returns the NMEA sentence data structure
 	///
-	CNMEAParserData::GSA_DATA_T GetSentenceData(void) {	return m_SentenceData; 	}
+	/// Returns a copy of the data published after the last complete sentence. It is safe to call
+	/// from any thread while another thread is parsing, and never blocks the parsing thread.
+	///
+	CNMEAParserData::GSA_DATA_T GetSentenceData(void) const { return m_Snapshot.Read(); }
+
+	///
+	/// \brief Returns a lease on the NMEA sentence data structure, see CNMEAParserLease.
+	///
+	/// The data is read in place without copying it. Safe to call from any thread.
+	///
+	CNMEAParserLease<CNMEAParserData::GSA_DATA_T> LeaseSentenceData(void) const { return m_Snapshot.Lease(); }
+
+	///
+	/// \brief Returns the update sequence number. It increases every time new data is published and is never reset.
+	///
+	virtual uint32_t GetUpdateSequence(void) const { return m_Snapshot.GetUpdateSequence(); }
 
 	///
 	/// \brief This method is called from the same constellation GGA processing to let 
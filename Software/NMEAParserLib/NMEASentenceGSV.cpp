@@ -23,7 +23,9 @@
 *
 */
 #include "NMEASentenceGSV.h"
-#include <stdlib.h>
+#include "NMEAParserFields.h"
+#include "NMEAParserNumber.h"
+#include "NMEAParserSatellites.h"
 #include <string.h>
 
 
@@ -36,85 +38,152 @@ CNMEASentenceGSV::~CNMEASentenceGSV()
 {
 }
 
-CNMEAParserData::ERROR_E CNMEASentenceGSV::ProcessSentence(char * pCmd, char * pData)
+CNMEAParserData::ERROR_E CNMEASentenceGSV::ProcessSentence(const CNMEAParserData::SENTENCE_VIEW_T &Sentence)
 {
-    UNUSED_PARAM(pCmd);
-    char szField[c_nMaxField];
+	CNMEAParserFields Fields(Sentence);
+	CNMEAParserData::FIELD_VIEW_T Field;
+	int nTotalNumberOfSentences = 0;
+	int nSentenceNumber = 0;
+	int nSatsInView = 0;
 
 	// Number of sentences
-	if (GetField(pData, szField, 0, c_nMaxField) == CNMEAParserData::ERROR_OK) {
-		m_SentenceData.nTotalNumberOfSentences = atoi(szField);
+	if (Fields.GetField(0, Field) == CNMEAParserData::ERROR_OK) {
+		CNMEAParserNumber::ParseInt(Field, nTotalNumberOfSentences);
 	}
 
 	// Number of sentences
-	if (GetField(pData, szField, 1, c_nMaxField) == CNMEAParserData::ERROR_OK) {
-		m_SentenceData.nSentenceNumber = atoi(szField);
+	if (Fields.GetField(1, Field) == CNMEAParserData::ERROR_OK) {
+		CNMEAParserNumber::ParseInt(Field, nSentenceNumber);
 	}
 
 	// Number of satellites in view
-	if (GetField(pData, szField, 2, c_nMaxField) == CNMEAParserData::ERROR_OK) {
-		m_SentenceData.nSatsInView = atoi(szField);
+	if (Fields.GetField(2, Field) == CNMEAParserData::ERROR_OK) {
+		CNMEAParserNumber::ParseInt(Field, nSatsInView);
+	}
+
+	// Sentence numbers start at 1, anything else would index before the satellite array
+	if (nSentenceNumber < 1) {
+		return CNMEAParserData::ERROR_FAIL;
+	}
+
+#if NMEAPARSER_COMPACT_SATELLITES
+	m_SentenceData.u8TotalNumberOfSentences = (uint8_t)nTotalNumberOfSentences;
+	m_SentenceData.u8SentenceNumber = (uint8_t)nSentenceNumber;
+	m_SentenceData.u16SatsInView = (uint16_t)nSatsInView;
+#else
+	m_SentenceData.nTotalNumberOfSentences = nTotalNumberOfSentences;
+	m_SentenceData.nSentenceNumber = nSentenceNumber;
+	m_SentenceData.nSatsInView = nSatsInView;
+#endif
+
+	// Keeps the index below from overflowing, this sentence could not hold a satellite that fits
+	if (nSentenceNumber > CNMEAParserData::c_nMaxConstellation) {
+		m_Snapshot.Publish(m_SentenceData);
+		return CNMEAParserData::ERROR_TOO_MANY_SATELLITES;
 	}
 
 	for (int i = 0; i < 4; i++) {
+		CNMEAParserData::SAT_INFO_T Sat;
+
 		// Calculate the index into the satellite data array base on the sentence number
-		int nIndex = (m_SentenceData.nSentenceNumber - 1) * 4 + i;
-		if ((nIndex + 4) >= CNMEAParserData::c_nMaxConstellation) {
-			return CNMEAParserData::ERROR_TOO_MANY_SATELLITES;
+		int nIndex = (nSentenceNumber - 1) * 4 + i;
+
+		//
+		// Only a complete group of 4 fields is a satellite. The single field after the last group is
+		// the NMEA 4.10 signal ID, not a PRN. The satellites in view count only limits the groups when
+		// the receiver filled it in.
+		//
+		bool bSatellite = (Fields.GetCount() >= i * 4 + 7) && ((nSatsInView <= 0) || (nIndex < nSatsInView));
+
+		// Empty slots past the end of the array are fine, a satellite that does not fit is not
+		if (nIndex >= CNMEAParserData::c_nMaxConstellation) {
+			if (bSatellite) {
+				m_Snapshot.Publish(m_SentenceData);
+				return CNMEAParserData::ERROR_TOO_MANY_SATELLITES;
+			}
+			break;
 		}
 
-		// Get PRN
-		if (GetField(pData, szField, i*4 + 3, c_nMaxField) == CNMEAParserData::ERROR_OK) {
-			m_SentenceData.SatInfo[nIndex].nPRN = atoi(szField);
-		}
-		else {
-			m_SentenceData.SatInfo[nIndex].nPRN = CNMEAParserData::c_nInvlidPRN;
-		}
-		// Elevation
-		if (GetField(pData, szField, i * 4 + 4, c_nMaxField) == CNMEAParserData::ERROR_OK) {
-			m_SentenceData.SatInfo[nIndex].dElevation = atof(szField);
-		}
-		else {
-			m_SentenceData.SatInfo[nIndex].dElevation = 0.0;
-		}
-		// Azimuth
-		if (GetField(pData, szField, i * 4 + 5, c_nMaxField) == CNMEAParserData::ERROR_OK) {
-			m_SentenceData.SatInfo[nIndex].dAzimuth = atof(szField);
-		}
-		else {
-			m_SentenceData.SatInfo[nIndex].dAzimuth = atof(szField);
-		}
-		// Signal to noise
-		if (GetField(pData, szField, i * 4 + 6, c_nMaxField) == CNMEAParserData::ERROR_OK) {
-			m_SentenceData.SatInfo[nIndex].nSNR = atoi(szField);
-		}
-		else {
-			m_SentenceData.SatInfo[nIndex].nSNR = 0;
+		Sat.nPRN = CNMEAParserData::c_nInvlidPRN;
+		Sat.dElevation = 0.0;
+		Sat.dAzimuth = 0.0;
+		Sat.nSNR = 0;
+
+		if (bSatellite) {
+			// Get PRN
+			if (Fields.GetField(i * 4 + 3, Field) == CNMEAParserData::ERROR_OK) {
+				CNMEAParserNumber::ParseInt(Field, Sat.nPRN);
+			}
+			// Elevation
+			if (Fields.GetField(i * 4 + 4, Field) == CNMEAParserData::ERROR_OK) {
+				CNMEAParserNumber::ParseDecimal(Field, Sat.dElevation);
+			}
+			// Azimuth
+			if (Fields.GetField(i * 4 + 5, Field) == CNMEAParserData::ERROR_OK) {
+				CNMEAParserNumber::ParseDecimal(Field, Sat.dAzimuth);
+			}
+			// Signal to noise
+			if (Fields.GetField(i * 4 + 6, Field) == CNMEAParserData::ERROR_OK) {
+				CNMEAParserNumber::ParseInt(Field, Sat.nSNR);
+			}
 		}
+
+		SetSatellite(nIndex, Sat);
 	}
 
 	// Check if this was the last sentence and clear the rest of the constellation data
-	if (m_SentenceData.nSentenceNumber == m_SentenceData.nTotalNumberOfSentences) {
-		for (int i = m_SentenceData.nTotalNumberOfSentences * 4; i < CNMEAParserData::c_nMaxConstellation; i++) {
-			m_SentenceData.SatInfo[i].nPRN = CNMEAParserData::c_nInvlidPRN;
-			m_SentenceData.SatInfo[i].dAzimuth = 0.0;
-			m_SentenceData.SatInfo[i].dElevation = 0.0;
-			m_SentenceData.SatInfo[i].nSNR = 0;
+	if (nSentenceNumber == nTotalNumberOfSentences) {
+		CNMEAParserData::SAT_INFO_T Sat;
+		Sat.nPRN = CNMEAParserData::c_nInvlidPRN;
+		Sat.dAzimuth = 0.0;
+		Sat.dElevation = 0.0;
+		Sat.nSNR = 0;
+		for (int i = nTotalNumberOfSentences * 4; i < CNMEAParserData::c_nMaxConstellation; i++) {
+			SetSatellite(i, Sat);
 		}
 	}
 
 	m_uRxCount++;
+	m_Snapshot.Publish(m_SentenceData);
 
 	return CNMEAParserData::ERROR_OK;
 }
 
+void CNMEASentenceGSV::SetSatellite(int nIndex, const CNMEAParserData::SAT_INFO_T &Sat)
+{
+#if NMEAPARSER_COMPACT_SATELLITES
+	CNMEAParserSatellites::ToCompact(Sat, m_SentenceData.SatInfo[nIndex]);
+#else
+	m_SentenceData.SatInfo[nIndex] = Sat;
+#endif
+}
+
 void CNMEASentenceGSV::ResetData(void)
 {
 	m_uRxCount = 0;
-	memset(&m_SentenceData.SatInfo[0], 0, sizeof(m_SentenceData.SatInfo));
-	m_SentenceData.nSatsInView = 0;
-	m_SentenceData.nSentenceNumber = 0;
-	m_SentenceData.nTotalNumberOfSentences = 0;
+	memset(&m_SentenceData, 0, sizeof(m_SentenceData));
 
+	m_Snapshot.Publish(m_SentenceData);
+}
 
+CNMEAParserData::GSV_DATA_T CNMEASentenceGSV::GetSentenceData(void) const
+{
+#if NMEAPARSER_COMPACT_SATELLITES
+	CNMEAParserData::GSV_DATA_T Data;
+	CNMEAParserSatellites::FromCompact(m_Snapshot.Read(), Data);
+	return Data;
+#else
+	return m_Snapshot.Read();
+#endif
+}
+
+CNMEAParserData::GSV_COMPACT_T CNMEASentenceGSV::GetCompactSentenceData(void) const
+{
+#if NMEAPARSER_COMPACT_SATELLITES
+	return m_Snapshot.Read();
+#else
+	CNMEAParserData::GSV_COMPACT_T Compact;
+	CNMEAParserSatellites::ToCompact(m_Snapshot.Read(), Compact);
+	return Compact;
+#endif
 }
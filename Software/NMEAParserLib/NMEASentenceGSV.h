@@ -24,11 +24,25 @@
 */
 #pragma once
 #include "NMEASentenceBase.h"
+#include "NMEAParserSnapshot.h"
 
 class CNMEASentenceGSV : public CNMEASentenceBase
 {
+public:
+#if NMEAPARSER_COMPACT_SATELLITES
+	typedef CNMEAParserData::GSV_COMPACT_T	STORE_T;							///< Stored and published data, see NMEAPARSER_COMPACT_SATELLITES
+#else
+	typedef CNMEAParserData::GSV_DATA_T		STORE_T;							///< Stored and published data, see NMEAPARSER_COMPACT_SATELLITES
+#endif
+
 private:
-	CNMEAParserData::GSV_DATA_T		m_SentenceData;								///< Sentence specific data
+	STORE_T							m_SentenceData;								///< Sentence specific data
+	CNMEAParserSnapshot<STORE_T>	m_Snapshot;									///< Published copy of m_SentenceData for readers
+
+	///
+	/// \brief Stores a satellite in m_SentenceData, converting it when the data is compact
+	///
+	void SetSatellite(int nIndex, const CNMEAParserData::SAT_INFO_T &Sat);
 
 public:
 
@@ -38,11 +52,11 @@ public:
 	///
 	/// \brief Process the --GSV command and stores the result in this clas.
 	///
-	/// \param pCmd Talker command
-	/// \param pData Comma separated talker data string.
+	/// \param Sentence View of the talker command and its comma separated data string.
 	/// \return ERROR_OK if successful
 	///
-	virtual CNMEAParserData::ERROR_E ProcessSentence(char *pCmd, char *pData);
+	virtual CNMEAParserData::ERROR_E ProcessSentence(const CNMEAParserData::SENTENCE_VIEW_T &Sentence);
+	using CNMEASentenceBase::ProcessSentence;
 
 	///
 	/// \brief Clears the sentence specific data to a default value
@@ -54,7 +68,28 @@ public:
 	///
 	/// \brief Returns the NMEA sentence data structure
 	///
-	CNMEAParserData::GSV_DATA_T GetSentenceData(void) { return m_SentenceData; }
+	/// Returns a copy of the data published after the last complete sentence. It is safe to call
+	/// from any thread while another thread is parsing, and never blocks the parsing thread.
+	///
+	CNMEAParserData::GSV_DATA_T GetSentenceData(void) const;
+
+	///
+	/// \brief Returns the NMEA sentence data in the compact form. Same as GetSentenceData() otherwise.
+	///
+	CNMEAParserData::GSV_COMPACT_T GetCompactSentenceData(void) const;
+
+	///
+	/// \brief Returns a lease on the NMEA sentence data structure, see CNMEAParserLease.
+	///
+	/// The data is read in place without copying it. Safe to call from any thread. The data is
+	/// GSV_COMPACT_T when NMEAPARSER_COMPACT_SATELLITES is set, GSV_DATA_T otherwise.
+	///
+	CNMEAParserLease<STORE_T> LeaseSentenceData(void) const { return m_Snapshot.Lease(); }
+
+	///
+	/// \brief Returns the update sequence number. It increases every time new data is published and is never reset.
+	///
+	virtual uint32_t GetUpdateSequence(void) const { return m_Snapshot.GetUpdateSequence(); }
 
 };
 
@@ -31,9 +31,13 @@
 
 
 #include "NMEASentenceRMC.h"
-#include <stdlib.h>
+#include "NMEAParserFields.h"
+#include "NMEAParserNumber.h"
 
-CNMEASentenceRMC::CNMEASentenceRMC() {
+CNMEASentenceRMC::CNMEASentenceRMC() :
+	m_Snapshot(DecodeRaw),
+	m_bLazyDecode(false)
+{
 	// TODO Auto-generated constructor stub
 
 }
@@ -42,111 +46,129 @@ CNMEASentenceRMC::~CNMEASentenceRMC() {
 	// TODO Auto-generated destructor stub
 }
 
-CNMEAParserData::ERROR_E CNMEASentenceRMC::ProcessSentence(char *pCmd, char *pData) {
-
-    UNUSED_PARAM(pCmd);
-    char szField[c_nMaxField];
+void CNMEASentenceRMC::DecodeFields(const CNMEAParserFields &Fields, CNMEAParserData::RMC_DATA_T &Data) {
+	CNMEAParserData::FIELD_VIEW_T Field;
 
 	// Time
-	if (GetField(pData, szField, 0, c_nMaxField) == CNMEAParserData::ERROR_OK) {
-		m_SentenceData.m_nHour = (szField[0] - '0') * 10 + (szField[1] - '0');
-		m_SentenceData.m_nMinute = (szField[2] - '0') * 10 + (szField[3] - '0');
-		m_SentenceData.m_nSecond = (szField[4] - '0') * 10 + (szField[5] - '0');
+	if (Fields.GetField(0, Field) == CNMEAParserData::ERROR_OK &&
+		CNMEAParserNumber::ParseTime(Field, Data.m_nHour, Data.m_nMinute, Data.m_dSecond) == CNMEAParserData::ERROR_OK) {
+		Data.m_nSecond = (int)Data.m_dSecond;
 	}
 
 	// Status
-	if (GetField(pData, szField, 1, c_nMaxField) == CNMEAParserData::ERROR_OK) {
-		m_SentenceData.m_nStatus = (CNMEAParserData::RMC_STATUS_E)((char)szField[0]);
+	if (Fields.GetField(1, Field) == CNMEAParserData::ERROR_OK) {
+		Data.m_nStatus = (CNMEAParserData::RMC_STATUS_E)((char)Field.pField[0]);
 	}
 	else {
-		m_SentenceData.m_nStatus = (CNMEAParserData::RMC_STATUS_VOID);
+		Data.m_nStatus = (CNMEAParserData::RMC_STATUS_VOID);
 	}
 
 	//
 	// Latitude
 	//
-	if (GetField(pData, szField, 2, c_nMaxField) == CNMEAParserData::ERROR_OK)
+	if (Fields.GetField(2, Field) == CNMEAParserData::ERROR_OK)
 	{
-		m_SentenceData.m_dLatitude = atof((char *)szField + 2) / 60.0;
-		szField[2] = '\0';
-		m_SentenceData.m_dLatitude += atof((char *)szField);
-
+		CNMEAParserNumber::ParseCoordinate(Field, 2, Data.m_n64Latitude);
+#if !NMEAPARSER_FIXED_POINT_COORDINATES
+		CNMEAParserNumber::ParseCoordinate(Field, 2, Data.m_dLatitude);
+#endif
 	}
-	if (GetField(pData, szField, 3, c_nMaxField) == CNMEAParserData::ERROR_OK)
+	if (Fields.GetField(3, Field) == CNMEAParserData::ERROR_OK)
 	{
-		if (szField[0] == 'S')
+		if (Field.pField[0] == 'S')
 		{
-			m_SentenceData.m_dLatitude = -m_SentenceData.m_dLatitude;
+			Data.m_n64Latitude = -Data.m_n64Latitude;
+#if !NMEAPARSER_FIXED_POINT_COORDINATES
+			Data.m_dLatitude = -Data.m_dLatitude;
+#endif
 		}
 	}
 
 	//
 	// Longitude
 	//
-	if (GetField(pData, szField, 4, c_nMaxField) == CNMEAParserData::ERROR_OK)
+	if (Fields.GetField(4, Field) == CNMEAParserData::ERROR_OK)
 	{
-		m_SentenceData.m_dLongitude = atof((char *)szField + 3) / 60.0;
-		szField[3] = '\0';
-		m_SentenceData.m_dLongitude += atof((char *)szField);
+		CNMEAParserNumber::ParseCoordinate(Field, 3, Data.m_n64Longitude);
+#if !NMEAPARSER_FIXED_POINT_COORDINATES
+		CNMEAParserNumber::ParseCoordinate(Field, 3, Data.m_dLongitude);
+#endif
 	}
-	if (GetField(pData, szField, 5, c_nMaxField) == CNMEAParserData::ERROR_OK)
+	if (Fields.GetField(5, Field) == CNMEAParserData::ERROR_OK)
 	{
-		if (szField[0] == 'W')
+		if (Field.pField[0] == 'W')
 		{
-			m_SentenceData.m_dLongitude = -m_SentenceData.m_dLongitude;
+			Data.m_n64Longitude = -Data.m_n64Longitude;
+#if !NMEAPARSER_FIXED_POINT_COORDINATES
+			Data.m_dLongitude = -Data.m_dLongitude;
+#endif
 		}
 	}
 
 	// Speed over ground knots
-	if (GetField(pData, szField, 6, c_nMaxField) == CNMEAParserData::ERROR_OK) {
-		m_SentenceData.m_dSpeedKnots = atol(szField);
+	if (Fields.GetField(6, Field) == CNMEAParserData::ERROR_OK) {
+		CNMEAParserNumber::ParseDecimal(Field, Data.m_dSpeedKnots);
 	}
 	else {
-		m_SentenceData.m_dSpeedKnots = 0.0;
+		Data.m_dSpeedKnots = 0.0;
 	}
 
 	// Track Angle
-	if (GetField(pData, szField, 7, c_nMaxField) == CNMEAParserData::ERROR_OK) {
-		m_SentenceData.m_dTrackAngle = atof(szField);
+	if (Fields.GetField(7, Field) == CNMEAParserData::ERROR_OK) {
+		CNMEAParserNumber::ParseDecimal(Field, Data.m_dTrackAngle);
 	}
 	else {
-		m_SentenceData.m_dTrackAngle = 0.0;
+		Data.m_dTrackAngle = 0.0;
 	}
 
 
-	// Date
-	if (GetField(pData, szField, 8, c_nMaxField) == CNMEAParserData::ERROR_OK) {
-		// 23 03 94       Date - 23rd of March 1994
-		m_SentenceData.m_nDay = (szField[0] - '0') * 10 + (szField[1] - '0');
-		m_SentenceData.m_nMonth = (szField[2] - '0') * 10 + (szField[3] - '0');
-        m_SentenceData.m_nYear = (szField[4] - '0') * 10 + (szField[5] - '0');
-		m_SentenceData.m_nYear += 2000;
+	// Date, ddmmyy. 230394 is the 23rd of March 1994
+	if (Fields.GetField(8, Field) == CNMEAParserData::ERROR_OK &&
+		CNMEAParserNumber::ParseDate(Field, Data.m_nDay, Data.m_nMonth, Data.m_nYear) == CNMEAParserData::ERROR_OK) {
+		Data.m_nYear += 2000;
 	}
 	else {
-		m_SentenceData.m_nMonth = 0;
-		m_SentenceData.m_nDay = 0;
-		m_SentenceData.m_nYear = 0;
+		Data.m_nMonth = 0;
+		Data.m_nDay = 0;
+		Data.m_nYear = 0;
 	}
 
 
 	// Magnetic Variation
-	if (GetField(pData, szField, 9, c_nMaxField) == CNMEAParserData::ERROR_OK) {
+	if (Fields.GetField(9, Field) == CNMEAParserData::ERROR_OK) {
 
-		m_SentenceData.m_dMagneticVariation = atof(szField);
+		CNMEAParserNumber::ParseDecimal(Field, Data.m_dMagneticVariation);
 
-		if (GetField(pData, szField, 10, c_nMaxField) == CNMEAParserData::ERROR_OK) {
-			if(szField[0] == 'W') {
-				m_SentenceData.m_dMagneticVariation *= -1.0;
+		if (Fields.GetField(10, Field) == CNMEAParserData::ERROR_OK) {
+			if(Field.pField[0] == 'W') {
+				Data.m_dMagneticVariation *= -1.0;
 			}
 		}
 	}
 	else {
-		m_SentenceData.m_dMagneticVariation = 0.0;
+		Data.m_dMagneticVariation = 0.0;
 	}
+}
 
+void CNMEASentenceRMC::DecodeRaw(const CNMEAParserData::RAW_SENTENCE_T &Raw, CNMEAParserData::RMC_DATA_T &Data) {
+	CNMEAParserFields Fields;
+	Fields.Tokenize(Raw.pData, Raw.nDataLen);
+	DecodeFields(Fields, Data);
+}
 
+CNMEAParserData::ERROR_E CNMEASentenceRMC::ProcessSentence(const CNMEAParserData::SENTENCE_VIEW_T &Sentence) {
 	m_uRxCount++;
 
+	// Lazy decoding leaves every field to the first reader
+	if (m_bLazyDecode == true) {
+		m_Snapshot.PublishRaw(m_SentenceData, Sentence.pData, Sentence.nDataLen);
+		return CNMEAParserData::ERROR_OK;
+	}
+
+	CNMEAParserFields Fields(Sentence);
+	DecodeFields(Fields, m_SentenceData);
+	m_Snapshot.Publish(m_SentenceData);
+
 	return CNMEAParserData::ERROR_OK;
 }
 
@@ -155,6 +177,8 @@ void CNMEASentenceRMC::ResetData(void) {
 	m_SentenceData.m_dAltitudeMSL = 0.0;
 	m_SentenceData.m_dLatitude = 0.0;
 	m_SentenceData.m_dLongitude = 0.0;
+	m_SentenceData.m_n64Latitude = 0;
+	m_SentenceData.m_n64Longitude = 0;
 	m_SentenceData.m_dMagneticVariation = 0.0;
 	m_SentenceData.m_dSecond = 0;
 	m_SentenceData.m_dSpeedKnots = 0.0;
@@ -166,4 +190,14 @@ void CNMEASentenceRMC::ResetData(void) {
 	m_SentenceData.m_nSecond = 0;
 	m_SentenceData.m_nStatus = CNMEAParserData::RMC_STATUS_VOID;
 	m_SentenceData.m_nYear = 0;
+
+	m_Snapshot.Publish(m_SentenceData);
+}
+
+bool CNMEASentenceRMC::SetLazyDecode(bool bLazy) {
+	if (bLazy != m_bLazyDecode) {
+		m_bLazyDecode = bLazy;
+		ResetData();
+	}
+	return true;
 }
@@ -35,11 +35,25 @@
 #define NMEAPARSERLIB_NMEASENTENCERMC_H_
 
 #include "NMEASentenceBase.h"
+#include "NMEAParserSnapshot.h"
+#include "NMEAParserFields.h"
 #include "NMEAParserData.h"
 
 class CNMEASentenceRMC : public CNMEASentenceBase {
 private:
 	CNMEAParserData::RMC_DATA_T		m_SentenceData;								///< Sentence specific data
+	CNMEAParserSnapshot<CNMEAParserData::RMC_DATA_T>	m_Snapshot;		///< Published copy of m_SentenceData for readers
+	bool							m_bLazyDecode;								///< Keep a copy of each sentence and decode it when read
+
+	///
+	/// \brief Decodes every field of a tokenized --RMC sentence into Data. Empty time and position fields are left as they are.
+	///
+	static void DecodeFields(const CNMEAParserFields &Fields, CNMEAParserData::RMC_DATA_T &Data);
+
+	///
+	/// \brief Decodes a lazily published sentence, see CNMEAParserSnapshot::PublishRaw()
+	///
+	static void DecodeRaw(const CNMEAParserData::RAW_SENTENCE_T &Raw, CNMEAParserData::RMC_DATA_T &Data);
 
 public:
 	CNMEASentenceRMC();
@@ -53,11 +67,11 @@ public:
 	/// specific data. See CNMEASentenceGGA::ProcessSentence() child class method
 	/// for an example.
 	///
-	/// \param pCmd Talker command
-	/// \param pData Comma separated talker data string.
+	/// \param Sentence View of the talker command and its comma separated data string.
 	/// \return ERROR_OK if successful
 	///
-	virtual CNMEAParserData::ERROR_E ProcessSentence(char *pCmd, char *pData);
+	virtual CNMEAParserData::ERROR_E ProcessSentence(const CNMEAParserData::SENTENCE_VIEW_T &Sentence);
+	using CNMEASentenceBase::ProcessSentence;
 
 	///
 	/// \brief Clears the sentense specific data to a default value
@@ -72,7 +86,27 @@ public:
 	///
 	/// \brief Returns the NMEA sentence data structure
 	///
-	CNMEAParserData::RMC_DATA_T GetSentenceData(void) { return m_SentenceData; }
+	/// Returns a copy of the data published after the last complete sentence. It is safe to call
+	/// from any thread while another thread is parsing, and never blocks the parsing thread.
+	///
+	CNMEAParserData::RMC_DATA_T GetSentenceData(void) const { return m_Snapshot.Read(); }
+
+	///
+	/// \brief Returns a lease on the NMEA sentence data structure, see CNMEAParserLease.
+	///
+	/// The data is read in place without copying it. Safe to call from any thread.
+	///
+	CNMEAParserLease<CNMEAParserData::RMC_DATA_T> LeaseSentenceData(void) const { return m_Snapshot.Lease(); }
+
+	///
+	/// \brief Returns the update sequence number. It increases every time new data is published and is never reset.
+	///
+	virtual uint32_t GetUpdateSequence(void) const { return m_Snapshot.GetUpdateSequence(); }
+
+	///
+	/// \brief Turns lazy decoding on or off. See CNMEASentenceBase::SetLazyDecode().
+	///
+	virtual bool SetLazyDecode(bool bLazy);
 };
 
 #endif /* NMEAPARSERLIB_NMEASENTENCERMC_H_ */
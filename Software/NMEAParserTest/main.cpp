@@ -22,9 +22,76 @@
 *  SOFTWARE.
 *
 */
+#include <stdarg.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
 #include <NMEAParser.h>
+#include <NMEAParserEngine.h>
+#include <NMEAParserIngest.h>
+#include <NMEAParserLog.h>
+#include <NMEAParserNetwork.h>
+#include <NMEAParserNumber.h>
+#include <NMEAParserRing.h>
+#include <NMEAParserStatic.h>
+#include <NMEAParserTagRouter.h>
+
+#if defined(__linux__)
+#include <pty.h>
+#include <termios.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#endif
+
+///
+/// \brief Appends printf style formatted text to Out
+///
+static void AppendFormat(std::string &Out, const char *pszFormat, ...) {
+	char szLine[512];
+	va_list Args;
+	va_start(Args, pszFormat);
+	vsnprintf(szLine, sizeof(szLine), pszFormat, Args);
+	va_end(Args);
+	Out += szLine;
+}
+
+///
+/// \brief Formats a sentence for printing. If it is the GPGGA command, some of its data is added.
+///
+/// \param Out The text is appended to this
+/// \param pCmd Pointer to the NMEA command string
+/// \param pData Comma separated data that belongs to the command
+/// \param Parser Parser that decoded the sentence
+///
+static void FormatSentence(std::string &Out, const char *pCmd, const char *pData, CNMEAParser &Parser) {
+
+	AppendFormat(Out, "Cmd: %s\nData: %s\n", pCmd, pData);
+
+	// Check if this is the GPGGA command. If it is, then display some data
+	if (strstr(pCmd, "GPGGA") != NULL) {
+		CNMEAParserData::GGA_DATA_T ggaData;
+		if (Parser.GetGPGGA(ggaData) == CNMEAParserData::ERROR_OK) {
+			AppendFormat(Out, "GPGGA Parsed!\n");
+			AppendFormat(Out, "   Time:                %02d:%02d:%02d\n", ggaData.m_nHour, ggaData.m_nMinute, ggaData.m_nSecond);
+			AppendFormat(Out, "   Latitude:            %f (%lld 1e-7')\n", CNMEAParserData::CoordinateToDegrees(ggaData.m_n64Latitude), (long long)ggaData.m_n64Latitude);
+			AppendFormat(Out, "   Longitude:           %f (%lld 1e-7')\n", CNMEAParserData::CoordinateToDegrees(ggaData.m_n64Longitude), (long long)ggaData.m_n64Longitude);
+			AppendFormat(Out, "   Altitude:            %.01fM\n", ggaData.m_dAltitudeMSL);
+			AppendFormat(Out, "   GPS Quality:         %d\n", ggaData.m_nGPSQuality);
+			AppendFormat(Out, "   Satellites in view:  %d\n", ggaData.m_nSatsInView);
+			AppendFormat(Out, "   HDOP:                %.02f\n", ggaData.m_dHDOP);
+			AppendFormat(Out, "   Differential ID:     %d\n", ggaData.m_nDifferentialID);
+			AppendFormat(Out, "   Differential age:    %f\n", ggaData.m_dDifferentialAge);
+			AppendFormat(Out, "   Geoidal Separation:  %f\n", ggaData.m_dGeoidalSep);
+			AppendFormat(Out, "   Vertical Speed:      %.02f\n", ggaData.m_dVertSpeed);
+		}
+	}
+}
 
 ///
 /// \class MyParser
@@ -59,32 +126,301 @@ protected:
 		// Call base class to process the command
 		CNMEAParser::ProcessRxCommand(pCmd, pData);
 
-		printf("Cmd: %s\nData: %s\n", pCmd, pData);
-
-		// Check if this is the GPGGA command. If it is, then display some data
-		if (strstr(pCmd, "GPGGA") != NULL) {
-			CNMEAParserData::GGA_DATA_T ggaData;
-			if (GetGPGGA(ggaData) == CNMEAParserData::ERROR_OK) {
-				printf("GPGGA Parsed!\n");
-				printf("   Time:                %02d:%02d:%02d\n", ggaData.m_nHour, ggaData.m_nMinute, ggaData.m_nSecond);
-				printf("   Latitude:            %f\n", ggaData.m_dLatitude);
-				printf("   Longitude:           %f\n", ggaData.m_dLongitude);
-				printf("   Altitude:            %.01fM\n", ggaData.m_dAltitudeMSL);
-				printf("   GPS Quality:         %d\n", ggaData.m_nGPSQuality);
-				printf("   Satellites in view:  %d\n", ggaData.m_nSatsInView);
-				printf("   HDOP:                %.02f\n", ggaData.m_dHDOP);
-				printf("   Differential ID:     %d\n", ggaData.m_nDifferentialID);
-				printf("   Differential age:    %f\n", ggaData.m_dDifferentialAge);
-				printf("   Geoidal Separation:  %f\n", ggaData.m_dGeoidalSep);
-				printf("   Vertical Speed:      %.02f\n", ggaData.m_dVertSpeed);
-			}
-		}
+		std::string Out;
+		FormatSentence(Out, pCmd, pData, *this);
+		fputs(Out.c_str(), stdout);
 
 		return CNMEAParserData::ERROR_OK;
 	}
 };
 
-void Test(void) {
+///
+/// \class MyStaticNMEAParser
+/// \brief Same error reporting as MyNMEAParser, but the hook is resolved at compile time
+///
+class MyStaticNMEAParser : public CNMEAParserStatic<MyStaticNMEAParser> {
+public:
+	void OnError(CNMEAParserData::ERROR_E nError, char *pCmd) {
+		printf("Static parser ERROR for Cmd: %s, Number: %d\n", pCmd, nError);
+	}
+};
+
+///
+/// \class MyEpochNMEAParser
+/// \brief Prints one line per fix instead of one per sentence
+///
+class MyEpochNMEAParser : public CNMEAParser {
+protected:
+	virtual void OnEpoch(const CNMEAParserData::EPOCH_DATA_T &Epoch) {
+		printf("Epoch %02d:%02d:%05.2f Latitude: %f, Speed: %.2f kn, HDOP: %.2f, Used: %d, Visible: %d\n",
+			Epoch.m_nHour, Epoch.m_nMinute, Epoch.m_dSecond, CNMEAParserData::CoordinateToDegrees(Epoch.m_n64Latitude),
+			Epoch.m_dSpeedKnots, Epoch.m_dHDOP, Epoch.m_nUsedCount, Epoch.m_nVisibleCount);
+	}
+};
+
+///
+/// \class MyAISNMEAParser
+/// \brief Prints and keeps the AIS messages that come out of reassembly
+///
+class MyAISNMEAParser : public CNMEAParser {
+public:
+	std::vector<CNMEAParserData::AIS_MESSAGE_T>	m_Messages;		///< Messages received, pBits is cleared because it is only valid during the call
+
+protected:
+	virtual void OnAISMessage(const CNMEAParserData::AIS_MESSAGE_T &Message) {
+		m_Messages.push_back(Message);
+		m_Messages.back().pBits = NULL;
+
+		if (Message.bPosition) {
+			printf("AIS! Type %d, MMSI: %u, Latitude: %f, Longitude: %f, SOG: %.1f kn\n", Message.u8Type, Message.uMMSI,
+				CNMEAParserData::CoordinateToDegrees(Message.Position.n64Latitude),
+				CNMEAParserData::CoordinateToDegrees(Message.Position.n64Longitude), Message.Position.u16SOG / 10.0);
+		}
+		else {
+			printf("AIS! Type %d, MMSI: %u, %d bits\n", Message.u8Type, Message.uMMSI, Message.nBits);
+		}
+	}
+};
+
+///
+/// \class MyLogSink
+/// \brief Prints a log parsed in parallel with CNMEAParserLog, in file order and like MyNMEAParser
+///
+class MyLogSink : public CNMEAParserLogSink {
+public:
+	std::vector<std::string>	m_Chunks;			///< Text of each chunk, printed by OnChunkEnd()
+
+	explicit MyLogSink(int nChunks) : m_Chunks(nChunks) {}
+
+	virtual void OnSentence(int nChunk, CNMEAParser &Parser, const CNMEAParserData::SENTENCE_VIEW_T &Sentence) {
+		std::string Cmd(Sentence.pCmd, Sentence.nCmdLen);
+		std::string Data(Sentence.pData, Sentence.nDataLen);
+		FormatSentence(m_Chunks[nChunk], Cmd.c_str(), Data.c_str(), Parser);
+	}
+
+	virtual void OnError(int nChunk, CNMEAParserData::ERROR_E nError, const char *pCmd) {
+		AppendFormat(m_Chunks[nChunk], "ERROR for Cmd: %s, Number: %d\n", pCmd, nError);
+	}
+
+	virtual void OnChunkEnd(int nChunk) {
+		fputs(m_Chunks[nChunk].c_str(), stdout);
+		std::string().swap(m_Chunks[nChunk]);
+	}
+};
+
+///
+/// \class MyStreamSink
+/// \brief Counts the sentences and epochs of each stream of a CNMEAParserEngine or CNMEAParserNetwork
+///
+class MyStreamSink : public CNMEAParserStreamSink {
+public:
+	int					m_pnSentences[4];
+	int					m_pnEpochs[4];
+	std::atomic<int>	m_nErrors;			///< Errors of all streams, the streams may report from different threads
+
+	MyStreamSink() : m_nErrors(0) { memset(m_pnSentences, 0, sizeof(m_pnSentences)); memset(m_pnEpochs, 0, sizeof(m_pnEpochs)); }
+
+	// Each stream only touches its own counters, the calls for one stream never overlap
+	virtual void OnSentence(int nStream, CNMEAParser &Parser, const CNMEAParserData::SENTENCE_VIEW_T &Sentence) {
+		UNUSED_PARAM(Parser); UNUSED_PARAM(Sentence);
+		m_pnSentences[nStream]++;
+	}
+
+	virtual void OnEpoch(int nStream, const CNMEAParserData::EPOCH_DATA_T &Epoch) {
+		UNUSED_PARAM(Epoch);
+		m_pnEpochs[nStream]++;
+	}
+
+	virtual void OnError(int nStream, CNMEAParserData::ERROR_E nError) {
+		UNUSED_PARAM(nStream); UNUSED_PARAM(nError);
+		m_nErrors++;
+	}
+};
+
+///
+/// \brief Returns true if Epoch is the last epoch of the epoch sample in Test(), 09:27:52.00
+///
+static bool IsLastSampleEpoch(const CNMEAParserData::EPOCH_DATA_T &Epoch) {
+	return (Epoch.m_nHour == 9) && (Epoch.m_nMinute == 27) && (Epoch.m_dSecond > 51.995) && (Epoch.m_dSecond < 52.005);
+}
+
+///
+/// \brief Checks the CNMEAParserNumber parsers against strtod() over a generated corpus.
+///
+/// \return Number of values that did not match
+///
+int TestNumberParsers(void) {
+	const int nCorpusSize = 200000;
+	uint32_t uSeed = 12345;
+	int nFailed = 0;
+	char szNumber[64];
+
+	for (int n = 0; n < nCorpusSize; n++) {
+		//
+		// Build a decimal with a random sign, integer and fraction. Every 16th value has
+		// enough digits to leave the exact fast path.
+		//
+		size_t nLen = 0;
+		int nIntDigits, nFracDigits;
+		uSeed = uSeed * 1664525 + 1013904223;
+		if ((uSeed >> 28) == 0) {
+			nIntDigits = (int)((uSeed >> 8) % 20);
+			nFracDigits = (int)((uSeed >> 16) % 24) + 1;
+		}
+		else {
+			nIntDigits = (int)((uSeed >> 8) % 6);
+			nFracDigits = (int)((uSeed >> 16) % 8);
+		}
+		if ((uSeed >> 24) & 1) {
+			szNumber[nLen++] = '-';
+		}
+		for (int i = 0; i < nIntDigits + nFracDigits; i++) {
+			if (i == nIntDigits) {
+				szNumber[nLen++] = '.';
+			}
+			uSeed = uSeed * 1664525 + 1013904223;
+			szNumber[nLen++] = (char)('0' + (uSeed >> 16) % 10);
+		}
+		if (nIntDigits + nFracDigits == 0) {
+			szNumber[nLen++] = '0';
+		}
+		szNumber[nLen] = '\0';
+
+		CNMEAParserData::FIELD_VIEW_T Field;
+		Field.pField = szNumber;
+		Field.nLen = nLen;
+
+		double dValue;
+		double dExpected = strtod(szNumber, NULL);
+		if (CNMEAParserNumber::ParseDecimal(Field, dValue) != CNMEAParserData::ERROR_OK || dValue != dExpected) {
+			printf("ParseDecimal mismatch: %s -> %.17g, expected %.17g\n", szNumber, dValue, dExpected);
+			nFailed++;
+		}
+
+		//
+		// Reuse the unsigned digits as a dddmm.mmmm coordinate
+		//
+		const char *pDigits = (szNumber[0] == '-') ? &szNumber[1] : szNumber;
+		if (nIntDigits >= 5) {
+			Field.pField = pDigits;
+			Field.nLen = strlen(pDigits);
+			double dDegrees = 0.0;
+			dExpected = strtod(pDigits + 3, NULL) / 60.0;
+			dExpected += (pDigits[0] - '0') * 100 + (pDigits[1] - '0') * 10 + (pDigits[2] - '0');
+			if (CNMEAParserNumber::ParseCoordinate(Field, 3, dDegrees) != CNMEAParserData::ERROR_OK || dDegrees != dExpected) {
+				printf("ParseCoordinate mismatch: %s -> %.17g, expected %.17g\n", pDigits, dDegrees, dExpected);
+				nFailed++;
+			}
+		}
+	}
+
+	//
+	// Times, dates and integers
+	//
+	CNMEAParserData::FIELD_VIEW_T Field;
+	int nHour = 0, nMinute = 0, nDay = 0, nMonth = 0, nYear = 0, nValue = 0;
+	double dSecond = 0.0;
+	Field.pField = "145416.25";
+	Field.nLen = 9;
+	if (CNMEAParserNumber::ParseTime(Field, nHour, nMinute, dSecond) != CNMEAParserData::ERROR_OK || nHour != 14 || nMinute != 54 || dSecond != 16.25) {
+		printf("ParseTime failed\n");
+		nFailed++;
+	}
+	Field.pField = "051217";
+	Field.nLen = 6;
+	if (CNMEAParserNumber::ParseDate(Field, nDay, nMonth, nYear) != CNMEAParserData::ERROR_OK || nDay != 5 || nMonth != 12 || nYear != 17) {
+		printf("ParseDate failed\n");
+		nFailed++;
+	}
+	Field.pField = "-0042,";
+	Field.nLen = 5;
+	if (CNMEAParserNumber::ParseInt(Field, nValue) != CNMEAParserData::ERROR_OK || nValue != -42) {
+		printf("ParseInt failed\n");
+		nFailed++;
+	}
+
+	printf("Numeric parser test: %d values, %d failures\n", nCorpusSize, nFailed);
+	return nFailed;
+}
+
+///
+/// \brief Checks CNMEAParserTrace: event order, sequence numbers, drops and SetEnabled(). The events of
+/// a parser are checked too when the trace is compiled in (cmake -DNMEAPARSER_ENABLE_TRACE=ON).
+///
+/// \return Number of checks that failed
+///
+int TestTrace(void) {
+	int nFailed = 0;
+	CNMEAParserTrace::TRACE_EVENT_T pEvents[8];
+
+	//
+	// Six events into a ring of four, the last two are dropped
+	//
+	CNMEAParserTrace Trace(4);
+	Trace.Record(CNMEAParserTrace::TE_SENTENCE, "GPGGA", 5, CNMEAParserData::ERROR_OK);
+	Trace.Record(CNMEAParserTrace::TE_UNKNOWN_SENTENCE, "GPZDA", 5, CNMEAParserData::ERROR_OK);
+	Trace.Record(CNMEAParserTrace::TE_ERROR, "GPGGA", 5, CNMEAParserData::ERROR_CHECKSUM);
+	Trace.Record(CNMEAParserTrace::TE_SKIPPED_SENTENCE, "GPGSV,garbage", 13, CNMEAParserData::ERROR_OK);
+	Trace.Record(CNMEAParserTrace::TE_SENTENCE, "GPRMC", 5, CNMEAParserData::ERROR_OK);
+	Trace.Record(CNMEAParserTrace::TE_SENTENCE, "GPRMC", 5, CNMEAParserData::ERROR_OK);
+
+	size_t nCount = Trace.Drain(pEvents, 8);
+	if ((nCount != 4) || (Trace.GetDropCount() != 2)) {
+		printf("Trace drain failed: %d events, %d dropped\n", (int)nCount, (int)Trace.GetDropCount());
+		nFailed++;
+	}
+	else if ((pEvents[0].nEvent != CNMEAParserTrace::TE_SENTENCE) || (strcmp(pEvents[0].szCmd, "GPGGA") != 0) ||
+		(pEvents[1].nEvent != CNMEAParserTrace::TE_UNKNOWN_SENTENCE) ||
+		(pEvents[2].nEvent != CNMEAParserTrace::TE_ERROR) || (pEvents[2].nError != CNMEAParserData::ERROR_CHECKSUM) ||
+		(pEvents[3].nEvent != CNMEAParserTrace::TE_SKIPPED_SENTENCE) || (strcmp(pEvents[3].szCmd, "GPGSV,g") != 0) ||
+		(pEvents[0].uSequence != 0) || (pEvents[3].uSequence != 3)) {
+		printf("Trace events failed\n");
+		nFailed++;
+	}
+
+	//
+	// The dropped events leave a gap in the sequence numbers. Nothing is recorded while disabled.
+	//
+	Trace.SetEnabled(false);
+	Trace.Record(CNMEAParserTrace::TE_SENTENCE, "GPGGA", 5, CNMEAParserData::ERROR_OK);
+	Trace.SetEnabled(true);
+	Trace.Record(CNMEAParserTrace::TE_SENTENCE, NULL, 0, CNMEAParserData::ERROR_OK);
+	nCount = Trace.Drain(pEvents, 8);
+	if ((nCount != 1) || (pEvents[0].uSequence != 6) || (pEvents[0].szCmd[0] != '\0') || (Trace.GetDropCount() != 2)) {
+		printf("Trace sequence failed: %d events\n", (int)nCount);
+		nFailed++;
+	}
+
+#if NMEAPARSER_TRACE
+	//
+	// A parser records a decoded sentence and a checksum error
+	//
+	const char *szTraceSample =
+		"$GPGGA,145416.00,3350.10959,N,11751.22870,W,1,09,0.85,70.3,M,-32.7,M,,*5B\r\n"
+		"$GPGGA,013439.00,3350.11301,N,117.22904,W,1,08,1.03,59.0,M,-32.7,M,,*56\r\n";
+	CNMEAParser TraceParser;
+	TraceParser.SetTrace(&Trace);
+	TraceParser.ProcessNMEABuffer(szTraceSample, (int)strlen(szTraceSample));
+	nCount = Trace.Drain(pEvents, 8);
+	if ((nCount != 2) || (pEvents[0].nEvent != CNMEAParserTrace::TE_SENTENCE) || (strcmp(pEvents[0].szCmd, "GPGGA") != 0) ||
+		(pEvents[1].nEvent != CNMEAParserTrace::TE_ERROR) || (pEvents[1].nError != CNMEAParserData::ERROR_CHECKSUM)) {
+		printf("Trace parser failed: %d events\n", (int)nCount);
+		nFailed++;
+	}
+#endif
+
+	printf("Trace test: %d failures\n", nFailed);
+	return nFailed;
+}
+
+///
+/// \brief Runs the built in test.
+///
+/// \return Number of checks that failed
+///
+int Test(void) {
+	int nFailed = 0;
+
 	// Create a NMEA parser object
 	MyNMEAParser NMEAParser;
 
@@ -134,35 +470,453 @@ void Test(void) {
 		"$GAGSV,2,1,08,02,21,256,41,03,40,275,44,05,28,339,39,08,14,224,42,0*7E" \
 		"$GAGSV,2,2,08,11,36,052,37,12,28,115,34,24,39,122,46,25,59,203,44,0*74";
 
+	const char * szBeiDouTest = \
+		"$GBGSV,1,1,03,19,45,120,38,20,30,200,35,37,60,050,41,1*43";
+
 
 	// Test Individual sentences
-	NMEAParser.ProcessNMEABuffer((char *)szGGASample, (int)strlen(szGGASample));
-	NMEAParser.ProcessNMEABuffer((char *)szGSASample, (int)strlen(szGSASample));
-	NMEAParser.ProcessNMEABuffer((char *)szGSVSample, (int)strlen(szGSVSample));
+	NMEAParser.ProcessNMEABuffer(szGGASample, (int)strlen(szGGASample));
+	NMEAParser.ProcessNMEABuffer(szGSASample, (int)strlen(szGSASample));
+	NMEAParser.ProcessNMEABuffer(szGSVSample, (int)strlen(szGSVSample));
 
 	// Test GLONASS
-	NMEAParser.ProcessNMEABuffer((char *)szGLONASSSample, (int)strlen(szGLONASSSample));
+	NMEAParser.ProcessNMEABuffer(szGLONASSSample, (int)strlen(szGLONASSSample));
 
 	// Double GSA test
-	NMEAParser.ProcessNMEABuffer((char *)szDoubleGSATest, (int)strlen(szDoubleGSATest));
+	NMEAParser.ProcessNMEABuffer(szDoubleGSATest, (int)strlen(szDoubleGSATest));
 
 
 	// Test partial sentences
-	NMEAParser.ProcessNMEABuffer((char *)szPartial1, (int)strlen(szPartial1)); // Should see no output
-	NMEAParser.ProcessNMEABuffer((char *)szPartial2, (int)strlen(szPartial2)); // Sentence is complete here and you should see an output
+	NMEAParser.ProcessNMEABuffer(szPartial1, (int)strlen(szPartial1)); // Should see no output
+	NMEAParser.ProcessNMEABuffer(szPartial2, (int)strlen(szPartial2)); // Sentence is complete here and you should see an output
 
 	// Test a sentence with no Checksum - As per NMEA 0813 this is allowed if the '*' checksum indicator is not included
-	NMEAParser.ProcessNMEABuffer((char *)szGGASampleNoCS, (int)strlen(szGGASampleNoCS));
+	NMEAParser.ProcessNMEABuffer(szGGASampleNoCS, (int)strlen(szGGASampleNoCS));
 
 	// Test GSV with trash between the sentences and not _in_ the sentence. (should still work)
-	NMEAParser.ProcessNMEABuffer((char *)szGSVTestTrash, (int)strlen(szGSVTestTrash));
+	NMEAParser.ProcessNMEABuffer(szGSVTestTrash, (int)strlen(szGSVTestTrash));
 
 	// Test GGA bad checksum
-	NMEAParser.ProcessNMEABuffer((char *)szGGASampleBadCS, (int)strlen(szGGASampleBadCS));
+	NMEAParser.ProcessNMEABuffer(szGGASampleBadCS, (int)strlen(szGGASampleBadCS));
 
 	// Galileo test
-	NMEAParser.ProcessNMEABuffer((char *)szGalileoTest, (int)strlen(szGalileoTest));
+	NMEAParser.ProcessNMEABuffer(szGalileoTest, (int)strlen(szGalileoTest));
+
+	// BeiDou (GB talker) test. There is no GetGBGSV(), the decoder is added when the sentence is first seen.
+	NMEAParser.ProcessNMEABuffer(szBeiDouTest, (int)strlen(szBeiDouTest));
+	CNMEAParserData::GSV_DATA_T gsvData = CNMEAParserData::GSV_DATA_T();
+	if (NMEAParser.Get<CNMEAParserData::TID_GB, CNMEAParserData::SID_GSV>(gsvData) == CNMEAParserData::ERROR_OK) {
+		printf("GBGSV Parsed! Satellites in view: %d, first PRN: %d\n", gsvData.nSatsInView, gsvData.SatInfo[0].nPRN);
+	}
 
+	// Compact satellite view test. Scans the SNR of the BeiDou satellites without copying the GSV data.
+	CNMEAParserData::SAT_VIEW_T satView;
+	if (NMEAParser.GetSatelliteView(CNMEAParserData::TID_GB, satView) == CNMEAParserData::ERROR_OK) {
+		int nStrong = 0;
+		for (int i = 0; i < satView.nCount; i++) {
+			if (satView.pu8SNR[i] >= 40) {
+				nStrong++;
+			}
+		}
+		printf("GBGSV View! Satellites: %d, SNR >= 40: %d\n", satView.nCount, nStrong);
+
+		// The trailing NMEA 4.10 signal ID must not show up as a satellite
+		if (satView.nCount != gsvData.nSatsInView) {
+			printf("GBGSV View failed: %d satellites, expected %d\n", satView.nCount, gsvData.nSatsInView);
+			nFailed++;
+		}
+	}
+
+	// Auto create test. A proprietary sentence and an unknown talker must not get a slot.
+	const char *szNoSlotSample =
+		"$PGRMC,123519,A,4807.038,N,01131.000,E,022.4,084.4,230394,003.1,W*6A\r\n"
+		"$QXGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*59\r\n";
+	CNMEAParser SlotParser;
+	int nSlots = SlotParser.GetRegistry().GetSlotCount();
+	SlotParser.ProcessNMEABuffer(szNoSlotSample, (int)strlen(szNoSlotSample));
+	if (SlotParser.GetRegistry().GetSlotCount() != nSlots) {
+		printf("Auto create failed: %d slots, expected %d\n", SlotParser.GetRegistry().GetSlotCount(), nSlots);
+		nFailed++;
+	}
+
+	// GSV array limit test. NMEAParserTestSmall runs this with NMEAPARSER_MAX_SATELLITES=4, where the
+	// first sentence must still fill the whole array. Sentence number 0 must be rejected.
+	const char *szGSVLimit =
+		"$GPGSV,3,1,11,10,63,137,17,07,61,098,15,05,59,290,20,08,54,157,30*70\r\n"
+		"$GPGSV,3,0,11,12,63,137,17,13,61,098,15,14,59,290,20,15,54,157,30*7A\r\n";
+	CNMEAParser LimitParser;
+	LimitParser.ProcessNMEABuffer(szGSVLimit, (int)strlen(szGSVLimit));
+	CNMEAParserData::GSV_DATA_T limitData = CNMEAParserData::GSV_DATA_T();
+	LimitParser.GetGPGSV(limitData);
+	int nLimitSats = 0;
+	for (int i = 0; i < CNMEAParserData::c_nMaxConstellation; i++) {
+		if (limitData.SatInfo[i].nPRN != CNMEAParserData::c_nInvlidPRN) {
+			nLimitSats++;
+		}
+	}
+	if ((nLimitSats != 4) || (limitData.nSentenceNumber != 1) || (limitData.SatInfo[0].nPRN != 10)) {
+		printf("GSV limit failed: %d satellites, sentence %d, first PRN %d\n", nLimitSats, limitData.nSentenceNumber, limitData.SatInfo[0].nPRN);
+		nFailed++;
+	}
+	printf("GSV limit! %d satellites with room for %d\n", nLimitSats, CNMEAParserData::c_nMaxConstellation);
+
+	// GSV without a satellites in view count. The satellite groups must still be decoded.
+	const char *szGSVNoCount = "$GPGSV,1,1,,10,63,137,17,07,61,098,15*7B\r\n";
+	CNMEAParser NoCountParser;
+	NoCountParser.ProcessNMEABuffer(szGSVNoCount, (int)strlen(szGSVNoCount));
+	CNMEAParserData::GSV_DATA_T noCountData = CNMEAParserData::GSV_DATA_T();
+	CNMEAParserData::SAT_VIEW_T noCountView;
+	NoCountParser.GetGPGSV(noCountData);
+	if ((NoCountParser.GetSatelliteView(CNMEAParserData::TID_GP, noCountView) != CNMEAParserData::ERROR_OK) ||
+		(noCountView.nCount != 2) || (noCountData.SatInfo[0].nPRN != 10) || (noCountData.SatInfo[1].nPRN != 7)) {
+		printf("GSV no count failed: %d satellites, PRN %d, %d\n", noCountView.nCount, noCountData.SatInfo[0].nPRN, noCountData.SatInfo[1].nPRN);
+		nFailed++;
+	}
+
+	// Lazy decoding test. The GGA fields are decoded by GetGPGGA(), not while parsing.
+	CNMEAParser LazyParser;
+	LazyParser.SetLazyDecode(true);
+	LazyParser.ProcessNMEABuffer(szGGASample, (int)strlen(szGGASample));
+	CNMEAParserData::GGA_DATA_T ggaData;
+	if (LazyParser.GetGPGGA(ggaData) == CNMEAParserData::ERROR_OK) {
+		printf("Lazy GPGGA Parsed! Latitude: %f, Longitude: %f, Altitude: %f\n", ggaData.m_dLatitude, ggaData.m_dLongitude, ggaData.m_dAltitudeMSL);
+	}
+
+	// Statically dispatched parser test
+	MyStaticNMEAParser StaticParser;
+	StaticParser.ProcessNMEABuffer(szGGASample, (int)strlen(szGGASample));
+	StaticParser.ProcessNMEABuffer(szGGASampleBadCS, (int)strlen(szGGASampleBadCS));
+	if (StaticParser.GetGPGGA(ggaData) == CNMEAParserData::ERROR_OK) {
+		printf("Static GPGGA Parsed! Latitude: %f, Longitude: %f\n", ggaData.m_dLatitude, ggaData.m_dLongitude);
+	}
+
+	// Epoch assembler test. Three fixes, the last one is reported without waiting for the next fix.
+	const char *szEpochSample = \
+		"$GNRMC,092750.00,A,5321.6802,N,00630.3372,W,0.02,0.0,150326,,,A*63" \
+		"$GNGGA,092750.00,5321.6802,N,00630.3372,W,1,08,1.03,61.7,M,55.2,M,,*68" \
+		"$GNGSA,A,3,10,07,05,02,29,04,08,13,,,,,1.72,1.03,1.38*14" \
+		"$GPGSV,2,1,08,02,48,076,39,04,52,245,42,05,12,291,31,07,06,320,27*7A" \
+		"$GPGSV,2,2,08,08,21,087,35,10,47,117,41,13,15,173,30,29,31,048,38*7D" \
+		"$GLGSV,1,1,03,65,34,056,33,72,61,112,40,88,15,311,*52" \
+		"$GNRMC,092751.00,A,5321.6803,N,00630.3372,W,0.05,0.0,150326,,,A*64" \
+		"$GNGGA,092751.00,5321.6803,N,00630.3372,W,1,08,1.03,61.7,M,55.2,M,,*68" \
+		"$GNGSA,A,3,10,07,05,02,29,04,08,13,,,,,1.72,1.03,1.38*14" \
+		"$GPGSV,2,1,08,02,48,076,39,04,52,245,42,05,12,291,31,07,06,320,27*7A" \
+		"$GPGSV,2,2,08,08,21,087,35,10,47,117,41,13,15,173,30,29,31,048,38*7D" \
+		"$GLGSV,1,1,03,65,34,056,33,72,61,112,40,88,15,311,*52" \
+		"$GNRMC,092752.00,A,5321.6805,N,00630.3372,W,0.11,0.0,150326,,,A*64" \
+		"$GNGGA,092752.00,5321.6805,N,00630.3372,W,1,08,1.03,61.7,M,55.2,M,,*6D" \
+		"$GNGSA,A,3,10,07,05,02,29,04,08,13,,,,,1.72,1.03,1.38*14" \
+		"$GPGSV,2,1,08,02,48,076,39,04,52,245,42,05,12,291,31,07,06,320,27*7A" \
+		"$GPGSV,2,2,08,08,21,087,35,10,47,117,41,13,15,173,30,29,31,048,38*7D" \
+		"$GLGSV,1,1,03,65,34,056,33,72,61,112,40,88,15,311,*52";
+	MyEpochNMEAParser EpochParser;
+	EpochParser.SetEpochAssembly(true);
+	EpochParser.SetSkyView(true);
+	EpochParser.ProcessNMEABuffer(szEpochSample, (int)strlen(szEpochSample));
+
+	// Merged satellite table test, GPS and GLONASS in one table
+	CNMEAParserData::SKY_VIEW_T skyView;
+	if (EpochParser.GetSkyView(skyView) == CNMEAParserData::ERROR_OK) {
+		int nGLONASS = 0;
+		for (int i = 0; i < skyView.nCount; i++) {
+			if (skyView.pSats[i].u8Constellation == CNMEAParserData::CONSTELLATION_GLONASS) {
+				nGLONASS++;
+			}
+		}
+		printf("Sky view! Satellites: %d, In use: %d, GLONASS: %d\n", skyView.nCount, skyView.nInUse, nGLONASS);
+	}
+
+	// Multi-stream engine test. The epoch sample is fed to four streams in small interleaved chunks.
+	MyStreamSink StreamSink;
+	CNMEAParserEngine Engine;
+	for (int i = 0; i < 4; i++) {
+		Engine.GetParser(Engine.AddStream(&StreamSink))->SetEpochAssembly(true);
+	}
+	Engine.Start(2);
+	size_t nEpochSampleLen = strlen(szEpochSample);
+	for (size_t nOffset = 0; nOffset < nEpochSampleLen; nOffset += 37) {
+		size_t nChunk = (nEpochSampleLen - nOffset < 37) ? nEpochSampleLen - nOffset : 37;
+		for (int i = 0; i < 4; i++) {
+			Engine.Submit(i, szEpochSample + nOffset, nChunk);
+		}
+	}
+	Engine.Wait();
+	for (int i = 0; i < 4; i++) {
+		printf("Engine! Stream %d: %d sentences, %d epochs\n", i, StreamSink.m_pnSentences[i], StreamSink.m_pnEpochs[i]);
+
+		// The epoch sample has 18 sentences in 3 epochs, every stream must see all of them
+		if ((StreamSink.m_pnSentences[i] != 18) || (StreamSink.m_pnEpochs[i] != 3)) {
+			printf("Engine failed: stream %d, %d sentences, %d epochs\n", i, StreamSink.m_pnSentences[i], StreamSink.m_pnEpochs[i]);
+			nFailed++;
+		}
+	}
+	Engine.Stop();
+
+	// I/O thread to parser thread hand-off. The reader thread only copies bytes into the ring.
+	CNMEAParserRing Ring;
+	std::atomic<bool> bReaderDone(false);
+	std::thread Reader([&]() {
+		for (size_t nOffset = 0; nOffset < nEpochSampleLen; nOffset += 16) {
+			Ring.Push(szEpochSample + nOffset, (nEpochSampleLen - nOffset < 16) ? nEpochSampleLen - nOffset : 16);
+		}
+		bReaderDone = true;
+	});
+	MyStaticNMEAParser RingParser;
+	RingParser.SetEpochAssembly(true);
+	size_t nRingBytes = 0;
+	while (!bReaderDone || (Ring.GetSize() > 0)) {
+		if (Ring.Wait(10)) {
+			nRingBytes += Ring.Drain(RingParser);
+		}
+	}
+	Reader.join();
+	CNMEAParserData::EPOCH_DATA_T RingEpoch;
+	if (RingParser.GetEpoch(RingEpoch) == CNMEAParserData::ERROR_OK) {
+		printf("Ring! Bytes: %d, Last epoch: %02d:%02d:%05.2f, Overrun: %d\n", (int)nRingBytes,
+			RingEpoch.m_nHour, RingEpoch.m_nMinute, RingEpoch.m_dSecond, (int)Ring.GetOverrunCount());
+	}
+
+	// Every byte must reach the parser, in order and without an overrun
+	if ((RingParser.GetEpoch(RingEpoch) != CNMEAParserData::ERROR_OK) || (nRingBytes != nEpochSampleLen) ||
+		(Ring.GetOverrunCount() != 0) || !IsLastSampleEpoch(RingEpoch)) {
+		printf("Ring failed: %d of %d bytes, %d overruns\n", (int)nRingBytes, (int)nEpochSampleLen, (int)Ring.GetOverrunCount());
+		nFailed++;
+	}
+
+	// Tag block test. Two talkers share one stream, the router gives each its own parser.
+	const char *szTagSample =
+		"\\s:GP0001,c:1577836800*2B\\$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*47\r\n"
+		"\\s:GN0002,c:1577836801*37\\$GPGGA,123520,3723.247,N,12158.341,W,1,05,1.5,280.2,M,-34.0,M,,*79\r\n"
+		"\\s:GP0001,c:1577836801*2A\\$GPGGA,123520,4807.040,N,01131.002,E,1,08,0.9,545.6,M,46.9,M,,*42\r\n";
+	MyStreamSink TagSink;
+	CNMEAParserTagRouter TagRouter(&TagSink, 4);
+	TagRouter.ProcessNMEABuffer(szTagSample, strlen(szTagSample));
+	const char *pszTagSources[2] = { "GP0001", "GN0002" };
+	const int pnTagSentences[2] = { 2, 1 };
+	const double pdTagLatitudes[2] = { 48.117333, 37.387450 };
+	if (TagRouter.GetSourceCount() != 2) {
+		printf("Tag block failed: %d sources\n", TagRouter.GetSourceCount());
+		nFailed++;
+	}
+	for (int i = 0; i < TagRouter.GetSourceCount(); i++) {
+		CNMEAParserData::GGA_DATA_T TagGGA = CNMEAParserData::GGA_DATA_T();
+		TagRouter.GetParser(i)->GetGPGGA(TagGGA);
+		double dLatitude = CNMEAParserData::CoordinateToDegrees(TagGGA.m_n64Latitude);
+		printf("Tag block! Source %s: %d sentences, Latitude: %f\n", TagRouter.GetSourceName(i), TagSink.m_pnSentences[i], dLatitude);
+
+		// Each source keeps its own sentence count and its own last GGA
+		if ((i < 2) && ((strcmp(TagRouter.GetSourceName(i), pszTagSources[i]) != 0) || (TagSink.m_pnSentences[i] != pnTagSentences[i]) ||
+			(dLatitude < pdTagLatitudes[i] - 0.000001) || (dLatitude > pdTagLatitudes[i] + 0.000001))) {
+			printf("Tag block failed: source %d, expected %s, %d sentences, latitude %f\n", i, pszTagSources[i], pnTagSentences[i], pdTagLatitudes[i]);
+			nFailed++;
+		}
+	}
+
+	// A tag block with a bad checksum is reported to the sink
+	const char *szBadTagSample = "\\s:GP0001,c:1577836802*28\\$GPGGA,123521,4807.042,N,01131.004,E,1,08,0.9,545.8,M,46.9,M,,*49\r\n";
+	TagRouter.ProcessNMEABuffer(szBadTagSample, strlen(szBadTagSample));
+	if (TagSink.m_nErrors != 1) {
+		printf("Tag block failed: %d errors for a bad checksum, expected 1\n", (int)TagSink.m_nErrors);
+		nFailed++;
+	}
+
+	// AIS test. A single fragment position report, a two fragment static report and a class B report.
+	const char *szAISSample =
+		"!AIVDM,1,1,,B,15M67FC000G?ufbE`FepT@3n00Sa,0*5C\r\n"
+		"!AIVDM,2,1,1,A,55?MbV02;H;s<HtKR20EHE:0@T4@Dn2222222216L961O5Gf0NSQEp6ClRp8,0*1C\r\n"
+		"!AIVDM,2,2,1,A,88888888880,2*25\r\n"
+		"!AIVDM,1,1,,B,B5NJ;PP005l4ot5Isbl03wsUkP06,0*75\r\n";
+	MyAISNMEAParser AISParser;
+	AISParser.SetAIS(true);
+	AISParser.ProcessNMEABuffer(szAISSample, strlen(szAISSample));
+	const uint8_t pu8AISTypes[3] = { 1, 5, 18 };
+	const uint32_t puAISMMSIs[3] = { 366053209, 351759000, 367430530 };
+	if (AISParser.m_Messages.size() != 3) {
+		printf("AIS failed: %d messages, expected 3\n", (int)AISParser.m_Messages.size());
+		nFailed++;
+	}
+	for (size_t i = 0; (i < AISParser.m_Messages.size()) && (i < 3); i++) {
+		const CNMEAParserData::AIS_MESSAGE_T &Message = AISParser.m_Messages[i];
+		double dLatitude = CNMEAParserData::CoordinateToDegrees(Message.Position.n64Latitude);
+		double dLongitude = CNMEAParserData::CoordinateToDegrees(Message.Position.n64Longitude);
+		bool bOK = (Message.u8Type == pu8AISTypes[i]) && (Message.uMMSI == puAISMMSIs[i]);
+		if (Message.u8Type == 1) {
+			bOK = bOK && Message.bPosition && (dLatitude > 37.802117) && (dLatitude < 37.802119) && (dLongitude > -122.341619) &&
+				(dLongitude < -122.341617) && (Message.Position.u16SOG == 0) && (Message.Position.u16COG == 2193) &&
+				(Message.Position.u8NavStatus == 3) && (Message.Position.u8Second == 59);
+		}
+		else if (Message.u8Type == 5) {
+			// Both fragments must be reassembled, 360 + 64 bits
+			bOK = bOK && !Message.bPosition && (Message.nBits == 424);
+		}
+		else if (Message.u8Type == 18) {
+			bOK = bOK && Message.bPosition && (dLatitude > 37.785034) && (dLatitude < 37.785036) && (dLongitude > -122.267321) &&
+				(dLongitude < -122.267319);
+		}
+		if (!bOK) {
+			printf("AIS failed: message %d, type %d, MMSI %u\n", (int)i, Message.u8Type, Message.uMMSI);
+			nFailed++;
+		}
+	}
+
+#if defined(__linux__)
+	// Multi-device ingest test. Two ptys stand in for serial receivers, the test writes into their
+	// master side and the ingest loop reads the slave side like a serial port.
+	CNMEAParserIngest Ingest;
+	CNMEAParser PtyParsers[2];
+	int pnMasters[2] = { -1, -1 };
+	for (int i = 0; i < 2; i++) {
+		int nSlave;
+		if (openpty(&pnMasters[i], &nSlave, NULL, NULL, NULL) == 0) {
+			struct termios Termios;
+			tcgetattr(nSlave, &Termios);
+			cfmakeraw(&Termios);
+			tcsetattr(nSlave, TCSANOW, &Termios);
+			PtyParsers[i].SetEpochAssembly(true);
+			Ingest.AddDescriptor(nSlave, &PtyParsers[i], true);
+		}
+	}
+	for (int i = 0; i < 2; i++) {
+		if (pnMasters[i] >= 0) {
+			ssize_t nWritten = write(pnMasters[i], szEpochSample, nEpochSampleLen);
+			UNUSED_PARAM(nWritten);
+		}
+	}
+	for (int n = 0; (n < 10) && (Ingest.Poll(100) > 0); n++) {
+	}
+	for (int i = 0; i < 2; i++) {
+		CNMEAParserData::EPOCH_DATA_T PtyEpoch;
+		if (PtyParsers[i].GetEpoch(PtyEpoch) == CNMEAParserData::ERROR_OK) {
+			printf("Ingest! pty %d: Last epoch: %02d:%02d:%05.2f\n", i, PtyEpoch.m_nHour, PtyEpoch.m_nMinute, PtyEpoch.m_dSecond);
+		}
+
+		// A pty that could not be opened is not an ingest failure
+		if ((pnMasters[i] >= 0) && ((PtyParsers[i].GetEpoch(PtyEpoch) != CNMEAParserData::ERROR_OK) || !IsLastSampleEpoch(PtyEpoch))) {
+			printf("Ingest failed: pty %d did not reach the last epoch\n", i);
+			nFailed++;
+		}
+		if (pnMasters[i] >= 0) {
+			close(pnMasters[i]);
+		}
+	}
+
+	// Network test over loopback. Two UDP senders split the sample into datagrams that cut sentences
+	// in half, a TCP sender writes it in one go. Each sender gets its own parser.
+	MyStreamSink NetworkSink;
+	CNMEAParserNetwork Network(&NetworkSink, 4);
+	int nNetworkSenders = 0;
+	if ((Network.OpenUDP(0, "127.0.0.1") == CNMEAParserData::ERROR_OK) && (Network.GetLocalPort() != 0)) {
+		nNetworkSenders += 2;
+		struct sockaddr_in Target;
+		memset(&Target, 0, sizeof(Target));
+		Target.sin_family = AF_INET;
+		Target.sin_port = htons(Network.GetLocalPort());
+		Target.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		for (int i = 0; i < 2; i++) {
+			int nUDP = socket(AF_INET, SOCK_DGRAM, 0);
+			for (size_t nOffset = 0; (nUDP >= 0) && (nOffset < nEpochSampleLen); nOffset += 50) {
+				size_t nChunk = (nEpochSampleLen - nOffset < 50) ? nEpochSampleLen - nOffset : 50;
+				sendto(nUDP, szEpochSample + nOffset, nChunk, 0, (struct sockaddr *)&Target, sizeof(Target));
+			}
+			if (nUDP >= 0) {
+				close(nUDP);
+			}
+		}
+	}
+	if ((Network.ListenTCP(0, "127.0.0.1") == CNMEAParserData::ERROR_OK) && (Network.GetLocalPort() != 0)) {
+		nNetworkSenders++;
+		struct sockaddr_in Target;
+		memset(&Target, 0, sizeof(Target));
+		Target.sin_family = AF_INET;
+		Target.sin_port = htons(Network.GetLocalPort());
+		Target.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		int nTCP = socket(AF_INET, SOCK_STREAM, 0);
+		if ((nTCP >= 0) && (connect(nTCP, (struct sockaddr *)&Target, sizeof(Target)) == 0)) {
+			ssize_t nWritten = write(nTCP, szEpochSample, nEpochSampleLen);
+			UNUSED_PARAM(nWritten);
+		}
+		if (nTCP >= 0) {
+			close(nTCP);
+		}
+	}
+	for (int n = 0; (n < 10) && (Network.Poll(100) > 0); n++) {
+	}
+	for (int i = 0; i < Network.GetSenderCount(); i++) {
+		printf("Network! Sender %d (%s): %d sentences, %d bytes\n", i, (i < 2) ? "UDP" : "TCP",
+			NetworkSink.m_pnSentences[i], (int)Network.GetBytesReceived(i));
+	}
+
+	// Every sender must deliver the whole sample. Sockets that could not be opened are not a failure.
+	if (Network.GetSenderCount() != nNetworkSenders) {
+		printf("Network failed: %d senders, expected %d\n", Network.GetSenderCount(), nNetworkSenders);
+		nFailed++;
+	}
+	for (int i = 0; i < Network.GetSenderCount(); i++) {
+		if ((NetworkSink.m_pnSentences[i] != 18) || (Network.GetBytesReceived(i) != nEpochSampleLen)) {
+			printf("Network failed: sender %d, %d sentences, %d bytes\n", i, NetworkSink.m_pnSentences[i], (int)Network.GetBytesReceived(i));
+			nFailed++;
+		}
+	}
+	printf("Network! %d datagrams in %d receive calls\n", (int)Network.GetDatagramCount(), (int)Network.GetReceiveCallCount());
+
+	// TCP reconnect test. With room for one sender, every new connection must take over the sender
+	// of the one closed before it.
+	MyStreamSink ReconnectSink;
+	CNMEAParserNetwork Reconnect(&ReconnectSink, 1);
+	if ((Reconnect.ListenTCP(0, "127.0.0.1") == CNMEAParserData::ERROR_OK) && (Reconnect.GetLocalPort() != 0)) {
+		struct sockaddr_in Target;
+		memset(&Target, 0, sizeof(Target));
+		Target.sin_family = AF_INET;
+		Target.sin_port = htons(Reconnect.GetLocalPort());
+		Target.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		for (int i = 0; i < 3; i++) {
+			int nTCP = socket(AF_INET, SOCK_STREAM, 0);
+			if ((nTCP >= 0) && (connect(nTCP, (struct sockaddr *)&Target, sizeof(Target)) == 0)) {
+				ssize_t nWritten = write(nTCP, szGGASample, strlen(szGGASample));
+				UNUSED_PARAM(nWritten);
+			}
+			if (nTCP >= 0) {
+				close(nTCP);
+			}
+			for (int n = 0; (n < 10) && (Reconnect.Poll(100) > 0); n++) {
+			}
+		}
+		if ((Reconnect.GetDroppedCount() != 0) || (ReconnectSink.m_pnSentences[0] != 3)) {
+			printf("Network reconnect failed: %d dropped, %d sentences\n", (int)Reconnect.GetDroppedCount(), ReconnectSink.m_pnSentences[0]);
+			nFailed++;
+		}
+	}
+#endif
+
+	// Sentence time stamps and the receive to decode latency histogram
+	CNMEAParserLatency Latency;
+	MyStaticNMEAParser TimedParser;
+	TimedParser.SetLatencyHistogram(&Latency);
+	TimedParser.ProcessNMEABuffer(szEpochSample, strlen(szEpochSample));
+	printf("Latency! %llu sentences timed, last one received at %llu ns\n", (unsigned long long)Latency.GetCount(), (unsigned long long)TimedParser.GetTimestamp());
+
+	// A histogram attached in the middle of a sentence must skip that sentence, it has no time stamp
+	const char *szLatencySample = "$GPGGA,145416.00,3350.10959,N,11751.22870,W,1,09,0.85,70.3,M,-32.7,M,,*5B\r\n";
+	CNMEAParserLatency MidLatency;
+	CNMEAParser MidParser;
+	MidParser.ProcessNMEABuffer(szLatencySample, 20);
+	MidParser.SetLatencyHistogram(&MidLatency);
+	MidParser.ProcessNMEABuffer(szLatencySample + 20, strlen(szLatencySample) - 20);
+	MidParser.ProcessNMEABuffer(szLatencySample, strlen(szLatencySample));
+	if ((MidLatency.GetCount() != 1) || (MidLatency.GetMax() > 1000000000ULL)) {
+		printf("Latency mid sentence failed: %llu samples, max %llu ns\n", (unsigned long long)MidLatency.GetCount(), (unsigned long long)MidLatency.GetMax());
+		nFailed++;
+	}
+
+	// Numeric field parsers
+	nFailed += TestNumberParsers();
+
+	// Parser event trace
+	nFailed += TestTrace();
+
+	printf("Built in test: %d failures\n", nFailed);
+	return nFailed;
 }
 
 int main(int argc, char *argv[], char *envp[]) {
@@ -176,10 +930,25 @@ int main(int argc, char *argv[], char *envp[]) {
 	// that is a NMEA file and try to open it.
 	//
 	if (argc < 2) {
-		printf("Usage: NMEAParserTest [NMEA file]\n");
+		printf("Usage: NMEAParserTest [-j threads] [NMEA file]\n");
 		printf("If [NMEA file] is omitted, then the built in test function will be called\n");
+		printf("With -j, the file is memory mapped and parsed in parallel chunks (0 threads for one per core)\n");
 		printf("Running built-in-test...\n");
-		Test();
+		return (Test() == 0) ? 0 : 1;
+	}
+
+	//
+	// Parallel log ingest. The output is the same as below, merged back in file order.
+	//
+	if ((strcmp(argv[1], "-j") == 0) && (argc >= 4)) {
+		CNMEAParserLog Log;
+		if (Log.Open(argv[3]) != CNMEAParserData::ERROR_OK) {
+			printf("Could not open file: %s\n", argv[3]);
+			return -1;
+		}
+
+		MyLogSink LogSink((int)(Log.GetSize() / CNMEAParserLog::c_nDefaultChunkSize) + 1);
+		Log.Process(&LogSink, atoi(argv[2]));
 		return 0;
 	}
 